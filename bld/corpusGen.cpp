@@ -0,0 +1,253 @@
+#include "../src/globalDefs.h"
+#include "../src/constantDefs.h"
+
+// generates synthetic ANI programs of parameterized size and shape, for benchmarking the compiler
+
+// generation parameters
+unsigned int numFiles = 1; // number of source files to split the program into
+unsigned int numDecls = 100; // number of constant/latch/stream declarations per file
+unsigned int numObjects = 10; // number of object definitions per file
+unsigned int numFilters = 10; // number of filter definitions per file
+unsigned int numPipes = 10; // number of stream-heavy pipe blocks per file
+unsigned int nestDepth = 2; // depth of nested object definitions and blocks
+unsigned int importFanOut = 2; // number of imports per object and pipe block
+unsigned int expSize = 4; // number of binary operators per expression (at least 1, since bare leaves don't always type-check in context)
+uint32_t seed = 1; // exactly 32 bits, so that the sequence doesn't depend on the width of long
+
+// portable pseudo-random number generator, so that the same parameters give the same corpus everywhere
+unsigned int nextRandom(unsigned int n) {
+	seed = (uint32_t)((seed * 1103515245U + 12345U) & 0xFFFFFFFFU);
+	return (n > 0) ? (unsigned int)((seed / 65536) % 32768) % n : 0;
+}
+
+// names of things declared so far, which later declarations can refer to
+vector<string> constNames;
+vector<string> streamNames;
+vector<string> objectNames;
+vector<string> filterNames;
+
+string makeName(const char *prefix, unsigned int fileIndex, unsigned int i) {
+	char buf[MAX_STRING_LENGTH];
+	sprintf(buf, "%s%u_%u", prefix, fileIndex, i);
+	return string(buf);
+}
+
+// returns a fully parenthesized expression with the given number of binary operators, over literals, constants, and the given extra leaves
+string genExp(unsigned int size, const vector<string> &leaves) {
+	if (size == 0) { // base case; generate a leaf
+		unsigned int choice = nextRandom(3);
+		if (choice == 0 && !leaves.empty()) {
+			return leaves[nextRandom(leaves.size())];
+		} else if (choice == 1 && !constNames.empty()) {
+			return constNames[nextRandom(constNames.size())];
+		} else {
+			char buf[MAX_INT_STRING_LENGTH];
+			sprintf(buf, "%u", nextRandom(1000));
+			return string(buf);
+		}
+	}
+	// recursive case; split the operators between the two sides
+	static const char *ops[] = {" + ", " - ", " * "};
+	unsigned int leftSize = nextRandom(size);
+	return "(" + genExp(leftSize, leaves) + ops[nextRandom(3)] + genExp(size - 1 - leftSize, leaves) + ")";
+}
+
+void genIndent(FILE *out, unsigned int indent) {
+	for (unsigned int i=0; i<indent; i++) {
+		fprintf(out, "\t");
+	}
+}
+
+// prints imports of up to importFanOut distinct nested objects of the objects declared so far
+// (the nested objects are the only ones whose names aren't already visible everywhere)
+void genImports(FILE *out, unsigned int indent, const string &self) {
+	vector<string> imported;
+	for (unsigned int i=0; i<importFanOut && i<objectNames.size() && nestDepth > 0; i++) {
+		const string &target = objectNames[nextRandom(objectNames.size())];
+		if (target == self) {
+			continue;
+		}
+		// build the path down to a random nesting depth
+		string path(target);
+		string name(target);
+		unsigned int depth = 1 + nextRandom(nestDepth);
+		for (unsigned int j=0; j<depth; j++) {
+			name += "n";
+			path += "." + name;
+		}
+		bool duplicate = false;
+		for (unsigned int j=0; j<imported.size(); j++) {
+			if (imported[j] == name) {
+				duplicate = true;
+			}
+		}
+		if (!duplicate) {
+			genIndent(out, indent);
+			fprintf(out, "@%s;\n", path.c_str());
+			imported.push_back(name);
+		}
+	}
+}
+
+void genObject(FILE *out, unsigned int indent, const string &name, unsigned int depth) {
+	vector<string> params(1, "x");
+	genIndent(out, indent);
+	fprintf(out, "%s = []{\n", name.c_str());
+	genIndent(out, indent+1);
+	fprintf(out, "=;\n");
+	genIndent(out, indent+1);
+	fprintf(out, "=[int\\ x] {\\x ->m;}\n");
+	genIndent(out, indent+1);
+	fprintf(out, "m = [int\\];\n");
+	genIndent(out, indent+1);
+	fprintf(out, "k = [int](%s);\n", genExp(expSize, vector<string>()).c_str());
+	genIndent(out, indent+1);
+	fprintf(out, "g = [int x --> int\\] { %s -->; };\n", genExp(expSize, params).c_str());
+	if (depth > 0) {
+		genObject(out, indent+1, name + "n", depth-1);
+	}
+	genImports(out, indent+1, name);
+	genIndent(out, indent);
+	fprintf(out, "};\n");
+}
+
+void genBlock(FILE *out, unsigned int indent, unsigned int depth) {
+	genIndent(out, indent);
+	fprintf(out, "{\n");
+	if (depth == 0) { // innermost block; generate the stream-heavy pipes
+		vector<string> params(1, "x");
+		if (!streamNames.empty()) {
+			const string &stream = streamNames[nextRandom(streamNames.size())];
+			genIndent(out, indent+1);
+			fprintf(out, "%s ->%s;\n", genExp(expSize, vector<string>()).c_str(), stream.c_str());
+			genIndent(out, indent+1);
+			fprintf(out, "\\%s ->std.out;\n", stream.c_str());
+			genIndent(out, indent+1);
+			fprintf(out, "%u std.gen <| [int x] { %s ->%s; };\n", nextRandom(100), genExp(expSize, params).c_str(), stream.c_str());
+		}
+		if (!filterNames.empty()) {
+			genIndent(out, indent+1);
+			fprintf(out, "%s, %s %s ->std.out;\n", genExp(expSize/2, vector<string>()).c_str(), genExp(expSize/2, vector<string>()).c_str(),
+				filterNames[nextRandom(filterNames.size())].c_str());
+		}
+		if (!objectNames.empty()) {
+			genIndent(out, indent+1);
+			fprintf(out, "%s %s.g ->std.out;\n", genExp(expSize, vector<string>()).c_str(), objectNames[nextRandom(objectNames.size())].c_str());
+		}
+		genIndent(out, indent+1);
+		fprintf(out, "%s ->std.out;\n", genExp(expSize, vector<string>()).c_str());
+	} else { // else if this is an outer block, import some objects and recurse
+		genImports(out, indent+1, "");
+		genBlock(out, indent+1, depth-1);
+	}
+	genIndent(out, indent);
+	fprintf(out, "};\n");
+}
+
+void genFile(FILE *out, unsigned int fileIndex) {
+	fprintf(out, "// generated by corpusGen (file %u of %u)\n\n", fileIndex+1, numFiles);
+	if (fileIndex == 0) {
+		fprintf(out, "@std;\n\n");
+	}
+	// constant, latch, and stream declarations
+	for (unsigned int i=0; i<numDecls; i++) {
+		string name = makeName("d", fileIndex, i);
+		switch (i % 3) {
+			case 0: // constant
+				fprintf(out, "%s = %s;\n", name.c_str(), genExp(expSize, vector<string>()).c_str());
+				constNames.push_back(name);
+				break;
+			case 1: // latch
+				fprintf(out, "%s = [int](%s);\n", name.c_str(), genExp(expSize, vector<string>()).c_str());
+				break;
+			case 2: // stream
+				fprintf(out, "%s = [int\\\\];\n", name.c_str());
+				streamNames.push_back(name);
+				break;
+		}
+	}
+	fprintf(out, "\n");
+	// filter definitions
+	vector<string> params;
+	params.push_back("x");
+	params.push_back("y");
+	for (unsigned int i=0; i<numFilters; i++) {
+		string name = makeName("f", fileIndex, i);
+		fprintf(out, "%s = [int x, int y --> int\\] { %s -->; };\n", name.c_str(), genExp(expSize, params).c_str());
+		filterNames.push_back(name);
+	}
+	fprintf(out, "\n");
+	// object definitions
+	for (unsigned int i=0; i<numObjects; i++) {
+		string name = makeName("o", fileIndex, i);
+		genObject(out, 0, name, nestDepth);
+		objectNames.push_back(name);
+	}
+	fprintf(out, "\n");
+	// pipe blocks
+	for (unsigned int i=0; i<numPipes; i++) {
+		genBlock(out, 0, nestDepth);
+	}
+}
+
+void printUsage() {
+	fprintf(stderr, "usage: corpusGen [-o outputPrefix] [-m files] [-n decls] [-b objects] [-f filters] [-p pipes] [-d depth] [-i fanOut] [-e expSize] [-r seed]\n");
+}
+
+int main(int argc, char **argv) {
+	const char *outPrefix = NULL;
+	for (int i=1; i<argc; i++) {
+		if (argv[i][0] != '-' || argv[i][1] == '\0' || argv[i][2] != '\0' || i+1 >= argc) {
+			printUsage();
+			return 1;
+		}
+		char option = argv[i][1];
+		const char *arg = argv[++i];
+		if (option == 'o') {
+			outPrefix = arg;
+			continue;
+		}
+		unsigned long n;
+		if (sscanf(arg, "%lu", &n) < 1) {
+			printUsage();
+			return 1;
+		}
+		switch (option) {
+			case 'm': numFiles = n; break;
+			case 'n': numDecls = n; break;
+			case 'b': numObjects = n; break;
+			case 'f': numFilters = n; break;
+			case 'p': numPipes = n; break;
+			case 'd': nestDepth = n; break;
+			case 'i': importFanOut = n; break;
+			case 'e': expSize = n; break;
+			case 'r': seed = (uint32_t)(n & 0xFFFFFFFFUL); break;
+			default:
+				printUsage();
+				return 1;
+		}
+	}
+	if (numFiles == 0 || expSize == 0 || (numFiles > 1 && outPrefix == NULL)) { // multi-file corpora need somewhere to go
+		printUsage();
+		return 1;
+	}
+	// generate the files
+	for (unsigned int fileIndex=0; fileIndex<numFiles; fileIndex++) {
+		FILE *out = stdout;
+		if (outPrefix != NULL) {
+			char fileName[MAX_STRING_LENGTH];
+			sprintf(fileName, "%s%u.ani", outPrefix, fileIndex);
+			out = fopen(fileName, "w");
+			if (out == NULL) { // if file open failed, return an error
+				fprintf(stderr, "corpusGen: cannot open output file '%s'\n", fileName);
+				return 1;
+			}
+		}
+		genFile(out, fileIndex);
+		if (out != stdout) {
+			fclose(out);
+		}
+	}
+	// finally, return normally
+	return 0;
+}
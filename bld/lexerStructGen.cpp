@@ -3,8 +3,13 @@
 
 #include "../src/lexerNodeStruct.h"
 
+#define NUM_RAW_STATES 256
+#define RAW_DEAD_STATE 255 // the raw state that -1 (i.e. no further transitions) maps to
+
 map<string,int> tokenMap;
 
+LexerNode lexerNode[NUM_RAW_STATES][256]; // the raw transition table, as specified in the lexer table
+
 int mapToken(string s) {
 	map<string,int>::iterator queryBuf = tokenMap.find(s);
 	if (queryBuf != tokenMap.end()) { // query hit
@@ -16,6 +21,90 @@ int mapToken(string s) {
 	}
 }
 
+// minimizes the raw DFA and splits the byte alphabet into equivalence classes
+// the resulting state numbering is returned in stateMap (with the start state at 0), and the byte classes in charClass
+void minimizeDfa(vector<int> &stateMap, unsigned int &numStates, unsigned char charClass[256], unsigned int &numClasses) {
+	// find the states that are reachable from the start state
+	vector<bool> reachable(NUM_RAW_STATES, false);
+	vector<int> worklist;
+	reachable[0] = true;
+	worklist.push_back(0);
+	while (!worklist.empty()) {
+		int state = worklist.back();
+		worklist.pop_back();
+		for (unsigned int c=0; c < 256; c++) {
+			if (lexerNode[state][c].tokenType != -1) {
+				int toState = (lexerNode[state][c].toState == -1) ? RAW_DEAD_STATE : lexerNode[state][c].toState;
+				if (!reachable[toState]) {
+					reachable[toState] = true;
+					worklist.push_back(toState);
+				}
+			}
+		}
+	}
+	reachable[RAW_DEAD_STATE] = true; // the dead state is always needed, since invalid transitions fall into it
+	// partition the reachable states into blocks of equivalent states (Moore's algorithm)
+	// the start state always gets its own block, since the lexer treats it specially
+	vector<int> block(NUM_RAW_STATES, -1);
+	unsigned int numBlocks = 0;
+	for(;;) {
+		map<vector<int>, int> signatureMap;
+		vector<int> newBlock(NUM_RAW_STATES, -1);
+		for (int state = 0; state < NUM_RAW_STATES; state++) {
+			if (!reachable[state]) {
+				continue;
+			}
+			// build this state's signature: its current block (or a marker for the start state) followed by its transitions
+			vector<int> signature;
+			signature.push_back((state == 0) ? -2 : block[state]);
+			for (unsigned int c=0; c < 256; c++) {
+				const LexerNode &node = lexerNode[state][c];
+				signature.push_back(node.tokenType);
+				if (node.tokenType != -1) {
+					signature.push_back(block[(node.toState == -1) ? RAW_DEAD_STATE : node.toState]);
+				}
+			}
+			map<vector<int>, int>::iterator signatureFind = signatureMap.find(signature);
+			if (signatureFind != signatureMap.end()) { // if we've seen this signature before, join its block
+				newBlock[state] = signatureFind->second;
+			} else { // else if this is a new signature, start a new block for it
+				int blockIndex = signatureMap.size();
+				signatureMap.insert( make_pair(signature, blockIndex) );
+				newBlock[state] = blockIndex;
+			}
+		}
+		block = newBlock;
+		if (signatureMap.size() == numBlocks) { // if the partition has stabilized, we're done
+			break;
+		}
+		numBlocks = signatureMap.size();
+	}
+	// the start state was processed first, so it's in block 0
+	stateMap = block;
+	numStates = numBlocks;
+	// now, group bytes whose columns are identical across all of the minimized states
+	map<vector<int>, int> columnMap;
+	for (unsigned int c=0; c < 256; c++) {
+		vector<int> column;
+		for (int state = 0; state < NUM_RAW_STATES; state++) {
+			if (reachable[state]) {
+				const LexerNode &node = lexerNode[state][c];
+				column.push_back(node.tokenType);
+				column.push_back((node.tokenType != -1) ? block[(node.toState == -1) ? RAW_DEAD_STATE : node.toState] : -1);
+			}
+		}
+		map<vector<int>, int>::iterator columnFind = columnMap.find(column);
+		if (columnFind != columnMap.end()) { // if we've seen this column before, join its class
+			charClass[c] = columnFind->second;
+		} else { // else if this is a new column, start a new class for it
+			int classIndex = columnMap.size();
+			columnMap.insert( make_pair(column, classIndex) );
+			charClass[c] = classIndex;
+		}
+	}
+	numClasses = columnMap.size();
+}
+
 // parses the lexer table into an includable .h file with the appropriate struct representation
 int main() {
 	// input file
@@ -44,9 +133,8 @@ int main() {
 	// print the necessary prologue into the .cpp
 	fprintf(out2, "#include \"lexerStruct.h\"\n\n");
 
-	// create the lexer node array
-	LexerNode lexerNode[256][256];
-	for (int i = 0; i<256; i++) {
+	// initialize the lexer node array
+	for (int i = 0; i<NUM_RAW_STATES; i++) {
 		for (int j = 0; j<256; j++) {
 			lexerNode[i][j] = (LexerNode){ -1, 0 }; // -1 tokenType indicates an invalid node
 		}
@@ -71,7 +159,10 @@ int main() {
 			continue;
 		} else if (retVal2 == 4) { // else if it was a valid data line, process it normally
 			int tokenType = mapToken(tokenTypeString); // get the token mapping
-			lexerNode[fromState][c] = (LexerNode){ tokenType, toState };
+			if (fromState < 0 || fromState >= NUM_RAW_STATES || toState < -1 || toState >= NUM_RAW_STATES || tokenType > SHRT_MAX) { // if the node doesn't fit in the table, return an error
+				return -1;
+			}
+			lexerNode[fromState][c] = (LexerNode){ (short)tokenType, (short)toState };
 		}
 	}
 
@@ -128,14 +219,44 @@ int main() {
 	fprintf(out, "unsigned int string2TokenType(string s);\n\n");
 	fprintf(out, "#endif\n");
 
-	// print out the lexer node struct array
-	fprintf(lnr, "const LexerNode lexerNode[256][256] = {\n");
-	for (unsigned int i=0; i < 256; i++) {
-		fprintf(lnr, "\t{\n");
-		for (unsigned int j=0; j < 256; j++) {
-			fprintf(lnr, "\t\t{ %d, %d },\n", lexerNode[i][j].tokenType, lexerNode[i][j].toState);
+	// minimize the lexer DFA
+	vector<int> stateMap;
+	unsigned int numStates;
+	unsigned char charClass[256];
+	unsigned int numClasses;
+	minimizeDfa(stateMap, numStates, charClass, numClasses);
+	// build the minimized transition table, taking one representative raw state per minimized state
+	vector<int> representative(numStates, -1);
+	for (int state = 0; state < NUM_RAW_STATES; state++) {
+		if (stateMap[state] != -1 && representative[stateMap[state]] == -1) {
+			representative[stateMap[state]] = state;
+		}
+	}
+	vector<unsigned char> classRepresentative(numClasses);
+	for (int c = 255; c >= 0; c--) {
+		classRepresentative[charClass[c]] = c;
+	}
+
+	// print out the header notice to the raw table file
+	fprintf(lnr, "/* NOTE: This file was automatically generated by src/lexerStructGen.cpp -- do not modify it */\n\n");
+	fprintf(lnr, "#define NUM_LEXER_STATES %u\n", numStates);
+	fprintf(lnr, "#define NUM_LEXER_CLASSES %u\n\n", numClasses);
+	// print out the byte equivalence class array
+	fprintf(lnr, "static const unsigned char lexerCharClass[256] = {");
+	for (unsigned int c=0; c < 256; c++) {
+		fprintf(lnr, "%s%u,", (c % 16 == 0) ? "\n\t" : " ", charClass[c]);
+	}
+	fprintf(lnr, "\n};\n\n");
+	// print out the minimized lexer node struct array
+	fprintf(lnr, "static const LexerNode lexerNode[NUM_LEXER_STATES][NUM_LEXER_CLASSES] = {\n");
+	for (unsigned int i=0; i < numStates; i++) {
+		fprintf(lnr, "\t{");
+		for (unsigned int j=0; j < numClasses; j++) {
+			const LexerNode &node = lexerNode[representative[i]][classRepresentative[j]];
+			int toState = (node.tokenType != -1) ? stateMap[(node.toState == -1) ? RAW_DEAD_STATE : node.toState] : 0;
+			fprintf(lnr, " { %d, %d },", node.tokenType, toState);
 		}
-		fprintf(lnr, "\t},\n");
+		fprintf(lnr, " },\n");
 	}
 	fprintf(lnr, "};\n");
 
@@ -4,8 +4,22 @@
 #include "../tmp/lexerStruct.h"
 #include "../src/parserNodeStruct.h"
 
+#include <algorithm>
+
+using std::sort;
+
 #define NUM_RULES 512
 
+// a single state's row of the parse table, for the purposes of compression
+struct ParserRow {
+	unsigned int state;
+	vector<unsigned int> labels; // the labels whose entries must be stored explicitly
+};
+
+bool rowCmp(const ParserRow &a, const ParserRow &b) {
+	return (a.labels.size() != b.labels.size()) ? (a.labels.size() > b.labels.size()) : (a.state < b.state);
+}
+
 // parses the generated parse table into an includable .h file with the appropriate struct representation
 int main() {
 	// input file
@@ -147,9 +161,9 @@ int main() {
 	fprintf(rlts, "/* NOTE: This file was automatically generated by src/parserStructGen.cpp -- do not modify it */\n\n");
 	fprintf(rrl, "/* NOTE: This file was automatically generated by src/parserStructGen.cpp -- do not modify it */\n\n");
 	// print out the ruleLhsTokenType, ruleLshTokenString, and ruleRhsLength array initializers
-	fprintf(rltt, "const int ruleLhsTokenType[NUM_RULES] = {\n");
-	fprintf(rlts, "const char *ruleLhsTokenString[NUM_RULES] = {\n");
-	fprintf(rrl, "const unsigned int ruleRhsLength[NUM_RULES] = {\n");
+	fprintf(rltt, "static const unsigned short ruleLhsTokenType[NUM_RULES] = {\n");
+	fprintf(rlts, "static const char *const ruleLhsTokenString[NUM_RULES] = {\n");
+	fprintf(rrl, "static const unsigned char ruleRhsLength[NUM_RULES] = {\n");
 	// get rule lengths
 	for (unsigned int i=0; true; i++) { // per-rule line loop
 		// read in a line
@@ -239,6 +253,7 @@ int main() {
 			parserNode[i][j].n = ACTION_ERROR;
 		}
 	}
+	unsigned int numStates = 0;
 	for(;;) {
 		char *retVal = fgets(lineBuf, MAX_STRING_LENGTH, in);
 		if (retVal == NULL || lineBuf[0] == 'N') { // if we've reached the end of the table, break out of the loop
@@ -256,6 +271,12 @@ int main() {
 		}
 		// parse out the state number from the string
 		fromState = atoi(junk);
+		if (fromState < 0 || fromState >= NUM_RULES) { // if the state is out of range, return an error
+			return -1;
+		}
+		if ((unsigned int)fromState >= numStates) {
+			numStates = fromState + 1;
+		}
 		// now, read all of the transitions for this state
 		for(unsigned int i=0; i<tokenOrder.size(); i++) {
 			sscanf(lbCur, "%s", junk); // read a transition
@@ -278,26 +299,102 @@ int main() {
 		}
 	}
 
-	// print out the parserNode array initializer
-	fprintf(pnr, "const ParserNode parserNode[NUM_RULES][NUM_LABELS] = {\n");
-	// per-rule loop
-	for (unsigned int i=0; i < NUM_RULES; i++) {
-		fprintf(pnr, "\t{\n");
-		// per-label loop
-		for (unsigned int j=0; j < (NUM_TOKENS + nonTermCount); j++) {
-			string actionString = (
-				parserNode[i][j].action == ACTION_SHIFT ? "ACTION_SHIFT" :
-				parserNode[i][j].action == ACTION_REDUCE ? "ACTION_REDUCE" :
-				parserNode[i][j].action == ACTION_ACCEPT ? "ACTION_ACCEPT" :
-				parserNode[i][j].action == ACTION_GOTO ? "ACTION_GOTO" :
-				parserNode[i][j].action == ACTION_ERROR ? "ACTION_ERROR" :
-				""
-			);
-			fprintf(pnr, "\t\t{ %s, %u }, /* [%u][%u] */\n", actionString.c_str(), parserNode[i][j].n, i, j);
+	// compress the table
+	unsigned int numLabels = NUM_TOKENS + nonTermCount;
+	// first, pick each state's default action: its most common reduction, or an error if it has none
+	// error entries in states with a default reduction take the default, so errors are just detected a few reductions later
+	vector<ParserNode> defaultNode(numStates);
+	vector<ParserRow> rows(numStates);
+	for (unsigned int i=0; i < numStates; i++) {
+		map<unsigned int, unsigned int> reduceCounts;
+		for (unsigned int j=0; j < NUM_TOKENS; j++) {
+			if (parserNode[i][j].action == ACTION_REDUCE) {
+				reduceCounts[parserNode[i][j].n]++;
+			}
+		}
+		defaultNode[i] = (ParserNode){ ACTION_ERROR, 0 };
+		unsigned int bestCount = 0;
+		for (map<unsigned int, unsigned int>::iterator iter = reduceCounts.begin(); iter != reduceCounts.end(); iter++) {
+			if (iter->second > bestCount) {
+				defaultNode[i] = (ParserNode){ ACTION_REDUCE, iter->first };
+				bestCount = iter->second;
+			}
+		}
+		// log the entries that need to be stored explicitly
+		rows[i].state = i;
+		for (unsigned int j=0; j < numLabels; j++) {
+			const ParserNode &node = parserNode[i][j];
+			if (node.action != ACTION_ERROR && !(node.action == defaultNode[i].action && node.n == defaultNode[i].n)) {
+				if (node.n > MAX_PARSER_NODE_N) { // if the entry doesn't fit into the packed representation, return an error
+					return -1;
+				}
+				rows[i].labels.push_back(j);
+			}
 		}
-		fprintf(pnr, "\t},\n");
 	}
-	fprintf(pnr, "};\n");
+	// then, overlay the rows into a single comb vector (densest rows first, each at the lowest displacement that fits)
+	sort(rows.begin(), rows.end(), rowCmp);
+	vector<unsigned int> base(numStates, 0);
+	vector<unsigned int> check;
+	vector<PackedParserNode> entry;
+	for (unsigned int r=0; r < rows.size(); r++) {
+		const ParserRow &row = rows[r];
+		unsigned int displacement = 0;
+		for(;; displacement++) {
+			bool fits = true;
+			for (unsigned int k=0; k < row.labels.size(); k++) {
+				unsigned int slot = displacement + row.labels[k];
+				if (slot < check.size() && check[slot] != PARSER_NO_STATE) {
+					fits = false;
+					break;
+				}
+			}
+			if (fits) {
+				break;
+			}
+		}
+		base[row.state] = displacement;
+		// pad the vectors so that every lookup from this row stays in bounds
+		if (check.size() < displacement + numLabels) {
+			check.resize(displacement + numLabels, PARSER_NO_STATE);
+			entry.resize(displacement + numLabels, PACK_PARSER_NODE(ACTION_ERROR, 0));
+		}
+		for (unsigned int k=0; k < row.labels.size(); k++) {
+			const ParserNode &node = parserNode[row.state][row.labels[k]];
+			check[displacement + row.labels[k]] = row.state;
+			entry[displacement + row.labels[k]] = PACK_PARSER_NODE(node.action, node.n);
+		}
+	}
+	if (check.size() > 0xFFFF) { // if the displacements don't fit into 16 bits, return an error
+		return -1;
+	}
+
+	// print out the header notice to the raw table file
+	fprintf(pnr, "/* NOTE: This file was automatically generated by src/parserStructGen.cpp -- do not modify it */\n\n");
+	fprintf(pnr, "#define NUM_PARSER_STATES %u\n", numStates);
+	fprintf(pnr, "#define PARSER_TABLE_SIZE %u\n\n", (unsigned int)check.size());
+	// print out the per-state default actions and displacements
+	fprintf(pnr, "static const PackedParserNode parserDefault[NUM_PARSER_STATES] = {");
+	for (unsigned int i=0; i < numStates; i++) {
+		fprintf(pnr, "%s%u,", (i % 16 == 0) ? "\n\t" : " ", PACK_PARSER_NODE(defaultNode[i].action, defaultNode[i].n));
+	}
+	fprintf(pnr, "\n};\n\n");
+	fprintf(pnr, "static const unsigned short parserBase[NUM_PARSER_STATES] = {");
+	for (unsigned int i=0; i < numStates; i++) {
+		fprintf(pnr, "%s%u,", (i % 16 == 0) ? "\n\t" : " ", base[i]);
+	}
+	fprintf(pnr, "\n};\n\n");
+	// print out the comb vector and its check vector
+	fprintf(pnr, "static const unsigned short parserCheck[PARSER_TABLE_SIZE] = {");
+	for (unsigned int i=0; i < check.size(); i++) {
+		fprintf(pnr, "%s%u,", (i % 16 == 0) ? "\n\t" : " ", check[i]);
+	}
+	fprintf(pnr, "\n};\n\n");
+	fprintf(pnr, "static const PackedParserNode parserEntry[PARSER_TABLE_SIZE] = {");
+	for (unsigned int i=0; i < entry.size(); i++) {
+		fprintf(pnr, "%s%u,", (i % 16 == 0) ? "\n\t" : " ", entry[i]);
+	}
+	fprintf(pnr, "\n};\n");
 
 	// finally, return normally
 	return 0;
@@ -0,0 +1,104 @@
+#!/bin/sh
+
+### Benchmark script -- compiles scaling series of generated ANI corpora and records the compiler's throughput and per-phase times
+
+TARGET=$1
+GENERATOR=$2
+BENCH_DIR=tmp/bench
+RESULTS_TABLE=tmp/bench.txt
+RESULTS_JSON=tmp/bench.json
+BENCH_TIMEOUT=300 # seconds allowed per compilation, so that pathological scaling doesn't hang the run
+
+# use timeout(1) to enforce the time limit, if it's available
+TIMEOUT=""
+if command -v timeout > /dev/null 2>&1
+then
+	TIMEOUT="timeout $BENCH_TIMEOUT"
+fi
+
+# the corpora are generated afresh for every run (like the results, they're build output under tmp/)
+rm -rf $BENCH_DIR
+mkdir -p $BENCH_DIR
+rm -f $RESULTS_TABLE $RESULTS_JSON
+
+# runs a single benchmark; usage: runBench series scale generatorArgs...
+runBench() {
+	series=$1
+	scale=$2
+	shift 2
+	rm -f $BENCH_DIR/$series-*.ani
+	./$GENERATOR -o $BENCH_DIR/$series- "$@" || exit 1
+	files=`ls $BENCH_DIR/$series-*.ani | sort -t- -k2 -n`
+	stats=`$TIMEOUT ./$TARGET $files -J 2>&1 >/dev/null | grep '^{'`
+	if test -z "$stats"
+	then
+		echo "$series $scale: compilation failed or timed out after $BENCH_TIMEOUT seconds" | tee -a $RESULTS_TABLE
+		return
+	fi
+	echo "{\"series\": \"$series\", \"scale\": $scale, \"stats\": $stats}" >> $RESULTS_JSON
+	echo "$stats" | awk -v series=$series -v scale=$scale '
+		# returns the value of the first occurrence of the given field in obj
+		function field(obj, name) {
+			if (!match(obj, "\"" name "\": [^,}]*")) {
+				return "";
+			}
+			return substr(obj, RSTART + length(name) + 4, RLENGTH - length(name) - 4);
+		}
+		{
+			total = $0; sub(".*\"total\": ", "", total);
+			lines = field($0, "sourceLines");
+			tokens = field(total, "tokens");
+			wall = field(total, "wallMs");
+			printf("%-10s %6s %9s %9s %10.3f %12.0f %12.0f", series, scale, lines, tokens, wall, (wall > 0) ? tokens / wall * 1000 : 0, (wall > 0) ? lines / wall * 1000 : 0);
+			n = split("lexParse parse buildSt subImportDecls semSt semPipes genCodeRoot gen", phases, " ");
+			for (i = 1; i <= n; i++) {
+				if (match($0, "\"name\": \"" phases[i] "\", ")) {
+					printf(" %9.3f", field(substr($0, RSTART), "wallMs"));
+				} else {
+					printf(" %9s", "-");
+				}
+			}
+			printf("\n");
+		}' | tee -a $RESULTS_TABLE
+}
+
+echo
+echo ...Running compiler benchmarks...
+echo --------------------------------
+printf "%-10s %6s %9s %9s %10s %12s %12s %9s %9s %9s %9s %9s %9s %9s %9s\n" \
+	series scale lines tokens "wall(ms)" tokens/sec lines/sec lexParse parse buildSt subImport semSt semPipes genCode gen | tee -a $RESULTS_TABLE
+
+# declaration count (overall program size)
+for scale in 1 2 4 8 16
+do
+	runBench decls $scale -n `expr 250 \* $scale` -b `expr 5 \* $scale` -f `expr 5 \* $scale` -p `expr 5 \* $scale`
+done
+# import fan-out (stresses subImportDecls and bindId; grows very quickly, so the series is kept short)
+for scale in 1 2 3 4 5 6
+do
+	runBench imports $scale -n 100 -b 20 -f 5 -p 20 -i $scale
+done
+# nesting depth (stresses bindId on deep scopes; also grows very quickly)
+for scale in 1 2 3 4 5 6
+do
+	runBench depth $scale -n 100 -b 10 -f 5 -p 10 -d $scale
+done
+# expression size (stresses the parser's expression rules and the lowering of expressions)
+for scale in 1 2 4 8 16
+do
+	runBench exps $scale -n 100 -b 5 -f 20 -p 20 -e `expr 4 \* $scale`
+done
+# stream-heavy pipes
+for scale in 1 2 4 8 16
+do
+	runBench pipes $scale -n 100 -b 10 -f 10 -p `expr 25 \* $scale`
+done
+# file count (stresses per-file lexing and parsing, and cross-file imports)
+for scale in 1 2 4 8 16
+do
+	runBench files $scale -m $scale -n 250 -b 5 -f 5 -p 5
+done
+
+echo --------------------------------
+echo Benchmark results written to $RESULTS_TABLE and $RESULTS_JSON.
+exit 0
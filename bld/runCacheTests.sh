@@ -0,0 +1,71 @@
+#!/bin/sh
+
+### Compilation cache test script
+# compiles each test program cold and then warm out of the same -C cache, and checks that the diagnostics, exit codes, and intermediate code counts all match,
+# that every file got an interface summary, and that a summary is passed over once a file that it depends on changes
+
+TARGET=$1
+TEST_DIR=$2
+OUT_DIR=tmp/cacheTests
+
+echo
+echo ...Running compilation cache test cases...
+echo -------------------------------------------
+rm -rf $OUT_DIR
+mkdir -p $OUT_DIR
+FAILED=0
+for TEST in summary:"summary.ani" mixed:"summary.ani ../parallel/main.ani ../parallel/shapes.ani"
+do
+	NAME=${TEST%%:*}
+	FILES=""
+	NUM_FILES=0
+	for FILE in ${TEST#*:}
+	do
+		FILES="$FILES $TEST_DIR/$FILE"
+		NUM_FILES=`expr $NUM_FILES + 1`
+	done
+	for JOBS in 1 4
+	do
+		for PASS in cold warm
+		do
+			./$TARGET $FILES -j $JOBS -C $OUT_DIR/$NAME.j$JOBS -J > $OUT_DIR/$NAME.j$JOBS.$PASS.txt 2> $OUT_DIR/$NAME.j$JOBS.$PASS.json
+			echo "exit code $?" >> $OUT_DIR/$NAME.j$JOBS.$PASS.txt
+			sed -n 's/.*"total": {.*\("irTreeNodes": [0-9]*\).*/\1/p' $OUT_DIR/$NAME.j$JOBS.$PASS.json >> $OUT_DIR/$NAME.j$JOBS.$PASS.txt
+		done
+		NUM_IFACES=`ls $OUT_DIR/$NAME.j$JOBS | grep -c '\.iface$'`
+		if test $NUM_IFACES -ne $NUM_FILES
+		then
+			echo "$NAME: -j $JOBS stored $NUM_IFACES interface summaries for $NUM_FILES files"
+			FAILED=1
+		elif cmp -s $OUT_DIR/$NAME.j$JOBS.cold.txt $OUT_DIR/$NAME.j$JOBS.warm.txt
+		then
+			echo "$NAME: -j $JOBS warm run matches cold run"
+		else
+			echo "$NAME: -j $JOBS warm run differs from cold run:"
+			diff $OUT_DIR/$NAME.j$JOBS.cold.txt $OUT_DIR/$NAME.j$JOBS.warm.txt
+			FAILED=1
+		fi
+	done
+done
+# change a definition that main.ani uses, and compile against the summaries that were written for the unchanged version
+sed 's/area = \[int\](side \* side \* scale);/area = [string]("x");/' $TEST_DIR/../parallel/shapes.ani > $OUT_DIR/shapes.ani
+./$TARGET $TEST_DIR/../parallel/main.ani $OUT_DIR/shapes.ani -C $OUT_DIR/edited.cold > $OUT_DIR/edited.cold.txt 2>&1
+echo "exit code $?" >> $OUT_DIR/edited.cold.txt
+./$TARGET $TEST_DIR/../parallel/main.ani $OUT_DIR/shapes.ani -C $OUT_DIR/mixed.j1 > $OUT_DIR/edited.warm.txt 2>&1
+echo "exit code $?" >> $OUT_DIR/edited.warm.txt
+if cmp -s $OUT_DIR/edited.cold.txt $OUT_DIR/edited.warm.txt
+then
+	echo "edited: run with a stale dependency matches cold run"
+else
+	echo "edited: run with a stale dependency differs from cold run:"
+	diff $OUT_DIR/edited.cold.txt $OUT_DIR/edited.warm.txt
+	FAILED=1
+fi
+echo -------------------------------------------
+if test $FAILED -eq 0
+then
+	echo Compilation cache test cases passed.
+else
+	echo Failed compilation cache test cases!
+fi
+exit $FAILED
@@ -0,0 +1,43 @@
+#!/bin/sh
+
+### Library test script
+# builds a driver that compiles each test program over and over in one process through the library, and checks that the compilations all
+# come out the same and that the process doesn't keep growing (which would mean that the compilations leak)
+
+LIBRARY=$1
+TEST_DIR=$2
+CXX=$3
+OUT_DIR=tmp/libTests
+ITERATIONS=400
+MAX_GROWTH_KB=1024
+
+echo
+echo ...Running library test cases...
+echo ---------------------------------
+rm -rf $OUT_DIR
+mkdir -p $OUT_DIR
+if ! $CXX -Isrc $TEST_DIR/repeatCompile.cpp $LIBRARY -pthread -o $OUT_DIR/repeatCompile
+then
+	echo Failed to build library test driver!
+	exit 1
+fi
+FAILED=0
+for TEST in debug:"tst/debug.ani" parallel:"-j 4 tst/parallel/main.ani tst/parallel/shapes.ani" cached:"-C $OUT_DIR/cache tst/cache/summary.ani"
+do
+	NAME=${TEST%%:*}
+	if ./$OUT_DIR/repeatCompile $ITERATIONS $MAX_GROWTH_KB ${TEST#*:} -o $OUT_DIR/$NAME.out > $OUT_DIR/$NAME.txt 2>&1
+	then
+		echo "$NAME: $ITERATIONS compilations matched without leaking"
+	else
+		echo "$NAME: `cat $OUT_DIR/$NAME.txt`"
+		FAILED=1
+	fi
+done
+echo ---------------------------------
+if test $FAILED -eq 0
+then
+	echo Library test cases passed.
+else
+	echo Failed library test cases!
+fi
+exit $FAILED
@@ -0,0 +1,49 @@
+#!/bin/sh
+
+### Parallel typing test script
+# compiles each test program at several -j levels, and checks that the diagnostics, exit codes, and outputs all match the single-threaded run
+
+TARGET=$1
+TEST_DIR=$2
+OUT_DIR=tmp/parallelTests
+JOB_COUNTS="2 4 8"
+
+echo
+echo ...Running parallel typing test cases...
+echo -----------------------------------------
+rm -rf $OUT_DIR
+mkdir -p $OUT_DIR
+FAILED=0
+for TEST in clean:"main.ani shapes.ani" broken:"main.ani shapes.ani broken.ani"
+do
+	NAME=${TEST%%:*}
+	FILES=""
+	for FILE in ${TEST#*:}
+	do
+		FILES="$FILES $TEST_DIR/$FILE"
+	done
+	for JOBS in 1 $JOB_COUNTS
+	do
+		./$TARGET $FILES -j $JOBS -o $OUT_DIR/$NAME.j$JOBS.out > $OUT_DIR/$NAME.j$JOBS.txt 2>&1
+		echo "exit code $?" >> $OUT_DIR/$NAME.j$JOBS.txt
+	done
+	for JOBS in $JOB_COUNTS
+	do
+		if cmp -s $OUT_DIR/$NAME.j1.txt $OUT_DIR/$NAME.j$JOBS.txt && { test ! -f $OUT_DIR/$NAME.j1.out || cmp -s $OUT_DIR/$NAME.j1.out $OUT_DIR/$NAME.j$JOBS.out; }
+		then
+			echo "$NAME: -j $JOBS matches -j 1"
+		else
+			echo "$NAME: -j $JOBS differs from -j 1:"
+			diff $OUT_DIR/$NAME.j1.txt $OUT_DIR/$NAME.j$JOBS.txt
+			FAILED=1
+		fi
+	done
+done
+echo -----------------------------------------
+if test $FAILED -eq 0
+then
+	echo Parallel typing test cases passed.
+else
+	echo Failed parallel typing test cases!
+fi
+exit $FAILED
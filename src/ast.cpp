@@ -0,0 +1,118 @@
+#include "ast.h"
+
+#include "stats.h"
+
+// Ast functions
+
+Ast::Ast(int kind, Tree *tree, Tree *op, Ast *left, Ast *right) : kind(kind), tree(tree), site(tree), op(op), left(left), right(right), next(NULL), status(TypeStatus()), claim(0), log(NULL) {
+	STAT_COUNT(STAT_AST_NODES);
+}
+
+// arena allocators
+void *Ast::operator new(size_t size, TreeArena &arena) {
+	return arena.alloc(size);
+}
+void Ast::operator delete(void *ptr, TreeArena &arena) {} // arena memory is only released with the whole arena
+
+// lowering functions
+
+Ast *lowerPrimaryBase(Tree *tree, TreeArena &arena) {
+	if (tree->ast != NULL) {
+		return tree->ast;
+	}
+	Ast *retVal;
+	Tree *pbc = tree->child; // NonArrayedIdentifier, ArrayedIdentifier, SingleAccessor, Instantiation, ExplicitFilter, Object, PrimLiteral, BracketedExp, or PrimaryBase
+	if (*pbc == TOKEN_NonArrayedIdentifier || *pbc == TOKEN_ArrayedIdentifier) {
+		retVal = new (arena) Ast(AST_IDENTIFIER, pbc);
+	} else if (*pbc == TOKEN_SingleAccessor) {
+		retVal = new (arena) Ast(AST_DELATCH, pbc, pbc->child, new (arena) Ast(AST_IDENTIFIER, pbc->next));
+	} else if (*pbc == TOKEN_Instantiation) {
+		retVal = new (arena) Ast(AST_INSTANTIATION, pbc);
+	} else if (*pbc == TOKEN_ExplicitFilter) {
+		retVal = new (arena) Ast(AST_FILTER, pbc);
+	} else if (*pbc == TOKEN_Object) {
+		retVal = new (arena) Ast(AST_OBJECT, pbc);
+	} else if (*pbc == TOKEN_PrimLiteral) {
+		retVal = new (arena) Ast(AST_LITERAL, pbc);
+	} else if (*pbc == TOKEN_BracketedExp) {
+		retVal = lowerBracketedExp(pbc, arena);
+	} else /* if (*pbc == TOKEN_PrimaryBase) */ { // postfix operator application
+		retVal = new (arena) Ast(AST_POSTFIX, tree, pbc->next->child, lowerPrimaryBase(pbc, arena));
+	}
+	retVal->site = tree;
+	tree->ast = retVal;
+	return retVal;
+}
+
+Ast *lowerPrimary(Tree *tree, TreeArena &arena) {
+	if (tree->ast != NULL) {
+		return tree->ast;
+	}
+	Ast *retVal;
+	Tree *primaryc = tree->child; // PrimaryBase or PrefixOrMultiOp
+	if (*primaryc == TOKEN_PrimaryBase) {
+		retVal = lowerPrimaryBase(primaryc, arena);
+	} else /* if (*primaryc == TOKEN_PrefixOrMultiOp) */ {
+		retVal = new (arena) Ast(AST_PREFIX, tree, primaryc->child->child, lowerPrimary(primaryc->next, arena));
+	}
+	retVal->site = tree;
+	tree->ast = retVal;
+	return retVal;
+}
+
+Ast *lowerExp(Tree *tree, TreeArena &arena) {
+	if (tree->ast != NULL) {
+		return tree->ast;
+	}
+	Ast *retVal;
+	Tree *expc = tree->child; // Primary or Exp
+	if (*expc == TOKEN_Primary) {
+		retVal = lowerPrimary(expc, arena);
+	} else /* if (*expc == TOKEN_Exp) */ {
+		retVal = new (arena) Ast(AST_INFIX, tree, expc->next, lowerExp(expc, arena), lowerExp(expc->next->next, arena));
+	}
+	retVal->site = tree;
+	tree->ast = retVal;
+	return retVal;
+}
+
+Ast *lowerBracketedExp(Tree *tree, TreeArena &arena) {
+	if (tree->ast != NULL) {
+		return tree->ast;
+	}
+	Ast *retVal = new (arena) Ast(AST_BRACKETED, tree);
+	Tree *becn = tree->child->next; // RBRACKET or ExpList
+	if (*becn == TOKEN_ExpList) { // if there's a list of expressions, lower and link in each one
+		Ast **tail = &(retVal->left);
+		for (Tree *exp = becn->child; exp != NULL; exp = (exp->next != NULL) ? exp->next->next->child : NULL) {
+			*tail = lowerExp(exp, arena);
+			tail = &((*tail)->next);
+		}
+	}
+	tree->ast = retVal;
+	return retVal;
+}
+
+// lowers all of the expressions in the given parse tree
+void lower(Tree *treeRoot, TreeArena &arena) {
+	vector<Tree *> stack; // explicit stack, so that long sibling chains don't recurse
+	if (treeRoot != NULL) {
+		stack.push_back(treeRoot);
+	}
+	while (!stack.empty()) {
+		Tree *cur = stack.back();
+		stack.pop_back();
+		if (*cur == TOKEN_Exp) {
+			lowerExp(cur, arena);
+		} else if (*cur == TOKEN_BracketedExp) {
+			lowerBracketedExp(cur, arena);
+		}
+		// note: nodes that were lowered above are still walked, since they can contain further expressions (e.g. in array subscripts and filter bodies)
+		if (cur->next != NULL) {
+			stack.push_back(cur->next);
+		}
+		if (cur->child != NULL) {
+			stack.push_back(cur->child);
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef _AST_H_
+#define _AST_H_
+
+#include "globalDefs.h"
+#include "constantDefs.h"
+#include "driver.h"
+
+#include "parser.h"
+#include "types.h"
+
+// Ast node kinds
+#define AST_IDENTIFIER 1 // NonArrayedIdentifier or ArrayedIdentifier
+#define AST_INSTANTIATION 2
+#define AST_FILTER 3 // ExplicitFilter
+#define AST_OBJECT 4
+#define AST_LITERAL 5 // PrimLiteral
+#define AST_DELATCH 6 // SingleAccessor applied to an identifier
+#define AST_POSTFIX 7 // PrimaryBase with a postfix operator
+#define AST_PREFIX 8 // Primary with a prefix operator
+#define AST_INFIX 9 // Exp with an infix operator
+#define AST_BRACKETED 10 // BracketedExp
+
+// compact expression tree lowered from the concrete parse tree; unit productions and punctuation are elided
+// note: this is an overlay on the parse tree's expressions, not a replacement for the parse tree (which is kept, since declarations, types, and terms are
+// still typed on it); lowering adds nodes (-J counts 211 Ast nodes on top of 5555 Tree nodes for tst/debug.ani), and only saves expression typing the unit chains
+class Ast {
+	public:
+		// data members
+		int kind;
+		Tree *tree; // the concrete node of the construct itself (passed through to the Tree-level typing functions for leaves)
+		Tree *site; // the outermost concrete node that this node stands for (i.e. where errors are reported)
+		Tree *op; // the operator token (DELATCH, POSTFIX, PREFIX, and INFIX only)
+		Ast *left; // the operand (DELATCH, POSTFIX, PREFIX), left operand (INFIX), or first list element (BRACKETED)
+		Ast *right; // the right operand (INFIX only)
+		Ast *next; // the next element in the enclosing BRACKETED list
+		TypeStatus status; // the status coming OUT of this node
+		volatile unsigned int claim; // as in Tree
+		StatusLog *log;
+		// allocators/deallocators
+		Ast(int kind, Tree *tree, Tree *op = NULL, Ast *left = NULL, Ast *right = NULL);
+		// note: trivially destructible, as Tree is
+		// arena allocators
+		void *operator new(size_t size, TreeArena &arena);
+		void operator delete(void *ptr, TreeArena &arena);
+};
+
+Ast *lowerExp(Tree *tree, TreeArena &arena);
+Ast *lowerBracketedExp(Tree *tree, TreeArena &arena);
+void lower(Tree *treeRoot, TreeArena &arena);
+
+#endif
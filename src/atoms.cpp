@@ -0,0 +1,130 @@
+#include "atoms.h"
+
+#include "context.h"
+
+// the global atom table
+AtomTable atomTable;
+
+// FNV-1a string hash
+unsigned int hashString(const char *s, unsigned int length) {
+	unsigned int hash = 2166136261u;
+	for (unsigned int i=0; i<length; i++) {
+		hash ^= (unsigned char)s[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// AtomTable functions
+
+AtomTable::AtomTable() : capacity(ATOM_TABLE_INITIAL_SIZE), count(0) {
+	pthread_mutex_init(&lock, NULL);
+	slots = new Atom[capacity];
+	for (unsigned int i=0; i<capacity; i++) {
+		slots[i] = NULL_ATOM;
+	}
+	for (unsigned int i=0; i<ATOM_MAX_CHUNKS; i++) {
+		chunks[i] = NULL;
+	}
+	// reserve the null atom (which is never entered into the hash index), then the other fixed atoms
+	chunks[0] = new string[ATOM_CHUNK_SIZE];
+	count = 1;
+	intern("..", 2);
+	intern("[]", 2);
+	intern("[:]", 3);
+}
+AtomTable::~AtomTable() {
+	for (unsigned int i=0; i<ATOM_MAX_CHUNKS; i++) {
+		delete[] chunks[i];
+	}
+	delete[] slots;
+	pthread_mutex_destroy(&lock);
+}
+
+const string &AtomTable::str(Atom atom) const {
+	return chunks[atom / ATOM_CHUNK_SIZE][atom % ATOM_CHUNK_SIZE];
+}
+
+void AtomTable::grow() {
+	unsigned int newCapacity = capacity * 2;
+	Atom *newSlots = new Atom[newCapacity];
+	for (unsigned int i=0; i<newCapacity; i++) {
+		newSlots[i] = NULL_ATOM;
+	}
+	for (unsigned int i=0; i<capacity; i++) {
+		if (slots[i] != NULL_ATOM) {
+			const string &s = str(slots[i]);
+			unsigned int pos = hashString(s.data(), s.length()) & (newCapacity-1);
+			while (newSlots[pos] != NULL_ATOM) {
+				pos = (pos+1) & (newCapacity-1);
+			}
+			newSlots[pos] = slots[i];
+		}
+	}
+	delete[] slots;
+	slots = newSlots;
+	capacity = newCapacity;
+}
+
+Atom AtomTable::intern(const char *s, unsigned int length) {
+	if (length == 0) {
+		return NULL_ATOM;
+	}
+	unsigned int hash = hashString(s, length);
+	pthread_mutex_lock(&lock);
+	// probe for an existing atom
+	unsigned int pos = hash & (capacity-1);
+	for (Atom cur; (cur = slots[pos]) != NULL_ATOM; pos = (pos+1) & (capacity-1)) {
+		const string &curString = str(cur);
+		if (curString.length() == length && memcmp(curString.data(), s, length) == 0) {
+			pthread_mutex_unlock(&lock);
+			return cur;
+		}
+	}
+	// otherwise, allocate a new atom
+	Atom retVal = count;
+	if (retVal / ATOM_CHUNK_SIZE >= ATOM_MAX_CHUNKS) { // out of atom space; this is far beyond any realistic program
+		pthread_mutex_unlock(&lock);
+		cerr << PROGRAM_STRING << ": too many distinct identifiers\n";
+		exit(1);
+	}
+	if (chunks[retVal / ATOM_CHUNK_SIZE] == NULL) {
+		chunks[retVal / ATOM_CHUNK_SIZE] = new string[ATOM_CHUNK_SIZE];
+	}
+	chunks[retVal / ATOM_CHUNK_SIZE][retVal % ATOM_CHUNK_SIZE].assign(s, length);
+	slots[pos] = retVal;
+	count++;
+	// keep the load factor at or below one half
+	if (count*2 > capacity) {
+		grow();
+	}
+	pthread_mutex_unlock(&lock);
+	return retVal;
+}
+Atom AtomTable::intern(const string &s) {
+	return intern(s.data(), s.length());
+}
+
+// convenience wrappers
+
+Atom intern(const char *s, unsigned int length) {
+	return atomTable.intern(s, length);
+}
+Atom intern(const string &s) {
+	return atomTable.intern(s);
+}
+const string &atomString(Atom atom) {
+	return atomTable.str(atom);
+}
+
+// rebuilds the string representation of an identifier from its atom path, up to and including the given depth
+string rebuildId(const vector<Atom> &path, unsigned int depth) {
+	string acc;
+	for (unsigned int i=0; i <= depth; i++) {
+		acc += atomString(path[i]);
+		if (i != depth) {
+			acc += '.';
+		}
+	}
+	return acc;
+}
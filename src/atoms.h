@@ -0,0 +1,46 @@
+#ifndef _ATOMS_H_
+#define _ATOMS_H_
+
+#include "globalDefs.h"
+#include "constantDefs.h"
+#include "driver.h"
+
+// interned identifier handle; equal atoms denote equal strings
+typedef unsigned int Atom;
+
+// pre-interned atoms (in the order in which AtomTable's constructor interns them)
+#define NULL_ATOM 0 // the empty string
+#define ATOM_RECALL 1 // ".."
+#define ATOM_SUBSCRIPT 2 // "[]"
+#define ATOM_RANGE_SUBSCRIPT 3 // "[:]"
+
+// process-wide string intern table; interning is locked (the lexers run in parallel), but looking up an atom's string is not
+class AtomTable {
+	public:
+		// data members
+		pthread_mutex_t lock;
+		Atom *slots; // open-addressing hash index into the atoms; NULL_ATOM marks an empty slot
+		unsigned int capacity; // the number of slots; always a power of two
+		unsigned int count; // the number of atoms interned so far, including NULL_ATOM
+		string *chunks[ATOM_MAX_CHUNKS]; // atom strings, in fixed-size chunks so that they never move once interned
+		// allocators/deallocators
+		AtomTable();
+		~AtomTable();
+		// accessors
+		const string &str(Atom atom) const;
+		// core methods
+		Atom intern(const char *s, unsigned int length);
+		Atom intern(const string &s);
+	private:
+		void grow();
+};
+
+extern AtomTable atomTable;
+
+// convenience wrappers
+Atom intern(const char *s, unsigned int length);
+Atom intern(const string &s);
+const string &atomString(Atom atom);
+string rebuildId(const vector<Atom> &path, unsigned int depth);
+
+#endif
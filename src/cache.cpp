@@ -0,0 +1,970 @@
+#include "cache.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <set>
+using std::set;
+
+// cache key functions
+
+// FNV-1a, continued from the given hash
+uint64_t hashBytes(const char *data, size_t size, uint64_t hash) {
+	for (size_t i=0; i<size; i++) {
+		hash ^= (unsigned char)data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+// a second, independent hash (a multiply-xorshift over 8-byte words) for checking entries' contents, so that neither a key collision nor a damaged entry goes unnoticed
+uint64_t checkBytes(const char *data, size_t size) {
+	uint64_t hash = 0x243F6A8885A308D3ULL;
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, data + i, sizeof(word));
+		hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+		hash ^= hash >> 29;
+	}
+	for (; i < size; i++) {
+		hash = (hash ^ (unsigned char)data[i]) * 0x9E3779B97F4A7C15ULL;
+		hash ^= hash >> 29;
+	}
+	return hash;
+}
+
+uint64_t hashSource(const SourceBuffer *in) {
+	uint64_t hash = hashBytes(in->data, in->size, 14695981039346656037ULL);
+	string version = string(VERSION_STRING) + "." + VERSION_STAMP;
+	hash = hashBytes(version.data(), version.size(), hash);
+	uint32_t tabWidth = tabModulus(); // the lexer bakes the tab modulus into the column numbers
+	return hashBytes((const char *)&tabWidth, sizeof(tabWidth), hash);
+}
+
+string cacheFileName(uint64_t sourceHash, const char *extension) {
+	char hashBuf[MAX_INT_STRING_LENGTH];
+	sprintf(hashBuf, "%016llx", (unsigned long long)sourceHash);
+	return string(cacheDir()) + "/" + hashBuf + extension;
+}
+
+// fills in the key fields shared by the ParseCacheHeader and InterfaceHeader, zeroing the rest
+template <class T> void initCacheHeader(T &header, const char *magic, const SourceBuffer *in, uint64_t sourceHash) {
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, magic, PARSE_CACHE_MAGIC_LENGTH);
+	string version = string(VERSION_STRING) + "." + VERSION_STAMP;
+	strncpy(header.version, version.c_str(), PARSE_CACHE_VERSION_LENGTH-1);
+	header.sourceHash = sourceHash;
+	header.sourceCheck = checkBytes(in->data, in->size);
+	header.sourceSize = in->size;
+	header.tabWidth = tabModulus();
+}
+
+template <class T> bool matchesCacheHeader(const T &header, const T &expected) {
+	return (memcmp(header.magic, expected.magic, PARSE_CACHE_MAGIC_LENGTH) == 0 && memcmp(header.version, expected.version, PARSE_CACHE_VERSION_LENGTH) == 0 &&
+		header.sourceHash == expected.sourceHash && header.sourceCheck == expected.sourceCheck && header.sourceSize == expected.sourceSize && header.tabWidth == expected.tabWidth);
+}
+
+// returns whether the records following the given (mapped) header are the ones that were written
+template <class T> bool matchesCachePayload(const T *header, size_t size) {
+	return (checkBytes((const char *)(header + 1), size - sizeof(T)) == header->payloadCheck);
+}
+
+// maps in the given cache entry, returning NULL (and leaving size unset) if it doesn't exist or is smaller than minSize
+const void *mapCacheEntry(const string &fileName, size_t minSize, size_t &size) {
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) { // if there's no entry, it's a miss
+		return NULL;
+	}
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || (size_t)fileStat.st_size < minSize) {
+		close(fd);
+		return NULL;
+	}
+	void *mapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // the mapping holds its own reference to the file
+	if (mapping == MAP_FAILED) {
+		return NULL;
+	}
+	size = fileStat.st_size;
+	return mapping;
+}
+
+// returns the check hash of the records that follow the header (the first chunk) of a cache entry
+uint64_t checkPayload(const vector<pair<const void *, size_t> > &chunks) {
+	string payload;
+	for (unsigned int i=1; i<chunks.size(); i++) {
+		payload.append((const char *)(chunks[i].first), chunks[i].second);
+	}
+	return checkBytes(payload.data(), payload.size());
+}
+
+// writes the given chunks out as a cache entry, going through a uniquely named temporary file so that concurrent compilations (and the jobs of this one) never see a partial entry
+bool writeCacheEntry(const string &fileName, const vector<pair<const void *, size_t> > &chunks) {
+	mkdir(cacheDir(), 0777); // note: failure here shows up as a failure to create the file below
+	string tempFileName = fileName + ".XXXXXX";
+	vector<char> tempName(tempFileName.begin(), tempFileName.end());
+	tempName.push_back('\0');
+	int fd = mkstemp(&(tempName[0]));
+	if (fd < 0) {
+		return false;
+	}
+	FILE *out = fdopen(fd, "wb");
+	if (out == NULL) {
+		close(fd);
+		unlink(&(tempName[0]));
+		return false;
+	}
+	bool written = true;
+	for (unsigned int i=0; i<chunks.size() && written; i++) {
+		written = (chunks[i].second == 0 || fwrite(chunks[i].first, chunks[i].second, 1, out) == 1);
+	}
+	if (fclose(out) != 0 || !written || rename(&(tempName[0]), fileName.c_str()) != 0) {
+		unlink(&(tempName[0]));
+		return false;
+	}
+	return true;
+}
+
+// parse cache loading
+
+// returns the table entry at the given cache index, or NULL for PARSE_CACHE_NULL_INDEX (flagging out-of-range indices as invalid)
+template <class T> T *cacheLink(const vector<T *> &table, uint32_t index, bool &valid) {
+	if (index == PARSE_CACHE_NULL_INDEX) {
+		return NULL;
+	} else if (index >= table.size()) {
+		valid = false;
+		return NULL;
+	}
+	return table[index];
+}
+
+// rebuilds the parse tree recorded in the given (already mapped) cache entry in the given arena; returns NULL if the records turn out to be malformed
+// (the nodes can't be used from the mapping directly, since they carry run-time state; they're re-created and re-linked in a single preorder pass instead)
+Tree *rebuildParseTree(const ParseCacheHeader *header, unsigned int fileIndex, TreeArena &treeArena) {
+	SourceBuffer *in = inFiles()[fileIndex];
+	const ParseCacheNode *records = (const ParseCacheNode *)(header + 1);
+	const ParseCacheAst *astRecords = (const ParseCacheAst *)(records + header->numNodes);
+	// restore the literal text that the lexer would have materialized, so that the token offsets resolve as before
+	in->arena.assign((const char *)(astRecords + header->numAsts), header->arenaSize);
+	size_t textSize = in->size + header->arenaSize;
+	// allocate the lowered expression nodes up front, so that the tree nodes can point at them as they're created
+	vector<Ast *> asts(header->numAsts);
+	for (uint32_t i=0; i<header->numAsts; i++) {
+		asts[i] = new (treeArena) Ast(astRecords[i].kind, NULL);
+	}
+	// allocate the tree nodes in preorder, linking each one in to its parent or previous sibling as we go
+	bool valid = true;
+	vector<Tree *> nodes(header->numNodes);
+	vector<uint32_t> ancestors; // the indices of the nodes whose children are currently being allocated
+	Tree *parent = NULL;
+	Tree *prev = NULL; // the previous sibling of the node being allocated
+	bool done = false; // whether the root's subtree is complete
+	for (uint32_t i=0; i<header->numNodes && valid; i++) {
+		const ParseCacheNode &record = records[i];
+		if (done || (record.length != 0 && (size_t)record.offset + record.length > textSize)) {
+			valid = false;
+			break;
+		}
+		Tree *cur = new (treeArena) Tree(Token(record.tokenType, record.offset, record.length, fileIndex, record.row, record.col));
+		nodes[i] = cur;
+		if (record.tokenType == TOKEN_ID) { // atoms are per-process, so re-intern identifiers from their text
+			cur->t.atom = intern(cur->t.text(), record.length);
+		}
+		if (prev != NULL) {
+			*prev += cur;
+		} else if (parent != NULL) {
+			*parent *= cur;
+		}
+		if (record.flags & PARSE_CACHE_LINKS_BACK) {
+			*cur -= prev;
+		}
+		if (record.flags & PARSE_CACHE_LINKS_PARENT) {
+			*cur &= parent;
+		}
+		cur->ast = cacheLink(asts, record.ast, valid);
+		if (record.flags & PARSE_CACHE_HAS_CHILD) { // if this node has children, descend into them
+			ancestors.push_back(i);
+			parent = cur;
+			prev = NULL;
+			continue;
+		}
+		// otherwise, this node's subtree is complete, so climb up to the nearest node that has a next sibling to come
+		uint32_t last = i;
+		while (!(records[last].flags & PARSE_CACHE_HAS_NEXT) && !ancestors.empty()) {
+			last = ancestors.back();
+			ancestors.pop_back();
+		}
+		done = !(records[last].flags & PARSE_CACHE_HAS_NEXT);
+		prev = nodes[last];
+		parent = !ancestors.empty() ? nodes[ancestors.back()] : NULL;
+	}
+	if (!done) { // if the records ran out in the middle of the tree, they're malformed
+		valid = false;
+	}
+	// link up the lowered expression nodes
+	for (uint32_t i=0; i<header->numAsts && valid; i++) {
+		const ParseCacheAst &record = astRecords[i];
+		Ast *ast = asts[i];
+		ast->tree = cacheLink(nodes, record.tree, valid);
+		ast->site = cacheLink(nodes, record.site, valid);
+		ast->op = cacheLink(nodes, record.op, valid);
+		ast->left = cacheLink(asts, record.left, valid);
+		ast->right = cacheLink(asts, record.right, valid);
+		ast->next = cacheLink(asts, record.next, valid);
+	}
+	return valid ? nodes[0] : NULL;
+}
+
+// maps in the file's cache entry and rebuilds its parse tree in the given arena (which must be empty); returns NULL if there's no usable entry
+Tree *loadParseCache(unsigned int fileIndex, TreeArena &treeArena) {
+	SourceBuffer *in = inFiles()[fileIndex];
+	uint64_t sourceHash = hashSource(in);
+	size_t size;
+	const void *mapping = mapCacheEntry(cacheFileName(sourceHash, PARSE_CACHE_FILE_EXTENSION), sizeof(ParseCacheHeader), size);
+	if (mapping == NULL) {
+		return NULL;
+	}
+	// check that the entry belongs to this source and is the right size before looking at any of its records
+	ParseCacheHeader expected;
+	initCacheHeader(expected, PARSE_CACHE_MAGIC, in, sourceHash);
+	const ParseCacheHeader *header = (const ParseCacheHeader *)mapping;
+	Tree *retVal = NULL;
+	if (matchesCacheHeader(*header, expected) &&
+			header->numNodes != 0 && size == sizeof(ParseCacheHeader) + (size_t)header->numNodes * sizeof(ParseCacheNode) +
+				(size_t)header->numAsts * sizeof(ParseCacheAst) + header->arenaSize && matchesCachePayload(header, size)) {
+		retVal = rebuildParseTree(header, fileIndex, treeArena);
+		if (retVal == NULL) { // if the entry was malformed, throw away whatever we managed to rebuild, and fall back to lexing and parsing the file
+			treeArena.release();
+			in->arena.clear();
+		}
+	}
+	munmap((void *)mapping, size);
+	return retVal;
+}
+
+// parse cache storing
+
+// returns the cache index of the given node, as numbered by storeParseCache (flagging nodes that weren't numbered as invalid)
+template <class T> uint32_t cacheIndex(T *node, bool &valid) {
+	if (node == NULL) {
+		return PARSE_CACHE_NULL_INDEX;
+	} else if (node->claim == 0) {
+		valid = false;
+		return PARSE_CACHE_NULL_INDEX;
+	}
+	return node->claim - 1;
+}
+
+// writes out a cache entry for the file's freshly parsed tree (which mustn't be linked into the trunk yet)
+bool storeParseCache(unsigned int fileIndex, Tree *parseme) {
+	SourceBuffer *in = inFiles()[fileIndex];
+	if (parseme->next != NULL || parseme->back != NULL || parseme->parent != NULL) {
+		return false;
+	}
+	// flatten the tree nodes in preorder, checking that all of their links are implied by their position
+	// (the nodes are numbered through their claim fields, which aren't used until semantic analysis; the numbers are offset by one, so that 0 still means unnumbered)
+	bool valid = true;
+	vector<Tree *> order;
+	vector<ParseCacheNode> records;
+	vector<Ast *> astOrder;
+	vector<Tree *> stack(1, parseme); // explicit stacks, so that long sibling chains don't recurse
+	vector<Tree *> parents(1, (Tree *)NULL); // the parent of each node on the stack
+	vector<Tree *> prevs(1, (Tree *)NULL); // the previous sibling of each node on the stack
+	while (!stack.empty()) {
+		Tree *cur = stack.back();
+		Tree *parent = parents.back();
+		Tree *prev = prevs.back();
+		stack.pop_back();
+		parents.pop_back();
+		prevs.pop_back();
+		order.push_back(cur);
+		cur->claim = order.size();
+		ParseCacheNode record;
+		record.tokenType = cur->t.tokenType;
+		record.flags = 0;
+		record.offset = cur->t.offset;
+		record.length = cur->t.length;
+		record.row = cur->t.row;
+		record.col = cur->t.col;
+		record.ast = PARSE_CACHE_NULL_INDEX;
+		if (cur->child != NULL) {
+			record.flags |= PARSE_CACHE_HAS_CHILD;
+		}
+		if (cur->next != NULL) {
+			record.flags |= PARSE_CACHE_HAS_NEXT;
+		}
+		if (cur->back != NULL) {
+			record.flags |= PARSE_CACHE_LINKS_BACK;
+		}
+		if (cur->parent != NULL) {
+			record.flags |= PARSE_CACHE_LINKS_PARENT;
+		}
+		if (cur->ast != NULL) {
+			if (cur->ast->claim == 0) {
+				astOrder.push_back(cur->ast);
+				cur->ast->claim = astOrder.size();
+			}
+			record.ast = cur->ast->claim - 1;
+		}
+		if ((cur->back != NULL && cur->back != prev) || (cur->parent != NULL && cur->parent != parent) ||
+				record.tokenType != cur->t.tokenType || cur->t.fileIndex != fileIndex) { // loading re-stamps every token with the file index
+			valid = false;
+		}
+		records.push_back(record);
+		if (cur->next != NULL) {
+			stack.push_back(cur->next);
+			parents.push_back(parent);
+			prevs.push_back(cur);
+		}
+		if (cur->child != NULL) {
+			stack.push_back(cur->child);
+			parents.push_back(cur);
+			prevs.push_back(NULL);
+		}
+	}
+	// flatten the lowered expression nodes (including the ones that are only reachable from other expression nodes)
+	vector<ParseCacheAst> astRecords;
+	for (unsigned int i=0; i<astOrder.size(); i++) {
+		Ast *ast = astOrder[i];
+		Ast *links[] = {ast->left, ast->right, ast->next};
+		for (unsigned int j=0; j<sizeof(links)/sizeof(links[0]); j++) {
+			if (links[j] != NULL && links[j]->claim == 0) {
+				astOrder.push_back(links[j]);
+				links[j]->claim = astOrder.size();
+			}
+		}
+		ParseCacheAst record;
+		record.kind = ast->kind;
+		record.tree = cacheIndex(ast->tree, valid);
+		record.site = cacheIndex(ast->site, valid);
+		record.op = cacheIndex(ast->op, valid);
+		record.left = cacheIndex(ast->left, valid);
+		record.right = cacheIndex(ast->right, valid);
+		record.next = cacheIndex(ast->next, valid);
+		astRecords.push_back(record);
+	}
+	// clear the numbering back out
+	for (unsigned int i=0; i<order.size(); i++) {
+		order[i]->claim = 0;
+	}
+	for (unsigned int i=0; i<astOrder.size(); i++) {
+		astOrder[i]->claim = 0;
+	}
+	if (!valid) {
+		return false;
+	}
+	ParseCacheHeader header;
+	uint64_t sourceHash = hashSource(in);
+	initCacheHeader(header, PARSE_CACHE_MAGIC, in, sourceHash);
+	header.numNodes = records.size();
+	header.numAsts = astRecords.size();
+	header.arenaSize = in->arena.size();
+	vector<pair<const void *, size_t> > chunks;
+	chunks.push_back(make_pair((const void *)&header, sizeof(header)));
+	chunks.push_back(make_pair((const void *)&(records[0]), records.size() * sizeof(ParseCacheNode)));
+	if (!astRecords.empty()) {
+		chunks.push_back(make_pair((const void *)&(astRecords[0]), astRecords.size() * sizeof(ParseCacheAst)));
+	}
+	chunks.push_back(make_pair((const void *)in->arena.data(), (size_t)header.arenaSize));
+	header.payloadCheck = checkPayload(chunks);
+	return writeCacheEntry(cacheFileName(sourceHash, PARSE_CACHE_FILE_EXTENSION), chunks);
+}
+
+// interface summaries
+
+// the standard types, which type records refer to by index rather than by value (the semmer compares some of them by identity)
+void getGlobalTypes(vector<Type *> &globals) {
+	Type *namedTypes[] = {nullType(), errType(), stdBoolType(), stdIntType(), stdFloatType(), stdCharType(), stdStringType(), stdBoolLitType(),
+		inIntType(), inFloatType(), inCharType(), inStringType(), stringerType(), boolUnOpType(), intUnOpType(), boolBinOpType(), intBinOpType(), floatBinOpType(),
+		boolCompOpType(), intCompOpType(), floatCompOpType(), charCompOpType(), stringCompOpType(), stdLibType()};
+	globals.assign(namedTypes, namedTypes + sizeof(namedTypes)/sizeof(namedTypes[0]));
+	const vector<SymbolTree *> &libList = stdLib()->children.sorted();
+	for (unsigned int i=0; i<libList.size(); i++) {
+		globals.push_back(libList[i]->defSite->status.type);
+	}
+}
+
+// lists the nodes of the given file's parse tree (a Program node) in preorder
+void flattenProgram(Tree *program, vector<Tree *> &order) {
+	vector<Tree *> stack(1, program); // explicit stack, as in lower()
+	while (!stack.empty()) {
+		Tree *cur = stack.back();
+		stack.pop_back();
+		order.push_back(cur);
+		if (cur->next != NULL && cur != program) { // the Program node's next is the next file's
+			stack.push_back(cur->next);
+		}
+		if (cur->child != NULL) {
+			stack.push_back(cur->child);
+		}
+	}
+}
+
+// lists the compilation's source files, along with their parse trees and keys
+void getInterfaceFiles(Tree *treeRoot, vector<InterfaceFile> &files) {
+	unsigned int numFiles = 0;
+	for (Tree *programCur = treeRoot; programCur != NULL; programCur = programCur->next) {
+		numFiles++;
+	}
+	files.resize(numFiles);
+	unsigned int i = 0;
+	for (Tree *programCur = treeRoot; programCur != NULL; programCur = programCur->next, i++) {
+		InterfaceFile &file = files[i];
+		file.program = programCur;
+		flattenProgram(programCur, file.nodes);
+		SourceBuffer *in = inFiles()[programCur->t.fileIndex];
+		file.key.sourceHash = hashSource(in);
+		file.key.sourceCheck = checkBytes(in->data, in->size);
+		file.key.sourceSize = in->size;
+		file.key.numNodes = file.nodes.size();
+	}
+}
+
+// maps the definition sites of the nodes that semSt() derives to the nodes' kinds (going by the SymbolTree, since not every tree node gets an environment)
+void getDerivedNodes(SymbolTree *root, map<Tree *, int> &derivedNodes, set<SymbolTree *> &visited) {
+	if (!(visited.insert(root).second)) { // as in getSemStTasks()
+		return;
+	}
+	if ((root->kind == KIND_DECLARATION || root->kind == KIND_INSTRUCTOR || root->kind == KIND_OUTSTRUCTOR) && root->defSite != NULL) {
+		derivedNodes.insert(make_pair(root->defSite, root->kind));
+	}
+	const vector<SymbolTree *> &childList = root->children.sorted();
+	for (unsigned int i=0; i < childList.size(); i++) {
+		getDerivedNodes(childList[i], derivedNodes, visited);
+	}
+}
+
+// InterfaceWriter functions
+
+InterfaceWriter::InterfaceWriter(const map<Tree *, pair<uint32_t, uint32_t> > &treeIndices, uint32_t file, uint32_t numNodes) :
+	treeIndices(treeIndices), file(file), numNodes(numNodes), valid(true) {
+	vector<Type *> globals;
+	getGlobalTypes(globals);
+	for (unsigned int i=0; i<globals.size(); i++) {
+		globalIndices.insert(make_pair(globals[i], i)); // types that appear more than once keep their first index
+	}
+}
+InterfaceWriter::~InterfaceWriter() {}
+
+uint32_t InterfaceWriter::treeRef(Tree *tree) {
+	if (tree == NULL) {
+		return INTERFACE_NULL_INDEX;
+	}
+	map<Tree *, pair<uint32_t, uint32_t> >::const_iterator treeFind = treeIndices.find(tree);
+	if (treeFind == treeIndices.end()) { // if the tree node isn't in any of the files (i.e. the semmer made it up), the type can't be summarized
+		valid = false;
+		return INTERFACE_NULL_INDEX;
+	}
+	if (treeFind->second.first == file) {
+		return treeFind->second.second;
+	}
+	// otherwise, refer to the node through the foreign node table, making its file a dependency if it isn't one already
+	map<Tree *, uint32_t>::const_iterator foreignFind = foreignIndices.find(tree);
+	if (foreignFind != foreignIndices.end()) {
+		return numNodes + foreignFind->second;
+	}
+	map<uint32_t, uint32_t>::const_iterator dependencyFind = dependencyIndices.find(treeFind->second.first);
+	if (dependencyFind == dependencyIndices.end()) {
+		dependencyFind = dependencyIndices.insert(make_pair(treeFind->second.first, (uint32_t)dependencies.size())).first;
+		dependencies.push_back(treeFind->second.first);
+	}
+	InterfaceForeignNode foreignNode;
+	foreignNode.dependency = dependencyFind->second;
+	foreignNode.node = treeFind->second.second;
+	uint32_t index = foreignNodes.size();
+	foreignNodes.push_back(foreignNode);
+	foreignIndices.insert(make_pair(tree, index));
+	return numNodes + index;
+}
+uint32_t InterfaceWriter::typeRef(Type *type) {
+	if (type == NULL) {
+		return INTERFACE_NULL_INDEX;
+	}
+	map<Type *, uint32_t>::const_iterator typeFind = typeIndices.find(type);
+	if (typeFind != typeIndices.end()) {
+		return typeFind->second;
+	}
+	uint32_t index = types.size();
+	types.push_back(type);
+	typeIndices.insert(make_pair(type, index));
+	return index;
+}
+void InterfaceWriter::flush() {
+	for (unsigned int i = offsets.size(); i < types.size(); i++) { // note: writing a record can reference new types, which get appended
+		offsets.push_back(words.size());
+		writeType(types[i]);
+	}
+}
+void InterfaceWriter::writeType(Type *type) {
+	map<Type *, uint32_t>::const_iterator globalFind = globalIndices.find(type);
+	if (globalFind != globalIndices.end()) {
+		words.push_back(INTERFACE_TYPE_GLOBAL);
+		words.push_back(globalFind->second);
+		return;
+	}
+	if (type->category == CATEGORY_STDTYPE) { // if it's the canonical instance of a plain StdType, refer to that (internStdType() creates it if it doesn't exist yet, in which case this isn't it)
+		StdType *stdType = (StdType *)type;
+		if (stdType->offsetExp == NULL && stdType->kind >= 0 && stdType->kind < NUM_STD_KINDS && stdType->suffix >= 0 && stdType->suffix < NUM_SUFFIXES &&
+				stdType->depth >= 0 && stdType->depth < STD_TYPE_INTERN_DEPTH && internStdType(stdType->kind, stdType->suffix, stdType->depth) == type) {
+			words.push_back(INTERFACE_TYPE_INTERNED);
+			words.push_back(stdType->kind);
+			words.push_back(stdType->suffix);
+			words.push_back(stdType->depth);
+			return;
+		}
+	}
+	// otherwise, write the type out by value
+	uint32_t tag;
+	switch (type->category) {
+		case CATEGORY_STDTYPE:
+			tag = INTERFACE_TYPE_STD;
+			break;
+		case CATEGORY_TYPELIST:
+			tag = INTERFACE_TYPE_LIST;
+			break;
+		case CATEGORY_FILTERTYPE:
+			tag = INTERFACE_TYPE_FILTER;
+			break;
+		case CATEGORY_OBJECTTYPE:
+			tag = INTERFACE_TYPE_OBJECT;
+			break;
+		default: // the only ErrorType is errType itself
+			valid = false;
+			return;
+	}
+	words.push_back(tag);
+	words.push_back(type->suffix);
+	words.push_back(type->depth);
+	words.push_back(treeRef(type->offsetExp));
+	words.push_back((type->referensible ? INTERFACE_TYPE_REFERENSIBLE : 0) | (type->instantiable ? INTERFACE_TYPE_INSTANTIABLE : 0));
+	if (tag == INTERFACE_TYPE_STD) {
+		words.push_back(((StdType *)type)->kind);
+	} else if (tag == INTERFACE_TYPE_LIST) {
+		const vector<Type *> &list = ((TypeList *)type)->list;
+		words.push_back(list.size());
+		for (unsigned int i=0; i<list.size(); i++) {
+			words.push_back(typeRef(list[i]));
+		}
+	} else if (tag == INTERFACE_TYPE_FILTER) { // thunked from- and to- types are written out as thunks
+		FilterType *filterType = (FilterType *)type;
+		words.push_back(typeRef(filterType->fromInternal));
+		words.push_back(typeRef(filterType->toInternal));
+		words.push_back(treeRef(filterType->defSite));
+		words.push_back((filterType->defSite != NULL) ? typeRef(filterType->inType) : INTERFACE_NULL_INDEX); // inType is only set (and only meaningful) for thunked filters
+	} else /* if (tag == INTERFACE_TYPE_OBJECT) */ { // likewise for structors and members that haven't been reified
+		ObjectType *objectType = (ObjectType *)type;
+		StructorList *structorLists[] = {&(objectType->instructorList), &(objectType->outstructorList)};
+		for (unsigned int i=0; i<2; i++) {
+			const vector<pair<Type *, Tree *> > &structors = structorLists[i]->structors;
+			words.push_back(structors.size());
+			for (unsigned int j=0; j<structors.size(); j++) {
+				words.push_back(typeRef(structors[j].first));
+				words.push_back(treeRef(structors[j].second));
+			}
+		}
+		const map<string, pair<Type *, Tree *> > &memberMap = objectType->memberList.memberMap;
+		words.push_back(memberMap.size());
+		for (map<string, pair<Type *, Tree *> >::const_iterator iter = memberMap.begin(); iter != memberMap.end(); iter++) {
+			const string &name = iter->first;
+			words.push_back(name.size());
+			for (unsigned int i=0; i<name.size(); i+=sizeof(uint32_t)) {
+				uint32_t word = 0;
+				memcpy(&word, name.data() + i, (name.size() - i < sizeof(uint32_t)) ? name.size() - i : sizeof(uint32_t));
+				words.push_back(word);
+			}
+			words.push_back(typeRef(iter->second.first));
+			words.push_back(treeRef(iter->second.second));
+		}
+	}
+}
+
+// interface summary loading
+
+// reads the next word of a type record, flagging reads past the end of the record as invalid
+uint32_t recordWord(const uint32_t *words, uint32_t &pos, uint32_t end, bool &valid) {
+	if (pos >= end) {
+		valid = false;
+		return 0;
+	}
+	return words[pos++];
+}
+
+// checks that the names used in the file still bind as they did when the given (already mapped) summary was written, and if so,
+// rebuilds the summary's types and the statuses that it records (into seeds); returns false if the summary doesn't apply
+// note: nodes holds the file's own nodes followed by the summary's (resolved) foreign nodes
+bool rebuildInterface(const InterfaceHeader *header, const vector<Tree *> &nodes, SymbolTree *stRoot, const map<Tree *, int> &derivedNodes,
+		vector<pair<Tree *, TypeStatus> > &seeds) {
+	const InterfaceDependency *dependencies = (const InterfaceDependency *)(header + 1);
+	const InterfaceForeignNode *foreignNodes = (const InterfaceForeignNode *)(dependencies + header->numDependencies);
+	const InterfaceName *names = (const InterfaceName *)(foreignNodes + header->numForeignNodes);
+	const InterfaceEntry *entries = (const InterfaceEntry *)(names + header->numNames);
+	const uint32_t *offsets = (const uint32_t *)(entries + header->numEntries);
+	const uint32_t *words = offsets + header->numTypes;
+	bool valid = true;
+	// check the bindings first; this is where a summary written by a compilation with conflicting definitions fails
+	for (uint32_t i=0; i<header->numNames && valid; i++) {
+		const InterfaceName &name = names[i];
+		Tree *tree = cacheLink(nodes, name.tree, valid);
+		if (tree == NULL || tree->t.tokenType != TOKEN_ID) {
+			valid = false;
+			break;
+		}
+		SymbolTree *binding = stRoot->children.find(tree->t.atom);
+		if (name.binding == INTERFACE_BINDING_ABSENT) {
+			valid = (binding == NULL);
+		} else if (name.binding == INTERFACE_BINDING_STD) {
+			valid = (binding != NULL && binding->kind == KIND_STD);
+		} else if (name.binding == INTERFACE_BINDING_LOCAL) {
+			Tree *site = cacheLink(nodes, name.site, valid);
+			valid = valid && (site != NULL && binding != NULL && binding->defSite == site);
+		} else {
+			valid = false;
+		}
+	}
+	if (!valid) {
+		return false;
+	}
+	// allocate the types up front, so that the records can refer to each other (and to themselves) in any order
+	vector<Type *> globals;
+	getGlobalTypes(globals);
+	vector<Type *> types(header->numTypes, (Type *)NULL);
+	for (uint32_t i=0; i<header->numTypes && valid; i++) {
+		uint32_t pos = offsets[i];
+		uint32_t end = (i+1 < header->numTypes) ? offsets[i+1] : header->numWords;
+		if (end > header->numWords) {
+			valid = false;
+			break;
+		}
+		uint32_t tag = recordWord(words, pos, end, valid);
+		if (tag == INTERFACE_TYPE_GLOBAL) {
+			types[i] = cacheLink(globals, recordWord(words, pos, end, valid), valid);
+		} else if (tag == INTERFACE_TYPE_INTERNED) {
+			uint32_t kind = recordWord(words, pos, end, valid);
+			uint32_t suffix = recordWord(words, pos, end, valid);
+			uint32_t depth = recordWord(words, pos, end, valid);
+			if (valid && kind < NUM_STD_KINDS && suffix < NUM_SUFFIXES && depth < STD_TYPE_INTERN_DEPTH) {
+				types[i] = internStdType(kind, suffix, depth);
+			}
+		} else if (tag == INTERFACE_TYPE_STD) {
+			types[i] = new StdType(STD_NULL);
+		} else if (tag == INTERFACE_TYPE_LIST) {
+			types[i] = new TypeList();
+		} else if (tag == INTERFACE_TYPE_FILTER) {
+			types[i] = new FilterType((Tree *)NULL);
+		} else if (tag == INTERFACE_TYPE_OBJECT) {
+			types[i] = new ObjectType();
+		}
+		if (types[i] == NULL) {
+			valid = false;
+		}
+	}
+	// fill in the by-value records
+	for (uint32_t i=0; i<header->numTypes && valid; i++) {
+		uint32_t pos = offsets[i];
+		uint32_t end = (i+1 < header->numTypes) ? offsets[i+1] : header->numWords;
+		uint32_t tag = recordWord(words, pos, end, valid);
+		if (tag == INTERFACE_TYPE_GLOBAL || tag == INTERFACE_TYPE_INTERNED) {
+			continue;
+		}
+		Type *type = types[i];
+		type->suffix = recordWord(words, pos, end, valid);
+		type->depth = recordWord(words, pos, end, valid);
+		type->offsetExp = cacheLink(nodes, recordWord(words, pos, end, valid), valid);
+		uint32_t flags = recordWord(words, pos, end, valid);
+		type->referensible = ((flags & INTERFACE_TYPE_REFERENSIBLE) != 0);
+		type->instantiable = ((flags & INTERFACE_TYPE_INSTANTIABLE) != 0);
+		if (type->suffix < 0 || type->suffix >= NUM_SUFFIXES) {
+			valid = false;
+		}
+		if (tag == INTERFACE_TYPE_STD) {
+			uint32_t kind = recordWord(words, pos, end, valid);
+			((StdType *)type)->kind = kind;
+			if (kind >= NUM_STD_KINDS) {
+				valid = false;
+			}
+		} else if (tag == INTERFACE_TYPE_LIST) {
+			vector<Type *> &list = ((TypeList *)type)->list;
+			list.clear();
+			uint32_t length = recordWord(words, pos, end, valid);
+			for (uint32_t j=0; j<length && valid; j++) {
+				Type *element = cacheLink(types, recordWord(words, pos, end, valid), valid);
+				if (element == NULL) {
+					valid = false;
+				}
+				list.push_back(element);
+			}
+		} else if (tag == INTERFACE_TYPE_FILTER) {
+			FilterType *filterType = (FilterType *)type;
+			Type *from = cacheLink(types, recordWord(words, pos, end, valid), valid);
+			Type *to = cacheLink(types, recordWord(words, pos, end, valid), valid);
+			if ((from != NULL && from->category != CATEGORY_TYPELIST && from != errType()) || (to != NULL && to->category != CATEGORY_TYPELIST && to != errType())) {
+				valid = false;
+			}
+			filterType->fromInternal = (TypeList *)from;
+			filterType->toInternal = (TypeList *)to;
+			filterType->defSite = cacheLink(nodes, recordWord(words, pos, end, valid), valid);
+			filterType->inType = cacheLink(types, recordWord(words, pos, end, valid), valid);
+		} else /* if (tag == INTERFACE_TYPE_OBJECT) */ {
+			ObjectType *objectType = (ObjectType *)type;
+			StructorList *structorLists[] = {&(objectType->instructorList), &(objectType->outstructorList)};
+			for (unsigned int j=0; j<2; j++) {
+				uint32_t numStructors = recordWord(words, pos, end, valid);
+				for (uint32_t k=0; k<numStructors && valid; k++) {
+					Type *structorType = cacheLink(types, recordWord(words, pos, end, valid), valid);
+					Tree *structorTree = cacheLink(nodes, recordWord(words, pos, end, valid), valid);
+					if (structorType == NULL && structorTree == NULL) { // a structor is either reified or thunked
+						valid = false;
+					}
+					structorLists[j]->structors.push_back(make_pair(structorType, structorTree));
+				}
+			}
+			uint32_t numMembers = recordWord(words, pos, end, valid);
+			for (uint32_t j=0; j<numMembers && valid; j++) {
+				uint32_t nameLength = recordWord(words, pos, end, valid);
+				if (nameLength > (end - pos) * sizeof(uint32_t)) {
+					valid = false;
+					break;
+				}
+				string name((const char *)(words + pos), nameLength);
+				pos += (nameLength + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+				Type *memberType = cacheLink(types, recordWord(words, pos, end, valid), valid);
+				Tree *memberTree = cacheLink(nodes, recordWord(words, pos, end, valid), valid);
+				if (memberType == NULL && memberTree == NULL) { // as with structors
+					valid = false;
+				}
+				objectType->memberList.memberMap.insert(make_pair(name, make_pair(memberType, memberTree)));
+			}
+		}
+		if (pos != end) { // if there's anything left over, the record is malformed
+			valid = false;
+		}
+	}
+	// finally, check that the recorded statuses belong to the file's nodes, and collect the ones for the nodes that haven't been derived yet
+	// note: if anything turned out to be malformed, the types allocated above are simply dropped
+	for (uint32_t i=0; i<header->numEntries && valid; i++) {
+		const InterfaceEntry &entry = entries[i];
+		Tree *tree = (entry.tree < header->numNodes) ? cacheLink(nodes, entry.tree, valid) : NULL;
+		Type *type = cacheLink(types, entry.type, valid);
+		Type *retType = cacheLink(types, entry.retType, valid);
+		map<Tree *, int>::const_iterator derivedFind = derivedNodes.find(tree);
+		if (!valid || tree == NULL || type == NULL || derivedFind == derivedNodes.end() || derivedFind->second != (int)entry.kind || type->offsetKind() != (int)entry.offsetKind) {
+			valid = false;
+			break;
+		}
+		if (tree->status.type != NULL) { // if the node was already derived (while resolving an import of it), keep that status
+			continue;
+		}
+		seeds.push_back(make_pair(tree, TypeStatus(type, retType)));
+	}
+	return valid;
+}
+
+// maps in the given file's interface summary and rebuilds the statuses that it records (into seeds), if it applies to this compilation
+// as far as the file itself goes; the files that it depends on are logged in dependencies
+bool loadInterface(const vector<InterfaceFile> &files, uint32_t file, SymbolTree *stRoot, const map<Tree *, int> &derivedNodes,
+		vector<pair<Tree *, TypeStatus> > &seeds, vector<uint32_t> &dependencies) {
+	SourceBuffer *in = inFiles()[files[file].program->t.fileIndex];
+	uint64_t sourceHash = files[file].key.sourceHash;
+	size_t size;
+	const void *mapping = mapCacheEntry(cacheFileName(sourceHash, INTERFACE_FILE_EXTENSION), sizeof(InterfaceHeader), size);
+	if (mapping == NULL) {
+		return false;
+	}
+	InterfaceHeader expected;
+	initCacheHeader(expected, INTERFACE_MAGIC, in, sourceHash);
+	const InterfaceHeader *header = (const InterfaceHeader *)mapping;
+	bool retVal = false;
+	if (matchesCacheHeader(*header, expected) && size == sizeof(InterfaceHeader) + (size_t)header->numDependencies * sizeof(InterfaceDependency) +
+			(size_t)header->numForeignNodes * sizeof(InterfaceForeignNode) + (size_t)header->numNames * sizeof(InterfaceName) +
+			(size_t)header->numEntries * sizeof(InterfaceEntry) + ((size_t)header->numTypes + header->numWords) * sizeof(uint32_t) && matchesCachePayload(header, size) &&
+			files[file].nodes.size() == header->numNodes) {
+		retVal = true;
+		// find the dependencies among the compilation's other files; each has to be there exactly once, with the contents that it had when the summary was written
+		const InterfaceDependency *fileDependencies = (const InterfaceDependency *)(header + 1);
+		for (uint32_t i=0; i<header->numDependencies && retVal; i++) {
+			const InterfaceDependency &dependency = fileDependencies[i];
+			uint32_t match = INTERFACE_NULL_INDEX;
+			for (uint32_t j=0; j<files.size(); j++) {
+				const InterfaceDependency &key = files[j].key;
+				if (j != file && key.sourceHash == dependency.sourceHash && key.sourceCheck == dependency.sourceCheck &&
+						key.sourceSize == dependency.sourceSize && key.numNodes == dependency.numNodes) {
+					retVal = (match == INTERFACE_NULL_INDEX);
+					match = j;
+				}
+			}
+			retVal = retVal && (match != INTERFACE_NULL_INDEX);
+			if (retVal) {
+				dependencies.push_back(match);
+			}
+		}
+		// resolve the foreign nodes, appending them to the file's own
+		vector<Tree *> nodes;
+		if (retVal) {
+			nodes = files[file].nodes;
+			const InterfaceForeignNode *foreignNodes = (const InterfaceForeignNode *)(fileDependencies + header->numDependencies);
+			for (uint32_t i=0; i<header->numForeignNodes && retVal; i++) {
+				const InterfaceForeignNode &foreignNode = foreignNodes[i];
+				retVal = (foreignNode.dependency < dependencies.size() && foreignNode.node < files[dependencies[foreignNode.dependency]].nodes.size());
+				if (retVal) {
+					nodes.push_back(files[dependencies[foreignNode.dependency]].nodes[foreignNode.node]);
+				}
+			}
+		}
+		retVal = retVal && rebuildInterface(header, nodes, stRoot, derivedNodes, seeds);
+	}
+	munmap((void *)mapping, size);
+	return retVal;
+}
+
+unsigned int loadInterfaces(Tree *treeRoot, SymbolTree *stRoot, vector<pair<Tree *, TypeStatus> > &seeds, vector<bool> &loaded) {
+	loaded.assign(inFiles().size(), false);
+	map<Tree *, int> derivedNodes;
+	set<SymbolTree *> visited;
+	getDerivedNodes(stRoot, derivedNodes, visited);
+	vector<InterfaceFile> files;
+	getInterfaceFiles(treeRoot, files);
+	// rebuild the summaries that apply as far as their own files go
+	vector<vector<pair<Tree *, TypeStatus> > > fileSeeds(files.size());
+	vector<vector<uint32_t> > fileDependencies(files.size());
+	vector<bool> applies(files.size(), false);
+	for (uint32_t i=0; i<files.size(); i++) {
+		applies[i] = (files[i].program->t.fileIndex < loaded.size() && loadInterface(files, i, stRoot, derivedNodes, fileSeeds[i], fileDependencies[i]));
+	}
+	// a summary only applies if the summaries of all of its dependencies do as well (since their types were derived along with its own), so drop the ones that
+	// depend on a file whose summary doesn't apply, until there are none left
+	for (bool dropped = true; dropped;) {
+		dropped = false;
+		for (uint32_t i=0; i<files.size(); i++) {
+			for (uint32_t j=0; j<fileDependencies[i].size() && applies[i]; j++) {
+				if (!applies[fileDependencies[i][j]]) {
+					applies[i] = false;
+					dropped = true;
+				}
+			}
+		}
+	}
+	// seed the statuses of the rest
+	unsigned int numLoaded = 0;
+	for (uint32_t i=0; i<files.size(); i++) {
+		if (applies[i]) {
+			for (unsigned int j=0; j<fileSeeds[i].size(); j++) {
+				fileSeeds[i][j].first->status = fileSeeds[i][j].second;
+				seeds.push_back(fileSeeds[i][j]);
+			}
+			loaded[files[i].program->t.fileIndex] = true;
+			numLoaded++;
+		}
+	}
+	return numLoaded;
+}
+
+// interface summary storing
+
+// writes out the given file's interface summary, unless some Type can't be represented; the summary records the statuses of all of the nodes that semSt() derives,
+// along with how every name used in the file was bound in the root scope and the other files that those bindings (and the types) refer to
+bool storeInterface(const vector<InterfaceFile> &files, uint32_t file, const map<Tree *, pair<uint32_t, uint32_t> > &treeIndices, const map<Tree *, int> &derivedNodes,
+		SymbolTree *stRoot) {
+	SourceBuffer *in = inFiles()[files[file].program->t.fileIndex];
+	const vector<Tree *> &order = files[file].nodes;
+	InterfaceWriter writer(treeIndices, file, order.size());
+	vector<InterfaceName> names;
+	vector<InterfaceEntry> entries;
+	vector<bool> seenAtoms;
+	for (uint32_t i=0; i<order.size(); i++) {
+		Tree *cur = order[i];
+		if (cur->t.tokenType == TOKEN_ID) { // log the binding of the name, if it's the first use of it
+			Atom atom = cur->t.atom;
+			if (atom >= seenAtoms.size()) {
+				seenAtoms.resize(atom+1, false);
+			}
+			if (!seenAtoms[atom]) {
+				seenAtoms[atom] = true;
+				InterfaceName name;
+				name.tree = i;
+				name.site = INTERFACE_NULL_INDEX;
+				SymbolTree *binding = stRoot->children.find(atom);
+				if (binding == NULL) {
+					name.binding = INTERFACE_BINDING_ABSENT;
+				} else if (binding->kind == KIND_STD) {
+					name.binding = INTERFACE_BINDING_STD;
+				} else {
+					name.binding = INTERFACE_BINDING_LOCAL;
+					name.site = writer.treeRef(binding->defSite); // (if it's another file's definition, the file's typing depends on that file)
+				}
+				names.push_back(name);
+			}
+		}
+		map<Tree *, int>::const_iterator derivedFind = derivedNodes.find(cur);
+		if (derivedFind != derivedNodes.end()) { // if it's a node that semSt() derives, log its status
+			if (cur->status.type == NULL) {
+				return false;
+			}
+			InterfaceEntry entry;
+			entry.tree = i;
+			entry.kind = derivedFind->second;
+			entry.offsetKind = cur->status.type->offsetKind();
+			entry.type = writer.typeRef(cur->status.type);
+			entry.retType = writer.typeRef(cur->status.retType);
+			entries.push_back(entry);
+		}
+	}
+	writer.flush();
+	if (!(writer.valid)) {
+		return false;
+	}
+	vector<InterfaceDependency> dependencies;
+	for (unsigned int i=0; i<writer.dependencies.size(); i++) {
+		dependencies.push_back(files[writer.dependencies[i]].key);
+	}
+	InterfaceHeader header;
+	uint64_t sourceHash = files[file].key.sourceHash;
+	initCacheHeader(header, INTERFACE_MAGIC, in, sourceHash);
+	header.numNodes = order.size();
+	header.numDependencies = dependencies.size();
+	header.numForeignNodes = writer.foreignNodes.size();
+	header.numNames = names.size();
+	header.numEntries = entries.size();
+	header.numTypes = writer.offsets.size();
+	header.numWords = writer.words.size();
+	vector<pair<const void *, size_t> > chunks;
+	chunks.push_back(make_pair((const void *)&header, sizeof(header)));
+	if (!dependencies.empty()) {
+		chunks.push_back(make_pair((const void *)&(dependencies[0]), dependencies.size() * sizeof(InterfaceDependency)));
+		chunks.push_back(make_pair((const void *)&(writer.foreignNodes[0]), writer.foreignNodes.size() * sizeof(InterfaceForeignNode)));
+	}
+	if (!names.empty()) {
+		chunks.push_back(make_pair((const void *)&(names[0]), names.size() * sizeof(InterfaceName)));
+	}
+	if (!entries.empty()) {
+		chunks.push_back(make_pair((const void *)&(entries[0]), entries.size() * sizeof(InterfaceEntry)));
+	}
+	if (!(writer.offsets.empty())) {
+		chunks.push_back(make_pair((const void *)&(writer.offsets[0]), writer.offsets.size() * sizeof(uint32_t)));
+		chunks.push_back(make_pair((const void *)&(writer.words[0]), writer.words.size() * sizeof(uint32_t)));
+	}
+	header.payloadCheck = checkPayload(chunks);
+	return writeCacheEntry(cacheFileName(sourceHash, INTERFACE_FILE_EXTENSION), chunks);
+}
+
+void storeInterfaces(Tree *treeRoot, SymbolTree *stRoot, const vector<bool> &loaded) {
+	map<Tree *, int> derivedNodes;
+	set<SymbolTree *> visited;
+	getDerivedNodes(stRoot, derivedNodes, visited);
+	vector<InterfaceFile> files;
+	getInterfaceFiles(treeRoot, files);
+	map<Tree *, pair<uint32_t, uint32_t> > treeIndices;
+	for (uint32_t i=0; i<files.size(); i++) {
+		for (uint32_t j=0; j<files[i].nodes.size(); j++) {
+			treeIndices.insert(make_pair(files[i].nodes[j], make_pair(i, j)));
+		}
+	}
+	for (uint32_t i=0; i<files.size(); i++) {
+		unsigned int fileIndex = files[i].program->t.fileIndex;
+		if (fileIndex < loaded.size() && loaded[fileIndex]) { // if the file's summary is already in the cache, there's nothing new to write
+			continue;
+		}
+		storeInterface(files, i, treeIndices, derivedNodes, stRoot);
+	}
+}
@@ -0,0 +1,189 @@
+#ifndef _CACHE_H_
+#define _CACHE_H_
+
+#include "globalDefs.h"
+#include "constantDefs.h"
+#include "driver.h"
+
+#include "lexer.h"
+#include "parser.h"
+#include "ast.h"
+#include "semmer.h"
+
+// on-disk parse cache file layout: a ParseCacheHeader, then numNodes ParseCacheNodes (in preorder), then numAsts ParseCacheAsts,
+// then arenaSize bytes of the SourceBuffer's arena
+
+// ParseCacheNode flags; a node's links are implied by its position in the preorder sequence
+#define PARSE_CACHE_HAS_CHILD 0x1 // the next node in the sequence is this node's first child
+#define PARSE_CACHE_HAS_NEXT 0x2 // the node after this node's subtree is this node's next sibling
+#define PARSE_CACHE_LINKS_BACK 0x4 // the node's back pointer is set to its previous sibling
+#define PARSE_CACHE_LINKS_PARENT 0x8 // the node's parent pointer is set to its parent
+
+class ParseCacheHeader {
+	public:
+		// data members
+		char magic[PARSE_CACHE_MAGIC_LENGTH];
+		char version[PARSE_CACHE_VERSION_LENGTH]; // the version string and stamp of the compiler that wrote the file
+		uint64_t sourceHash; // the content hash of the source file (the entry's key)
+		uint64_t sourceCheck; // an independent hash of the source file's contents (see checkBytes())
+		uint64_t payloadCheck; // the same hash of the records following this header
+		uint32_t sourceSize; // the length of the source file, in bytes
+		uint32_t tabWidth; // the tab modulus that the column numbers were computed with
+		uint32_t numNodes;
+		uint32_t numAsts;
+		uint32_t arenaSize;
+};
+
+class ParseCacheNode {
+	public:
+		// data members
+		uint16_t tokenType;
+		uint16_t flags;
+		uint32_t offset;
+		uint32_t length;
+		int32_t row;
+		int32_t col;
+		uint32_t ast; // the index of the node's lowered form (PARSE_CACHE_NULL_INDEX if it doesn't have one)
+};
+
+class ParseCacheAst {
+	public:
+		// data members
+		uint32_t kind;
+		// the indices of the Tree nodes that the Ast refers to (PARSE_CACHE_NULL_INDEX for NULL links)
+		uint32_t tree;
+		uint32_t site;
+		uint32_t op;
+		// the indices of the linked Ast nodes (PARSE_CACHE_NULL_INDEX for NULL links)
+		uint32_t left;
+		uint32_t right;
+		uint32_t next;
+};
+
+// interface summary file layout: an InterfaceHeader, then numDependencies InterfaceDependencies, numForeignNodes InterfaceForeignNodes, numNames InterfaceNames,
+// numEntries InterfaceEntries, numTypes type record offsets (uint32_t indices into the words that follow), and then numWords uint32_t words of type records
+// tree references below numNodes are preorder indices into the file's parse tree, and the ones above that index the foreign nodes (INTERFACE_NULL_INDEX for NULL);
+// type references are indices into the type records
+
+// InterfaceName bindings
+#define INTERFACE_BINDING_ABSENT 0 // the name isn't bound in the root scope
+#define INTERFACE_BINDING_STD 1 // the name is bound to a standard node in the root scope
+#define INTERFACE_BINDING_LOCAL 2 // the name is bound to a node defined in the file itself or in one of its dependencies
+
+// type record tags; each record is its tag followed by the listed fields
+#define INTERFACE_TYPE_GLOBAL 0 // the index of one of the standard types (see getGlobalTypes())
+#define INTERFACE_TYPE_INTERNED 1 // kind, suffix, depth (see internStdType())
+#define INTERFACE_TYPE_STD 2 // base fields, kind
+#define INTERFACE_TYPE_LIST 3 // base fields, length, types
+#define INTERFACE_TYPE_FILTER 4 // base fields, from type, to type, defSite tree, inType type
+#define INTERFACE_TYPE_OBJECT 5 // base fields, instructor count, (type, tree) pairs, outstructor count, (type, tree) pairs, member count, (name length, name words, type, tree) tuples
+// the base fields are the suffix, depth, offsetExp tree, and flags
+
+// type record flags
+#define INTERFACE_TYPE_REFERENSIBLE 0x1
+#define INTERFACE_TYPE_INSTANTIABLE 0x2
+
+class InterfaceHeader {
+	public:
+		// data members
+		char magic[PARSE_CACHE_MAGIC_LENGTH];
+		char version[PARSE_CACHE_VERSION_LENGTH]; // as in ParseCacheHeader
+		uint64_t sourceHash;
+		uint64_t sourceCheck;
+		uint64_t payloadCheck;
+		uint32_t sourceSize;
+		uint32_t tabWidth;
+		uint32_t numNodes; // the number of nodes in the file's parse tree
+		uint32_t numDependencies;
+		uint32_t numForeignNodes;
+		uint32_t numNames;
+		uint32_t numEntries;
+		uint32_t numTypes;
+		uint32_t numWords;
+};
+
+// another source file that the summary refers to (through the names that bind to its definitions, or the types derived from them); the summary
+// only applies if the file is part of the compilation, unchanged, and has a summary that applies as well
+class InterfaceDependency {
+	public:
+		// data members
+		uint64_t sourceHash; // as in InterfaceHeader
+		uint64_t sourceCheck;
+		uint32_t sourceSize;
+		uint32_t numNodes;
+};
+
+// a node of one of the dependencies' parse trees
+class InterfaceForeignNode {
+	public:
+		// data members
+		uint32_t dependency;
+		uint32_t node; // the preorder index of the node in the dependency's parse tree
+};
+
+// how one of the identifiers used in the file was bound in the root scope when the summary was written; the summary only applies if they're all bound the same way
+class InterfaceName {
+	public:
+		// data members
+		uint32_t tree; // an ID token carrying the name
+		uint32_t binding;
+		uint32_t site; // the definition site of the binding (INTERFACE_BINDING_LOCAL only)
+};
+
+// the derived status of one of the file's Declaration, Instructor, or Outstructor nodes
+class InterfaceEntry {
+	public:
+		// data members
+		uint32_t tree; // the definition site
+		uint32_t kind; // the SymbolTree node kind
+		uint32_t offsetKind;
+		uint32_t type;
+		uint32_t retType;
+};
+
+// one of the compilation's source files, as the interface summaries see it
+class InterfaceFile {
+	public:
+		// data members
+		Tree *program;
+		vector<Tree *> nodes; // the file's parse tree, in preorder
+		InterfaceDependency key; // what a summary that depends on the file records about it
+};
+
+// flattens the Types reachable from a file's statuses into type records
+class InterfaceWriter {
+	public:
+		// data members
+		const map<Tree *, pair<uint32_t, uint32_t> > &treeIndices; // the (file, preorder index) of every node of the compilation's parse trees
+		uint32_t file; // the one being summarized
+		uint32_t numNodes;
+		vector<uint32_t> dependencies; // the files that the foreign nodes belong to
+		map<uint32_t, uint32_t> dependencyIndices;
+		vector<InterfaceForeignNode> foreignNodes;
+		map<Tree *, uint32_t> foreignIndices;
+		map<Type *, uint32_t> globalIndices;
+		map<Type *, uint32_t> typeIndices;
+		vector<Type *> types; // the referenced types, in index order
+		vector<uint32_t> offsets; // the offsets of the records written so far
+		vector<uint32_t> words;
+		bool valid; // false if some Type couldn't be represented
+		// allocators/deallocators
+		InterfaceWriter(const map<Tree *, pair<uint32_t, uint32_t> > &treeIndices, uint32_t file, uint32_t numNodes);
+		~InterfaceWriter();
+		// core methods
+		uint32_t treeRef(Tree *tree);
+		uint32_t typeRef(Type *type);
+		void flush(); // writes the records of all of the types referenced so far (and of the ones that they reference)
+	private:
+		void writeType(Type *type);
+};
+
+uint64_t hashSource(const SourceBuffer *in); // covers the compiler version and the tab modulus as well as the file's contents
+string cacheFileName(uint64_t sourceHash, const char *extension);
+Tree *loadParseCache(unsigned int fileIndex, TreeArena &treeArena); // returns NULL if there's no usable cache entry for the file
+bool storeParseCache(unsigned int fileIndex, Tree *parseme); // returns false if the entry couldn't be written
+// seeds the statuses of the nodes of every file that has a usable interface summary (logging them in seeds, and the files in loaded); returns the number of files loaded
+unsigned int loadInterfaces(Tree *treeRoot, SymbolTree *stRoot, vector<pair<Tree *, TypeStatus> > &seeds, vector<bool> &loaded);
+void storeInterfaces(Tree *treeRoot, SymbolTree *stRoot, const vector<bool> &loaded); // writes summaries for the files that weren't loaded
+
+#endif
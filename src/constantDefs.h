@@ -15,17 +15,74 @@
 #define MAX_TAB_MODULUS 80
 #define TAB_MODULUS_DEFAULT 4
 
+#define MIN_NUM_JOBS 1
+#define MAX_NUM_JOBS 256
+#define NUM_JOBS_DEFAULT 1
+
+#define LEX_AHEAD_DEFAULT false
+
+#define PHASE_STATS_DEFAULT false
+#define JSON_STATS_DEFAULT false
+
+#define CACHE_DIR_DEFAULT NULL
+
 #define TOLERABLE_ERROR_LIMIT 256
 
 #define MAX_STRING_LENGTH (sizeof(char)*4096)
 #define MAX_INT_STRING_LENGTH 21
 
 #define STD_IN_FILE_NAME "<stdin>"
+#define SOURCE_READ_BLOCK_SIZE (1024*64)
 
 #define MAX_TOKEN_LENGTH 1024*128
+#define TOKEN_RING_SIZE 4096
+#define TOKEN_BATCH_SIZE 256
 #define ESCAPE_CHARACTER '\\'
 #define TOKEN_RAW_VECTOR INT_MAX
 
+#define TREE_ARENA_BLOCK_SIZE (1024*64)
+#define PARSER_STACK_SIZE 256
+
+#define PARSE_CACHE_MAGIC "ANIPARSE"
+#define PARSE_CACHE_MAGIC_LENGTH 8
+#define PARSE_CACHE_VERSION_LENGTH 64
+#define PARSE_CACHE_FILE_EXTENSION ".parse"
+#define PARSE_CACHE_NULL_INDEX UINT_MAX
+#define INTERFACE_MAGIC "ANIIFACE"
+#define INTERFACE_FILE_EXTENSION ".iface"
+#define INTERFACE_NULL_INDEX UINT_MAX
+
+#define SERVER_ENV_VAR "ANIC_SERVER"
+#define SERVER_MAGIC "ANISERVE"
+#define SERVER_MAGIC_LENGTH 8
+#define SERVER_BACKLOG 64
+#define SERVER_SOCKET_UMASK 0177
+#define SERVER_MAX_ARGS 65536
+#define SERVER_MAX_STRING_LENGTH (1024*1024)
+#define SERVER_STATUS_REJECTED (-1)
+#define SERVER_HANDLER_READY 'r'
+#define SERVER_HANDLER_FAILED 'f'
+
+#define ATOM_TABLE_INITIAL_SIZE 4096
+#define ATOM_CHUNK_SIZE 4096
+#define ATOM_MAX_CHUNKS 4096
+#define SYMBOL_SCOPE_INITIAL_SIZE 8
+#define BINDING_CACHE_INITIAL_SIZE 1024
+#define STD_TYPE_INTERN_DEPTH 8
+#define TYPE_RELATION_CACHE_INITIAL_SIZE 256
+#define SEMMER_WORKER_STACK_SIZE (1024*1024*64)
+#ifdef __SANITIZE_THREAD__
+#define OPTIMISTIC_READER __attribute__((no_sanitize_thread)) // readers whose results are validated afterwards (see SymbolScope::probe()), so their races are deliberate
+#else
+#define OPTIMISTIC_READER
+#endif
+
+#define OWNED_TYPES 0 // the kinds of nodes that a compilation keeps lists of (see allocNode())
+#define OWNED_SYMBOL_TREES 1
+#define OWNED_IR_TREES 2
+#define OWNED_TREES 3
+#define NUM_OWNED_LISTS 4
+
 #define STANDARD_LIBRARY_STRING "std"
 #define STANDARD_LIBRARY_FILE_INDEX UINT_MAX
 #define STANDARD_LIBRARY_FILE_NAME "<stdlib>"
@@ -42,6 +99,6 @@
 
 #define UNIQUE_ID_PREFIX "idLabel"
 
-#define VERBOSE(s) if (verboseOutput) {s}
+#define VERBOSE(s) if (verboseOutput()) {s}
 
 #endif
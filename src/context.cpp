@@ -0,0 +1,114 @@
+#include "context.h"
+
+#include "driver.h"
+#include "types.h"
+#include "semmer.h"
+#include "genner.h"
+#include "stats.h"
+
+// context-global variables
+
+__thread CompilerContext *compilerContext = NULL;
+__thread bool allocatingSharedNodes = false;
+
+// deletes every node in the given list; none of the nodes' destructors touch other nodes, so the order doesn't matter
+// (each delete unlinks the node from the list)
+template <class T> void freeOwnedNodes(NodeLink &head) {
+	for (NodeLink *link = head.next; link != &head; link = head.next) {
+		T *node = (T *)(link + 1);
+		delete node;
+	}
+}
+
+// CompilerContext functions
+CompilerContext::CompilerContext(ostream &outStream, ostream &errStream) : optimizationLevel(DEFAULT_OPTIMIZATION_LEVEL), verboseOutput(VERBOSE_OUTPUT_DEFAULT),
+	silentMode(SILENT_MODE_DEFAULT), codedOutput(CODED_OUTPUT_DEFAULT), tabModulus(TAB_MODULUS_DEFAULT), eventuallyGiveUp(EVENTUALLY_GIVE_UP_DEFAULT),
+	numJobs(NUM_JOBS_DEFAULT), lexAhead(LEX_AHEAD_DEFAULT), phaseStats(PHASE_STATS_DEFAULT), jsonStats(JSON_STATS_DEFAULT), cacheDir(CACHE_DIR_DEFAULT),
+	outStream(&outStream), errStream(&errStream), driverErrorCode(0), semmerErrorCode(0), semmerMode(SEMMER_SEQUENTIAL), gennerErrorCode(0), nextUniqueInt(0),
+	stdTypes(), stdLib(NULL), warmDefaultDefs(NULL), bindingCache(new BindingCache()), scopeInsertLog(NULL), declarationReentered(false),
+	semmerTaskBase(0), semmerOutOfOrder(0), semmerErrorsLogged(0), scopeVersion(0), statusLogs(NULL), typeRelationCache(new TypeRelationCache()),
+	promotionTypes(new ObjectType *volatile[NUM_PROMOTIONS*NUM_SUFFIXES*STD_TYPE_INTERN_DEPTH]),
+	statCounters(new unsigned long[NUM_STATS]), phaseStatsTable(new PhaseStats[NUM_PHASES]) {
+	pthread_mutex_init(&statusClaimLock, NULL);
+	pthread_cond_init(&statusClaimPublished, NULL);
+	pthread_mutex_init(&scopeWriteLock, NULL);
+	pthread_mutex_init(&nodeLock, NULL);
+	for (unsigned int i=0; i < NUM_PROMOTIONS*NUM_SUFFIXES*STD_TYPE_INTERN_DEPTH; i++) {
+		promotionTypes[i] = NULL;
+	}
+	for (unsigned int i=0; i < NUM_STATS; i++) {
+		statCounters[i] = 0;
+	}
+	for (unsigned int i=0; i < NUM_OWNED_LISTS; i++) {
+		ownedNodes[i].prev = ownedNodes[i].next = &(ownedNodes[i]);
+	}
+}
+CompilerContext::~CompilerContext() {
+	// free the nodes that the compilation still owns
+	CompilerContext *callerContext = compilerContext;
+	compilerContext = this;
+	freeOwnedNodes<Type>(ownedNodes[OWNED_TYPES]);
+	freeOwnedNodes<SymbolTree>(ownedNodes[OWNED_SYMBOL_TREES]);
+	freeOwnedNodes<IRTree>(ownedNodes[OWNED_IR_TREES]);
+	for (NodeLink *link = ownedNodes[OWNED_TREES].next; link != &(ownedNodes[OWNED_TREES]); link = link->next) { // pool size nodes own their depth lists
+		Tree *tree = (Tree *)(link + 1);
+		if (tree->t.tokenType == TOKEN_RAW_VECTOR) {
+			delete (deque<unsigned int> *)(tree->next);
+		}
+	}
+	freeOwnedNodes<Tree>(ownedNodes[OWNED_TREES]);
+	compilerContext = callerContext;
+	for (unsigned int i=0; i < fileJobs.size(); i++) {
+		delete fileJobs[i];
+	}
+	for (unsigned int i=0; i < inFiles.size(); i++) {
+		delete inFiles[i];
+	}
+	while (statusLogs != NULL) {
+		StatusLog *next = statusLogs->nextLog;
+		delete statusLogs;
+		statusLogs = next;
+	}
+	delete bindingCache;
+	delete typeRelationCache;
+	delete[] promotionTypes;
+	delete[] statCounters;
+	delete[] phaseStatsTable;
+	pthread_mutex_destroy(&statusClaimLock);
+	pthread_cond_destroy(&statusClaimPublished);
+	pthread_mutex_destroy(&scopeWriteLock);
+	pthread_mutex_destroy(&nodeLock);
+}
+
+// per-compilation node ownership functions
+
+void *allocNode(unsigned int list, size_t size) {
+	NodeLink *link = (NodeLink *)::operator new(sizeof(NodeLink) + size);
+	if (compilerContext == NULL || allocatingSharedNodes) { // if no compilation is going to own the node, leave it unlinked
+		link->prev = link->next = NULL;
+	} else {
+		NodeLink *head = &(compilerContext->ownedNodes[list]);
+		pthread_mutex_lock(&(compilerContext->nodeLock));
+		link->prev = head;
+		link->next = head->next;
+		head->next->prev = link;
+		head->next = link;
+		pthread_mutex_unlock(&(compilerContext->nodeLock));
+	}
+	return (link + 1);
+}
+void freeNode(void *node) {
+	if (node == NULL) {
+		return;
+	}
+	NodeLink *link = ((NodeLink *)node) - 1;
+	if (compilerContext != NULL) { // allocNode() relinks the list's first node, so the links are only read under the lock
+		pthread_mutex_lock(&(compilerContext->nodeLock));
+		if (link->prev != NULL) { // if the compilation owns the node, unlink it from the compilation's list
+			link->prev->next = link->next;
+			link->next->prev = link->prev;
+		}
+		pthread_mutex_unlock(&(compilerContext->nodeLock));
+	}
+	::operator delete(link);
+}
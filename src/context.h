@@ -0,0 +1,191 @@
+#ifndef _CONTEXT_H_
+#define _CONTEXT_H_
+
+#include "globalDefs.h"
+#include "constantDefs.h"
+
+// note: only included by source files, the programs that set up compilations, and the headers whose default arguments name the standard types
+// (semmer.h and types.h), never by the library's header
+
+class BindingCache;
+class TypeRelationCache;
+class PhaseStats;
+class FileJob;
+class StatusLog;
+
+// links a heap-allocated node (a Type, SymbolTree, IRTree, or Tree) into its compilation's list of them; it sits just ahead of the node's memory
+class NodeLink {
+	public:
+		// data members
+		NodeLink *prev;
+		NodeLink *next; // both are NULL if the node is shared by all compilations
+};
+
+// the standard types and the nop IRTree; they're built once per process and shared by all compilations, which never mutate or delete them (see initSemmerGlobals())
+class StdTypes {
+	public:
+		// data members
+		Type *nullType;
+		Type *errType;
+		StdType *stdBoolType;
+		StdType *stdIntType;
+		StdType *stdFloatType;
+		StdType *stdCharType;
+		StdType *stdStringType;
+		StdType *stdBoolLitType;
+		StdType *inIntType;
+		StdType *inFloatType;
+		StdType *inCharType;
+		StdType *inStringType;
+		ObjectType *stringerType;
+		ObjectType *boolUnOpType;
+		ObjectType *intUnOpType;
+		ObjectType *boolBinOpType;
+		ObjectType *intBinOpType;
+		ObjectType *floatBinOpType;
+		ObjectType *boolCompOpType;
+		ObjectType *intCompOpType;
+		ObjectType *floatCompOpType;
+		ObjectType *charCompOpType;
+		ObjectType *stringCompOpType;
+		StdType *stdLibType;
+		IRTree *nopCode;
+};
+
+// the state of a single compilation; every thread working on a compilation points compilerContext at it, so that any number of
+// compilations can run at once in the same process (on separate threads)
+// note: the atom table and the standard types are shared by all compilations (they're thread-safe and never change meaning)
+// note: the members that most of the compiler reads are reached through the accessors below, which are named after the process-wide variables that they replaced
+class CompilerContext {
+	public:
+		// data members
+		// options
+		int optimizationLevel;
+		bool verboseOutput;
+		bool silentMode;
+		bool codedOutput;
+		int tabModulus;
+		bool eventuallyGiveUp;
+		int numJobs;
+		bool lexAhead;
+		bool phaseStats;
+		bool jsonStats;
+		const char *cacheDir; // the parse cache and interface summary directory; NULL if caching is disabled
+		// output streams (normally cout and cerr)
+		ostream *outStream;
+		ostream *errStream;
+		// inputs
+		vector<string> inFileNames; // source file name vector
+		vector<SourceBuffer *> inFiles; // source file buffer vector
+		vector<FileJob *> fileJobs; // the per-file lexing and parsing jobs, which own the files' parse trees
+		// error codes
+		int driverErrorCode;
+		int semmerErrorCode;
+		int semmerMode;
+		int gennerErrorCode;
+		unsigned int nextUniqueInt;
+		// standard types and nodes (see initSemmerGlobals())
+		StdTypes stdTypes; // a copy of the pointers to the shared standard types
+		SymbolTree *stdLib;
+		SymbolTree *warmDefaultDefs; // the default definitions built by warmSemmer(), if they haven't been used yet
+		// semmer state
+		BindingCache *bindingCache;
+		vector<unsigned int> *scopeInsertLog; // while imports are being resolved, the keys (Atoms) added to any SymbolScope; NULL otherwise
+		bool declarationReentered; // whether some derivation looked up a Declaration whose derivation was still in progress (see checkDeclarationReentry())
+		// parallel semmer state
+		unsigned int semmerTaskBase; // the number of tasks run by earlier parallel phases, so that task numbers keep increasing across phases
+		volatile unsigned int semmerOutOfOrder; // nonzero if some derivation in the parallel phases might have come out differently from the sequential semmer's (only accessed through __sync builtins while the workers run)
+		unsigned int semmerErrorsLogged; // the number of errors logged by the parallel phases
+		pthread_mutex_t statusClaimLock; // guards waiting on claims (and the tables below)
+		pthread_cond_t statusClaimPublished;
+		vector<volatile unsigned int *> statusClaimWaits; // the claim that each worker is blocked on (NULL if none), indexed by worker id
+		vector<unsigned int> semmerWorkerTasks; // the number of the task that each worker is running (0 if none), indexed by worker id
+		pthread_mutex_t scopeWriteLock; // serializes SymbolScope writes during parallel typing
+		volatile unsigned int scopeVersion; // odd while a SymbolScope is being written during parallel typing, so that lock-free readers can retry
+		vector<unsigned int *> retiredScopeKeys; // arrays that grow() replaced during parallel typing (which readers might still be probing)
+		vector<SymbolTree **> retiredScopeValues;
+		StatusLog *volatile statusLogs; // every log that the parallel phases allocated, linked through nextLog (the nodes that point at them don't own them)
+		vector<pair<SymbolTree *, SymbolTree *> > parallelFakeNodes; // the fake nodes attached during parallel typing (and their parents), in case it has to be redone
+		vector<pair<SymbolTree *, SymbolTree *> > semStTasks; // (node, parent) pairs, in the order in which semSt() first reaches the nodes
+		vector<Tree *> semPipesTasks;
+		// type state
+		TypeRelationCache *typeRelationCache;
+		ObjectType *volatile *promotionTypes; // retyped standard operator ObjectTypes, by promotion, suffix, and depth (see promotionSendable()); filled in lazily
+		// statistics
+		unsigned long *statCounters; // NUM_STATS of them
+		PhaseStats *phaseStatsTable; // NUM_PHASES of them
+		// owned nodes (see allocNode())
+		pthread_mutex_t nodeLock; // guards the lists below
+		NodeLink ownedNodes[NUM_OWNED_LISTS]; // the heads of the lists of the nodes of each kind that the compilation allocated and hasn't freed yet
+		// allocators/deallocators
+		CompilerContext(ostream &outStream, ostream &errStream);
+		~CompilerContext(); // frees everything that the compilation allocated, aside from the shared standard types
+};
+
+extern __thread CompilerContext *compilerContext; // the compilation that this thread is working on
+
+// accessors for the current compilation's context
+
+// options
+inline int &optimizationLevel() {return compilerContext->optimizationLevel;}
+inline bool &verboseOutput() {return compilerContext->verboseOutput;}
+inline bool &silentMode() {return compilerContext->silentMode;}
+inline bool &codedOutput() {return compilerContext->codedOutput;}
+inline int &tabModulus() {return compilerContext->tabModulus;}
+inline bool &eventuallyGiveUp() {return compilerContext->eventuallyGiveUp;}
+inline int &numJobs() {return compilerContext->numJobs;}
+inline bool &lexAhead() {return compilerContext->lexAhead;}
+inline bool &phaseStats() {return compilerContext->phaseStats;}
+inline bool &jsonStats() {return compilerContext->jsonStats;}
+inline const char *&cacheDir() {return compilerContext->cacheDir;}
+// output streams
+inline ostream &outStream() {return *(compilerContext->outStream);}
+inline ostream &errStream() {return *(compilerContext->errStream);}
+// inputs
+inline vector<string> &inFileNames() {return compilerContext->inFileNames;}
+inline vector<SourceBuffer *> &inFiles() {return compilerContext->inFiles;}
+// error codes
+inline int &driverErrorCode() {return compilerContext->driverErrorCode;}
+inline int &semmerErrorCode() {return compilerContext->semmerErrorCode;}
+inline int &semmerMode() {return compilerContext->semmerMode;}
+inline int &gennerErrorCode() {return compilerContext->gennerErrorCode;}
+// standard types and nodes
+inline Type *nullType() {return compilerContext->stdTypes.nullType;}
+inline Type *errType() {return compilerContext->stdTypes.errType;}
+inline StdType *stdBoolType() {return compilerContext->stdTypes.stdBoolType;}
+inline StdType *stdIntType() {return compilerContext->stdTypes.stdIntType;}
+inline StdType *stdFloatType() {return compilerContext->stdTypes.stdFloatType;}
+inline StdType *stdCharType() {return compilerContext->stdTypes.stdCharType;}
+inline StdType *stdStringType() {return compilerContext->stdTypes.stdStringType;}
+inline StdType *stdBoolLitType() {return compilerContext->stdTypes.stdBoolLitType;}
+inline StdType *inIntType() {return compilerContext->stdTypes.inIntType;}
+inline StdType *inFloatType() {return compilerContext->stdTypes.inFloatType;}
+inline StdType *inCharType() {return compilerContext->stdTypes.inCharType;}
+inline StdType *inStringType() {return compilerContext->stdTypes.inStringType;}
+inline ObjectType *stringerType() {return compilerContext->stdTypes.stringerType;}
+inline ObjectType *boolUnOpType() {return compilerContext->stdTypes.boolUnOpType;}
+inline ObjectType *intUnOpType() {return compilerContext->stdTypes.intUnOpType;}
+inline ObjectType *boolBinOpType() {return compilerContext->stdTypes.boolBinOpType;}
+inline ObjectType *intBinOpType() {return compilerContext->stdTypes.intBinOpType;}
+inline ObjectType *floatBinOpType() {return compilerContext->stdTypes.floatBinOpType;}
+inline ObjectType *boolCompOpType() {return compilerContext->stdTypes.boolCompOpType;}
+inline ObjectType *intCompOpType() {return compilerContext->stdTypes.intCompOpType;}
+inline ObjectType *floatCompOpType() {return compilerContext->stdTypes.floatCompOpType;}
+inline ObjectType *charCompOpType() {return compilerContext->stdTypes.charCompOpType;}
+inline ObjectType *stringCompOpType() {return compilerContext->stdTypes.stringCompOpType;}
+inline StdType *stdLibType() {return compilerContext->stdTypes.stdLibType;}
+inline IRTree *nopCode() {return compilerContext->stdTypes.nopCode;}
+inline SymbolTree *&stdLib() {return compilerContext->stdLib;}
+// statistics
+inline unsigned long *statCounters() {return compilerContext->statCounters;}
+inline PhaseStats *phaseStatsTable() {return compilerContext->phaseStatsTable;}
+
+// per-compilation node ownership
+
+// when set, the nodes that this thread allocates are shared by all compilations (see buildStdTypes()), so none of them owns the nodes
+extern __thread bool allocatingSharedNodes;
+
+void *allocNode(unsigned int list, size_t size); // allocates a node owned by the current compilation, linking it into the given one of its lists
+void freeNode(void *node); // frees a node allocated by allocNode(), unlinking it from its compilation's list
+
+#endif
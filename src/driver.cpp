@@ -9,33 +9,24 @@
 #include "parser.h"
 #include "semmer.h"
 #include "genner.h"
-
-// global variables
-
-int driverErrorCode;
-
-int optimizationLevel = DEFAULT_OPTIMIZATION_LEVEL;
-bool verboseOutput = VERBOSE_OUTPUT_DEFAULT;
-bool silentMode = SILENT_MODE_DEFAULT;
-bool codedOutput = CODED_OUTPUT_DEFAULT;
-int tabModulus = TAB_MODULUS_DEFAULT;
-bool eventuallyGiveUp = EVENTUALLY_GIVE_UP_DEFAULT;
-
-vector<string> inFileNames; // source file name vector
+#include "cache.h"
+#include "server.h"
+#include "stats.h"
+#include "libanic.h"
 
 // header print functions
 
 void printHeader(void) {
-	cerr << HEADER_LITERAL;
+	errStream() << HEADER_LITERAL;
 }
 void printUsage(void) {
-	cerr << USAGE_LITERAL;
+	errStream() << USAGE_LITERAL;
 }
 void printSeeAlso(void) {
-	cerr << SEE_ALSO_LITERAL;
+	errStream() << SEE_ALSO_LITERAL;
 }
 void printLink(void) {
-	cerr << LINK_LITERAL;
+	errStream() << LINK_LITERAL;
 }
 void printHelp(void) {
 	printHeader();
@@ -46,21 +37,21 @@ void printHelp(void) {
 
 // system termination functions
 
-void die(int errorCode) {
+int die(int errorCode) {
+	printStats();
 	if (errorCode) {
 		printError(COLOREXP(SET_TERM(RED_CODE)) << "fatal error code " << errorCode << " -- stop" << COLOREXP(SET_TERM(RESET_CODE)));
 	}
-	exit(errorCode);
+	return errorCode;
 }
-void die(void) {
-	die(0);
+int die(void) {
+	return die(0);
 }
 
 // core helper functions
 
-unsigned int nextUniqueInt = 0;
 unsigned int getUniqueInt() {
-	return (nextUniqueInt++);
+	return (compilerContext->nextUniqueInt++);
 }
 string getUniqueId() {
 	string acc(UNIQUE_ID_PREFIX);
@@ -68,9 +59,9 @@ string getUniqueId() {
 	return acc;
 }
 
-int containsString(vector<string> inFileNames, string &s) {
-	for (unsigned int i=0; i < inFileNames.size(); i++) { // scan the vector for matches
-		if (inFileNames[i] == s) { // if we have a match at this index, return true
+int containsString(vector<string> &v, string &s) {
+	for (unsigned int i=0; i < v.size(); i++) { // scan the vector for matches
+		if (v[i] == s) { // if we have a match at this index, return true
 			return 1;
 		}
 	}
@@ -78,22 +69,160 @@ int containsString(vector<string> inFileNames, string &s) {
 	return 0;
 }
 
-// main driver function
+// per-file lexing and parsing jobs
+
+FileJob::FileJob(unsigned int fileIndex, bool buffered) : fileIndex(fileIndex), lexeme(NULL), parseme(NULL), treeArena(new TreeArena()), cached(false), lexerErrorCode(0), parserErrorCode(0),
+	lexerErrorStream(buffered ? &lexerErrorBuffer : &errStream()), parserErrorStream(buffered ? &parserErrorBuffer : &errStream()) {}
+FileJob::~FileJob() {
+	delete lexeme;
+	delete treeArena;
+}
+void FileJob::flushLexerErrors() {
+	errStream() << lexerErrorBuffer.str();
+	lexerErrorBuffer.str("");
+}
+void FileJob::flushParserErrors() {
+	errStream() << parserErrorBuffer.str();
+	parserErrorBuffer.str("");
+}
+
+// loads the file's parse tree from the parse cache, if it has an entry there
+void cacheJob(FileJob *job) {
+	job->parseme = loadParseCache(job->fileIndex, *(job->treeArena));
+	job->cached = (job->parseme != NULL);
+}
+
+void lexJob(FileJob *job) {
+	if (job->cached) {
+		return;
+	}
+	job->lexeme = lex(inFiles()[job->fileIndex], job->fileIndex, *(job->lexerErrorStream));
+	job->lexerErrorCode = (job->lexeme == NULL) ? 1 : 0;
+}
+
+void parseJob(FileJob *job) {
+	if (job->cached) {
+		return;
+	}
+	VectorTokenSource lexeme(job->lexeme);
+	job->parserErrorCode = parse(lexeme, job->parseme, *(job->treeArena), job->fileIndex, *(job->parserErrorStream));
+	// the parse tree holds its own copies of the tokens, so they're no longer needed
+	delete job->lexeme;
+	job->lexeme = NULL;
+}
+
+// lexes and parses the file in one pass, streaming the tokens from the lexer into the parser
+void streamJob(FileJob *job) {
+	if (job->cached) {
+		return;
+	}
+	LexerTokenSource lexeme(inFiles()[job->fileIndex], job->fileIndex, *(job->lexerErrorStream));
+	job->parserErrorCode = parse(lexeme, job->parseme, *(job->treeArena), job->fileIndex, *(job->parserErrorStream));
+	// lex the rest of the file even if the parser stopped early, so that all of the lexer errors get reported
+	lexeme.drain();
+	job->lexerErrorCode = lexeme.lexer.lexerErrorCode;
+}
+
+JobPool::JobPool(vector<FileJob *> &jobs, void (*work)(FileJob *job)) : jobs(jobs), work(work), nextJob(0), context(compilerContext) {}
+JobPool::~JobPool() {}
+
+void *runWorker(void *arg) {
+	JobPool *pool = (JobPool *)arg;
+	compilerContext = pool->context;
+	for(;;) { // claim and run jobs until there are none left
+		unsigned int jobIndex = __sync_fetch_and_add(&(pool->nextJob), 1);
+		if (jobIndex >= pool->jobs.size()) {
+			break;
+		}
+		pool->work(pool->jobs[jobIndex]);
+	}
+	return NULL;
+}
+
+// runs work on all of the given jobs using numWorkers threads (including the calling one)
+void runJobs(vector<FileJob *> &jobs, void (*work)(FileJob *job), unsigned int numWorkers) {
+	JobPool pool(jobs, work);
+	vector<pthread_t> workers;
+	for (unsigned int i=1; i<numWorkers; i++) {
+		pthread_t worker;
+		if (pthread_create(&worker, NULL, runWorker, &pool) == 0) { // if we managed to spawn the worker, log it (otherwise, the remaining workers pick up the slack)
+			workers.push_back(worker);
+		}
+	}
+	runWorker(&pool);
+	for (unsigned int i=0; i<workers.size(); i++) {
+		pthread_join(workers[i], NULL);
+	}
+}
+
+LexAheadJob::LexAheadJob(vector<FileJob *> &jobs) : jobs(jobs), pipe(new TokenPipe(TOKEN_RING_SIZE)), context(compilerContext) {}
+LexAheadJob::~LexAheadJob() {
+	delete pipe;
+}
+
+// lexes all of the files in order into the lex-ahead pipe
+void *runLexAheadWorker(void *arg) {
+	LexAheadJob *lexAheadJob = (LexAheadJob *)arg;
+	compilerContext = lexAheadJob->context;
+	TokenRing batch(TOKEN_BATCH_SIZE);
+	for (unsigned int i=0; i<lexAheadJob->jobs.size(); i++) {
+		FileJob *job = lexAheadJob->jobs[i];
+		if (job->cached) { // cached files don't have any tokens in the pipe
+			continue;
+		}
+		Lexer lexer(inFiles()[job->fileIndex], job->fileIndex, *(job->lexerErrorStream));
+		bool moreInput;
+		do {
+			moreInput = lexer.scan(batch);
+			lexAheadJob->pipe->put(batch);
+		} while (moreInput);
+		job->lexerErrorCode = lexer.lexerErrorCode;
+		if (lexer.lexerErrorCode) { // if the lexer failed, it doesn't produce an end token, so stand one in to delimit this file
+			batch.push(Token(TOKEN_END));
+			lexAheadJob->pipe->put(batch);
+		}
+	}
+	return NULL;
+}
+
+// lexes the files on a separate thread while parsing them on the calling one, so that lexing of each file overlaps parsing of the previous one
+void runLexAhead(vector<FileJob *> &jobs) {
+	LexAheadJob lexAheadJob(jobs);
+	pthread_t worker;
+	if (pthread_create(&worker, NULL, runLexAheadWorker, &lexAheadJob) != 0) { // if we couldn't spawn the lexing thread, stream the files serially instead
+		for (unsigned int i=0; i<jobs.size(); i++) {
+			streamJob(jobs[i]);
+		}
+		return;
+	}
+	for (unsigned int i=0; i<jobs.size(); i++) {
+		FileJob *job = jobs[i];
+		if (job->cached) {
+			continue;
+		}
+		job->parserErrorCode = parse(*(lexAheadJob.pipe), job->parseme, *(job->treeArena), job->fileIndex, *(job->parserErrorStream));
+		// skip to the end of this file's tokens, and re-arm the pipe for the next file
+		lexAheadJob.pipe->rearm();
+	}
+	pthread_join(worker, NULL);
+}
 
-int main(int argc, char **argv) {
+// main driver functions
+
+// compiles as directed by the given command line (in the compile server, on behalf of a client)
+int compile(int argc, char **argv) {
 	
 	// initialize local error code
-	driverErrorCode = 0;
+	driverErrorCode() = 0;
 
 	// verify arguments
 	if (argc == 1) {
-		codedOutput = true; // enable coded output for the help text
+		codedOutput() = true; // enable coded output for the help text
 		printHelp();
-		die();
+		return die();
 	}
 	
 	// parse the command-line arguments
-	vector<ifstream *> inFiles; // source file vector
 	string outFileName(OUTPUT_FILE_DEFAULT); // initialize the output file name
 	// handled flags for each option
 	bool oHandled = false;
@@ -103,12 +232,16 @@ int main(int argc, char **argv) {
 	bool cHandled = false;
 	bool tHandled = false;
 	bool eHandled = false;
+	bool jHandled = false;
+	bool lHandled = false;
+	bool THandled = false;
+	bool CHandled = false;
 	for (int i=1; i<argc; i++) {
 		if (argv[i][0] == '-' && argv[i][1] != '\0') { // option argument
 			if (argv[i][1] == 'o' && argv[i][2] == '\0' && !oHandled) { // output file name
 				if (++i >= argc) { // jump to the next argument, test if it doesn't exist
 					printError("-o expected file name argument");
-					die();
+					return die();
 				}
 				outFileName = argv[i];
 				// flag this option as handled
@@ -116,24 +249,55 @@ int main(int argc, char **argv) {
 			} else if (argv[i][1] == 'p' && argv[i][2] == '\0' && !pHandled) { // optimization level option
 				if (++i >= argc) { // jump to the next argument, test if it doesn't exist
 					printError("-p expected optimization level argument");
-					die();
+					return die();
 				}
 				int n;
 				if (sscanf(argv[i], "%d", &n) < 1) { // unsuccessful attempt to extract a number out of the argument
 					printError("-p got illegal optimization level '" << argv[i] << "'");
-					die();
+					return die();
 				} else { // else attempt was successful
 					if (n >= MIN_OPTIMIZATION_LEVEL && n <= MAX_OPTIMIZATION_LEVEL) {
-						optimizationLevel = n;
+						optimizationLevel() = n;
 					} else {
 						printError("-p got out-of-bounds optimization level " << n);
-						die();
+						return die();
 					}
 				}
 				// flag this option as handled
 				pHandled = true;
+			} else if (argv[i][1] == 'j' && argv[i][2] == '\0' && !jHandled) { // parallel jobs option
+				if (++i >= argc) { // jump to the next argument, test if it doesn't exist
+					printError("-j expected number of jobs argument");
+					return die();
+				}
+				int n;
+				if (sscanf(argv[i], "%d", &n) < 1) { // unsuccessful attempt to extract a number out of the argument
+					printError("-j got illegal number of jobs '" << argv[i] << "'");
+					return die();
+				} else { // else attempt was successful
+					if (n >= MIN_NUM_JOBS && n <= MAX_NUM_JOBS) {
+						numJobs() = n;
+					} else {
+						printError("-j got out-of-bounds number of jobs " << n);
+						return die();
+					}
+				}
+				// flag this option as handled
+				jHandled = true;
+			} else if (argv[i][1] == 'l' && argv[i][2] == '\0' && !lHandled) { // lex-ahead option
+				lexAhead() = true;
+				// flag this option as handled
+				lHandled = true;
+			} else if (argv[i][1] == 'C' && argv[i][2] == '\0' && !CHandled) { // parse cache option
+				if (++i >= argc) { // jump to the next argument, test if it doesn't exist
+					printError("-C expected cache directory argument");
+					return die();
+				}
+				cacheDir() = argv[i];
+				// flag this option as handled
+				CHandled = true;
 			} else if (argv[i][1] == 'v' && argv[i][2] == '\0' && !vHandled && !sHandled) { // verbose output option
-				verboseOutput = true;
+				verboseOutput() = true;
 				VERBOSE (
 					printNotice("verbose output enabled");
 					print("");
@@ -141,134 +305,201 @@ int main(int argc, char **argv) {
 				// flag this option as handled
 				vHandled = true;
 			} else if (argv[i][1] == 's' && argv[i][2] == '\0' && !vHandled && !sHandled && !cHandled) { // silent compilation option
-				silentMode = true;
+				silentMode() = true;
 				// flag this option as handled
 				sHandled = true;
 			} else if (argv[i][1] == 'c' && argv[i][2] == '\0' && !cHandled && !sHandled) { // coded output option
-				codedOutput = true;
+				codedOutput() = true;
 				// flag this option as handled
 				cHandled = true;
 			} else if (argv[i][1] == 't' && argv[i][2] == '\0' && !tHandled) {
 				if (++i >= argc) { // jump to the next argument, test if it doesn't exist
 					printError("-t expected tab modulus argument");
-					die();
+					return die();
 				}
 				int n;
 				if (sscanf(argv[i], "%d", &n) < 1) { // unsuccessful attempt to extract a number out of the argument
 					printError("-t got illegal tab modulus '" << argv[i] << "'");
-					die();
+					return die();
 				} else { // else attempt was successful
 					if (n >= MIN_TAB_MODULUS && n <= MAX_TAB_MODULUS) {
-						tabModulus = n;
+						tabModulus() = n;
 					} else {
 						printError("-t got out-of-bounds tab modulus " << n);
-						die();
+						return die();
 					}
 				}
 				// flag this option as handled
 				tHandled = true;
 			} else if (argv[i][1] == 'e' && argv[i][2] == '\0' && !eHandled && !sHandled) {
-				eventuallyGiveUp = false;
+				eventuallyGiveUp() = false;
 				// flag this option as handled
 				eHandled = true;
+			} else if ((argv[i][1] == 'T' || argv[i][1] == 'J') && argv[i][2] == '\0' && !THandled) { // phase statistics option
+				phaseStats() = true;
+				jsonStats() = (argv[i][1] == 'J');
+				// flag this option as handled
+				THandled = true;
+			} else if (argv[i][1] == 'D' && argv[i][2] == '\0' && i == 1 && argc == 3) { // compile server option
+				return die(runServer(argv[++i]));
 			} else if (argv[i][1] == 'h' && argv[i][2] == '\0' && argc == 2) {
 				// test to see if a command interpreter is available
 				int systemRetVal = system(NULL);
 				if (!systemRetVal) {
 					printError("cannot display manual page: no command interpreter available");
-					die(1);
+					return die(1);
 				}
 				// invoke the program's man page
 				systemRetVal = system("man anic 2> /dev/null");
 				// test if displaying the manual page failed
 				if (systemRetVal) {
 					printError("cannot display manual page: executing manual driver failed");
-					die(1);
+					return die(1);
 				}
-				die(0);
+				return die(0);
 			} else {
 				printWarning("confused by option '" << argv[i] << "', skipping");
 			}
 
 		} else { // default case; assume regular file argument
 			string fileName = (argv[i][0] != '-') ? argv[i] : STD_IN_FILE_NAME;
-			if (containsString(inFileNames, fileName)) {
+			if (containsString(inFileNames(), fileName)) {
 				printWarning("including file '" << fileName << "' multiple times");
 				continue;
 			}
-			ifstream *inFile = (fileName == STD_IN_FILE_NAME) ? NULL : new ifstream(fileName.c_str()); // create a stream for this file
-			if (inFile != NULL && !inFile->good()) { // if file open failed
+			SourceBuffer *inFile = new SourceBuffer(); // create a buffer for this file
+			if (!inFile->load(fileName)) { // if file open failed
 				printError("cannot open input file '" << fileName << "'");
+				delete inFile;
 			} else { // else if file open succeeded, add the file and its name to the appropriate vectors
-				inFiles.push_back(inFile);
-				inFileNames.push_back(fileName);
+				inFiles().push_back(inFile);
+				inFileNames().push_back(fileName);
 			}
 		}
 	}
 
 	// terminate if there was an error or if there are no input files
-	if (driverErrorCode) {
-		die(1);
-	} else if (inFiles.empty()) {
+	if (driverErrorCode()) {
+		return die(1);
+	} else if (inFiles().empty()) {
 		printError("no input files");
-		die();
+		return die();
+	}
+
+	// set up the per-file lexing and parsing jobs
+	// (verbose mode traces the lexer and parser as they run, so it forces serial operation)
+	// (verbose mode runs lexing and parsing as separate phases rather than streaming them)
+	bool phased = verboseOutput();
+	unsigned int numWorkers = verboseOutput() ? 1 : ((unsigned int)numJobs() < inFiles().size() ? (unsigned int)numJobs() : inFiles().size());
+	vector<FileJob *> &jobs = compilerContext->fileJobs; // the context frees them (and so the parse trees) along with the rest of the compilation
+	for (unsigned int i=0; i<inFiles().size(); i++) {
+		jobs.push_back(new FileJob(i, !verboseOutput()));
 	}
 
 	// lex files
 	int lexerError = 0; // error flag
-	vector<vector<Token> *> lexemes; // per-file vector of the lexemes that the lexer is about to generate
-	for (unsigned int i=0; i<inFiles.size(); i++) {
-		// check file arguments
-		string fileName(inFileNames[i]);
-		if (fileName == "-") {
-			fileName = STD_IN_FILE_NAME;
-		}
+	int lexPhase = phased ? PHASE_LEX : PHASE_LEX_PARSE; // when streaming, the parsing happens here too
+	startPhase(lexPhase);
+	if (cacheDir() != NULL) { // if we're caching parse trees, first load the ones that are already in the cache
+		runJobs(jobs, cacheJob, numWorkers);
 		VERBOSE(
-			printNotice("lexing file \'" << fileName << "\'...");
+			for (unsigned int i=0; i<jobs.size(); i++) {
+				if (jobs[i]->cached) {
+					printNotice("loaded cached parse tree of file \'" << inFileNames()[i] << "\'");
+					print(""); // new line
+				}
+			}
 		)
-		// do the actual lexing
-		int thisLexError = 0; // one-shot error flag
-		vector<Token> *lexeme = lex(inFiles[i], i);
-		if (lexeme == NULL) { // if lexing failed with an error, log the error condition
-			thisLexError = 1;
-		} else { // else if lexing was successful, log the lexeme to the vector
-			lexemes.push_back(lexeme);
+	}
+	if (phased) { // if we're lexing and parsing as separate phases, lex all of the files up front
+		if (numWorkers > 1) { // if we're running in parallel, lex the files on the worker pool
+			runJobs(jobs, lexJob, numWorkers);
 		}
-		// print out the tokens if we're in verbose mode
-		VERBOSE(
-			if (!thisLexError) {
-				printNotice(COLOREXP(SET_TERM(GREEN_CODE)) << "successfully lexed file \'" << fileName << "\'" << COLOREXP(SET_TERM(RESET_CODE)));
-			} else {
-				printNotice(COLOREXP(SET_TERM(RED_CODE)) << "failed to lex file \'" << fileName << "\'" << COLOREXP(SET_TERM(RESET_CODE)));
+		for (unsigned int i=0; i<jobs.size(); i++) {
+			// check file arguments
+			string fileName(inFileNames()[i]);
+			if (fileName == "-") {
+				fileName = STD_IN_FILE_NAME;
+			}
+			VERBOSE(
+				printNotice("lexing file \'" << fileName << "\'...");
+			)
+			// do the actual lexing (or report the results of the parallel lexing)
+			if (numWorkers == 1) {
+				lexJob(jobs[i]);
+			}
+			jobs[i]->flushLexerErrors();
+			int thisLexError = jobs[i]->lexerErrorCode; // one-shot error flag
+			// print out the tokens if we're in verbose mode
+			VERBOSE(
+				if (!thisLexError) {
+					printNotice(COLOREXP(SET_TERM(GREEN_CODE)) << "successfully lexed file \'" << fileName << "\'" << COLOREXP(SET_TERM(RESET_CODE)));
+				} else {
+					printNotice(COLOREXP(SET_TERM(RED_CODE)) << "failed to lex file \'" << fileName << "\'" << COLOREXP(SET_TERM(RESET_CODE)));
+				}
+				print(""); // new line
+			)
+			// log the highest error code that occured
+			if (thisLexError > lexerError) {
+				lexerError = thisLexError;
+			}
+		}
+	} else { // else if we're not in verbose mode, stream the tokens of each file straight from the lexer into the parser
+		if (numWorkers > 1) { // if we're running in parallel, lex and parse the files on the worker pool
+			runJobs(jobs, streamJob, numWorkers);
+		} else if (lexAhead()) { // else if we're lexing ahead, lex the files on a separate thread
+			runLexAhead(jobs);
+		} else { // else if we're running serially, lex and parse the files in turn
+			for (unsigned int i=0; i<jobs.size(); i++) {
+				streamJob(jobs[i]);
+			}
+		}
+		// report the lexer errors in command line order
+		for (unsigned int i=0; i<jobs.size(); i++) {
+			jobs[i]->flushLexerErrors();
+			// log the highest error code that occured
+			if (jobs[i]->lexerErrorCode > lexerError) {
+				lexerError = jobs[i]->lexerErrorCode;
 			}
-			print(""); // new line
-		)
-		// log the highest error code that occured
-		if (thisLexError > lexerError) {
-			lexerError = thisLexError;
 		}
 	}
+	endPhase(lexPhase);
 	// now, check if lexing failed and if so, kill the system as appropriate
 	if (lexerError) {
-		die(1);
+		return die(1);
 	}
 
 	// parse lexemes
 	int parserError = 0; // error flag
 	Tree *treeRoot = NULL; // the root parseme of the parse tree
 	Tree *treeCur = NULL; // the tail of the linked list of parsemes
-	unsigned int fileIndex = 0; // current lexeme's file name index
-	for (vector<vector<Token> *>::iterator lexemeIter = lexemes.begin(); lexemeIter != lexemes.end(); lexemeIter++) {
-		VERBOSE(printNotice("parsing file \'" << inFileNames[fileIndex] << "\'...");)
-		// do the actual parsing
-		Tree *thisParseme;
-		int thisParseError = parse(*lexemeIter, thisParseme, fileIndex);
+	startPhase(PHASE_PARSE);
+	if (phased && numWorkers > 1) { // if we're parsing as a separate phase in parallel, parse the files on the worker pool
+		runJobs(jobs, parseJob, numWorkers);
+	}
+	for (unsigned int fileIndex = 0; fileIndex < jobs.size(); fileIndex++) {
+		VERBOSE(printNotice("parsing file \'" << inFileNames()[fileIndex] << "\'...");)
+		// do the actual parsing (or report the results of the parallel or streamed parsing)
+		if (phased && numWorkers == 1) {
+			parseJob(jobs[fileIndex]);
+		}
+		jobs[fileIndex]->flushParserErrors();
+		Tree *thisParseme = jobs[fileIndex]->parseme;
+		int thisParseError = jobs[fileIndex]->parserErrorCode;
 		if (thisParseError) { // if parsing failed with an error, log the error condition
+			// the partial parse tree is of no further use, so free it right away
+			jobs[fileIndex]->treeArena->release();
+			jobs[fileIndex]->parseme = NULL;
 			VERBOSE(
-				printNotice(COLOREXP(SET_TERM(RED_CODE)) << "failed to parse file \'" << inFileNames[fileIndex] << "\'" << COLOREXP(SET_TERM(RESET_CODE)));
+				printNotice(COLOREXP(SET_TERM(RED_CODE)) << "failed to parse file \'" << inFileNames()[fileIndex] << "\'" << COLOREXP(SET_TERM(RESET_CODE)));
 				print(""); // new line
 			)
 		} else { // else if parsing was successful, latch the parseme into the tree trunk
+			if (cacheDir() != NULL && !jobs[fileIndex]->cached) { // if we're caching parse trees, store this one before it gets linked in
+				if (!storeParseCache(fileIndex, thisParseme)) {
+					printWarning("cannot write parse cache entry for file '" << inFileNames()[fileIndex] << "'");
+				}
+			}
 			if (treeRoot != NULL) { // if this is not the first parseme
 				// link in this tree
 				*treeCur += thisParseme;
@@ -281,7 +512,7 @@ int main(int argc, char **argv) {
 				treeRoot = treeCur = thisParseme;
 			}
 			VERBOSE(
-				printNotice(COLOREXP(SET_TERM(GREEN_CODE)) << "successfully parsed file \'" << inFileNames[fileIndex] << "\'" << COLOREXP(SET_TERM(RESET_CODE)));
+				printNotice(COLOREXP(SET_TERM(GREEN_CODE)) << "successfully parsed file \'" << inFileNames()[fileIndex] << "\'" << COLOREXP(SET_TERM(RESET_CODE)));
 				print(""); // new line
 			)
 		}
@@ -289,12 +520,11 @@ int main(int argc, char **argv) {
 		if (thisParseError > parserError) {
 			parserError = thisParseError;
 		}
-		// advance the file index
-		fileIndex++;
 	}
+	endPhase(PHASE_PARSE);
 	// now, check if parsing failed and if so, kill the system as appropriate
 	if (parserError) {
-		die(1);
+		return die(1);
 	}
 
 	// perform semantic analysis
@@ -306,9 +536,9 @@ int main(int argc, char **argv) {
 	// allocate the intermediate representation tree root (will be bound at the end of parsing)
 	SchedTree *codeRoot;
 
-	int semmerErrorCode = sem(treeRoot, stRoot, codeRoot);
+	int semmerError = sem(treeRoot, stRoot, codeRoot);
 	// now, check if semming failed and kill the system as appropriate
-	if (semmerErrorCode) {
+	if (semmerError) {
 		VERBOSE(
 			printNotice(COLOREXP(SET_TERM(RED_CODE)) << "failed to map semantics" << COLOREXP(SET_TERM(RESET_CODE)));
 			print(""); // new line
@@ -320,8 +550,8 @@ int main(int argc, char **argv) {
 		)
 	}
 	// now, check if semming failed and if so, kill the system as appropriate
-	if (semmerErrorCode) {
-		die(1);
+	if (semmerError) {
+		return die(1);
 	}
 
 	// generate the intermediate code tree
@@ -332,9 +562,11 @@ int main(int argc, char **argv) {
 	string asmString;
 
 	// generate the actual assembly code
-	int gennerErrorCode = gen(codeRoot, asmString);
+	startPhase(PHASE_GEN);
+	int gennerError = gen(codeRoot, asmString);
+	endPhase(PHASE_GEN);
 	// now, check if genning failed and kill the system as appropriate
-	if (gennerErrorCode) {
+	if (gennerError) {
 		VERBOSE(
 			printNotice(COLOREXP(SET_TERM(RED_CODE)) << "failed to generate code dump" << COLOREXP(SET_TERM(RESET_CODE)));
 			print(""); // new line
@@ -346,17 +578,30 @@ int main(int argc, char **argv) {
 		)
 	}
 	// now, check if genning failed and if so, kill the system as appropriate
-	if (gennerErrorCode) {
-		die(1);
+	if (gennerError) {
+		return die(1);
 	}
 	
 	// open output file for writing
-	ofstream *outFile = new ofstream(outFileName.c_str());
-	if (!outFile->good()) {
+	ofstream outFile(outFileName.c_str());
+	if (!outFile.good()) {
 		printError("cannot open output file '" << outFileName << "'");
-		die();
+		return die();
 	}
 
+	// print out the statistics, if we're gathering them
+	printStats();
+
 	// terminate the program successfully
 	return 0;
 }
+
+// compiles as directed by the given command line in a fresh compilation context, so that any number of compilations can run at once (on separate threads)
+int anicCompile(int argc, char **argv, ostream &out, ostream &err) {
+	CompilerContext *callerContext = compilerContext;
+	CompilerContext context(out, err);
+	compilerContext = &context;
+	int errorCode = compile(argc, argv);
+	compilerContext = callerContext;
+	return errorCode;
+}
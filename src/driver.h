@@ -6,8 +6,8 @@
 
 // terminal control codes
 
-#define COLOR(s) if (codedOutput) {s}
-#define COLOREXP(e) (codedOutput ? (e) : "")
+#define COLOR(s) if (codedOutput()) {s}
+#define COLOREXP(e) (codedOutput() ? (e) : "")
 
 #define SET_TERM(mode) ("\x1b[" mode "m")
 #define AND ";"
@@ -33,41 +33,104 @@
 #define WARNING_STRING COLOREXP(SET_TERM(BRIGHT_CODE AND YELLOW_CODE))<<"WARNING"<<COLOREXP(SET_TERM(RESET_CODE))
 
 #define HEADER_LITERAL PROGRAM_STRING<<" -- "<<LANGUAGE_STRING<<" Compiler v.["<<VERSION_STRING<<"."<<VERSION_STAMP<<"] (c) "<<VERSION_YEAR<<" Kajetan Adrian Biedrzycki\n" /* compiler header */
-#define USAGE_LITERAL "\n\tusage:\t"<<PROGRAM_STRING<<" sourceFile... [-] [-o outputFile] [-p optimizationLevel]\n\t\t[-v] [-s] [-c] [-t tabWidth] [-e] [-h]\n" /* info literal */
+#define USAGE_LITERAL "\n\tusage:\t"<<PROGRAM_STRING<<" sourceFile... [-] [-o outputFile] [-p optimizationLevel]\n\t\t[-j jobs] [-l] [-C cacheDir] [-v] [-s] [-c] [-t tabWidth] [-e] [-T] [-J] [-h]\n\t\t"<<PROGRAM_STRING<<" -D socketFile\n" /* info literal */
 #define SEE_ALSO_LITERAL "\n\tFor more information, type '"<<PROGRAM_STRING<<" -h'.\n" /* see also literal */
 #define LINK_LITERAL "\thome page: "<<HOME_PAGE<<"\n" /* link literal */
 
 // standard printing functions
 
-#define print(s) if (!silentMode) { cout << s << "\n"; }
-#define printLabel(s) if (!silentMode) { cout << "\n" << s << "\n"; }
-#define printNotice(s) if (!silentMode) { cout << PROGRAM_STRING << ": " << s << ".\n"; }
-#define printError(s) if (!silentMode) { cerr << ERROR_STRING << ": " << s << ".\n"; }; driverErrorCode++;
-#define printWarning(s) if (!silentMode) { cerr << WARNING_STRING << ": " << s << ".\n"; }
+#define print(s) if (!silentMode()) { outStream() << s << "\n"; }
+#define printLabel(s) if (!silentMode()) { outStream() << "\n" << s << "\n"; }
+#define printNotice(s) if (!silentMode()) { outStream() << PROGRAM_STRING << ": " << s << ".\n"; }
+#define printError(s) if (!silentMode()) { errStream() << ERROR_STRING << ": " << s << ".\n"; }; driverErrorCode()++;
+#define printWarning(s) if (!silentMode()) { errStream() << WARNING_STRING << ": " << s << ".\n"; }
 
-#define GET_FILE_NAME(fi) ((fi != STANDARD_LIBRARY_FILE_INDEX) ? inFileNames[fi] : STANDARD_LIBRARY_FILE_NAME)
+#define GET_FILE_NAME(fi) ((fi != STANDARD_LIBRARY_FILE_INDEX) ? inFileNames()[fi] : STANDARD_LIBRARY_FILE_NAME)
 
-#define lexerError(fi,r,c,str) if (!silentMode) { silentMode = true; \
-		cerr << ERROR_STRING << ": " << \
+// note: lexerError and parserError report into the per-job lexerErrorStream/parserErrorStream and lexerErrorCode/parserErrorCode in scope
+// (lexerError gives up by returning false from the enclosing function)
+#define lexerError(fi,r,c,str) if (!silentMode()) { \
+		lexerErrorStream << ERROR_STRING << ": " << \
 		COLOREXP(SET_TERM(CYAN_CODE)) << "LEXER" << COLOREXP(SET_TERM(RESET_CODE)) << \
-		": " << COLOREXP(SET_TERM(BRIGHT_CODE AND BLACK_CODE)) << GET_FILE_NAME(fi) << ":" << r << ":" << c << COLOREXP(SET_TERM(RESET_CODE)) << ": " << str << ".\n"; \
-		silentMode = false; } \
+		": " << COLOREXP(SET_TERM(BRIGHT_CODE AND BLACK_CODE)) << GET_FILE_NAME(fi) << ":" << r << ":" << c << COLOREXP(SET_TERM(RESET_CODE)) << ": " << str << ".\n"; } \
 	lexerErrorCode++; \
-	if (eventuallyGiveUp && lexerErrorCode >= TOLERABLE_ERROR_LIMIT) { printError("too many errors, giving up"); return NULL; }
+	if (eventuallyGiveUp() && lexerErrorCode >= TOLERABLE_ERROR_LIMIT) { if (!silentMode()) { lexerErrorStream << ERROR_STRING << ": too many errors, giving up.\n"; } return false; }
 
-#define parserError(fi,r,c,str) if (!silentMode) { silentMode = true; \
-		cerr << ERROR_STRING << ": "<< \
+#define parserError(fi,r,c,str) if (!silentMode()) { \
+		parserErrorStream << ERROR_STRING << ": "<< \
 		COLOREXP(SET_TERM(CYAN_CODE)) << "PARSER" << COLOREXP(SET_TERM(RESET_CODE)) << \
-		": " << COLOREXP(SET_TERM(BRIGHT_CODE AND BLACK_CODE)) << GET_FILE_NAME(fi) << ":" << r << ":" << c << COLOREXP(SET_TERM(RESET_CODE)) << ": " << str << ".\n"; \
-		silentMode = false; } \
+		": " << COLOREXP(SET_TERM(BRIGHT_CODE AND BLACK_CODE)) << GET_FILE_NAME(fi) << ":" << r << ":" << c << COLOREXP(SET_TERM(RESET_CODE)) << ": " << str << ".\n"; } \
 	parserErrorCode++;
 
-#define semmerError(fi,r,c,str) if (!silentMode) { silentMode = true; \
-		cerr << ERROR_STRING << ": "<< \
+// semmer modes (see semmerError)
+#define SEMMER_SEQUENTIAL 0 // errors are reported as they're found
+#define SEMMER_THREADED 1 // errors are logged against the node being typed, to be replayed in sequential order later
+#define SEMMER_REPLAY 2 // logged errors are being replayed; errors are reported as they're found
+
+#define SEMMER_ERROR_TEXT(fi,r,c,msg) ERROR_STRING << ": "<< \
 		COLOREXP(SET_TERM(CYAN_CODE)) << "SEMMER" << COLOREXP(SET_TERM(RESET_CODE)) << \
-		": " << COLOREXP(SET_TERM(BRIGHT_CODE AND BLACK_CODE)) << GET_FILE_NAME(fi) << ":" << r << ":" << c << COLOREXP(SET_TERM(RESET_CODE)) << ": " << str << ".\n"; \
-		silentMode = false; } \
-	semmerErrorCode++;
+		": " << COLOREXP(SET_TERM(BRIGHT_CODE AND BLACK_CODE)) << GET_FILE_NAME(fi) << ":" << r << ":" << c << COLOREXP(SET_TERM(RESET_CODE)) << ": " << msg << ".\n"
+
+// note: errors raised while formatting another error (e.g. by lazily typing a node to print it) are counted but not printed
+#define semmerError(fi,r,c,msg) if (semmerMode() != SEMMER_THREADED) { \
+		if (!silentMode() && !semmerErrorMuted) { semmerErrorMuted = true; errStream() << SEMMER_ERROR_TEXT(fi,r,c,msg); semmerErrorMuted = false; } \
+		semmerErrorCode()++; \
+	} else { \
+		ostringstream semmerErrorText; \
+		if (!silentMode() && !semmerErrorMuted) { semmerErrorMuted = true; semmerErrorText << SEMMER_ERROR_TEXT(fi,r,c,msg); semmerErrorMuted = false; } \
+		logSemmerError(semmerErrorText.str()); \
+	}
+
+// per-file lexing and parsing jobs
+
+class FileJob {
+	public:
+		// data members
+		unsigned int fileIndex;
+		vector<Token> *lexeme; // the file's tokens, once it's been lexed (only when lexing and parsing as separate phases)
+		Tree *parseme; // the file's parse tree, once it's been parsed
+		TreeArena *treeArena; // where the file's parse tree nodes are allocated
+		bool cached; // whether the parse tree was loaded from the parse cache (in which case the file isn't lexed or parsed at all)
+		int lexerErrorCode;
+		int parserErrorCode;
+		ostream *lexerErrorStream; // the streams that this job's diagnostics go to
+		ostream *parserErrorStream;
+		ostringstream lexerErrorBuffer; // diagnostics held back until they can be reported in order
+		ostringstream parserErrorBuffer;
+		// allocators/deallocators
+		FileJob(unsigned int fileIndex, bool buffered);
+		~FileJob();
+		// core methods
+		void flushLexerErrors(); // print out the held back diagnostics
+		void flushParserErrors();
+};
+
+class JobPool {
+	public:
+		// data members
+		vector<FileJob *> &jobs;
+		void (*work)(FileJob *job);
+		unsigned int nextJob; // the index of the next job to be claimed by a worker
+		CompilerContext *context; // the compilation that the workers are working on
+		// allocators/deallocators
+		JobPool(vector<FileJob *> &jobs, void (*work)(FileJob *job));
+		~JobPool();
+};
+
+void runJobs(vector<FileJob *> &jobs, void (*work)(FileJob *job), unsigned int numWorkers);
+
+class LexAheadJob {
+	public:
+		// data members
+		vector<FileJob *> &jobs;
+		TokenPipe *pipe; // the tokens of all of the files, in order
+		CompilerContext *context;
+		// allocators/deallocators
+		LexAheadJob(vector<FileJob *> &jobs);
+		~LexAheadJob();
+};
+
+void runLexAhead(vector<FileJob *> &jobs);
 
 void printHeader(void);
 void printUsage(void);
@@ -75,7 +138,8 @@ void printSeeAlso(void);
 void printHelp(void);
 void printLink(void);
 const string &getFileName(unsigned int fileIndex);
-void die(int errorCode);
-void die(void);
+int die(int errorCode); // prints the statistics and the fatal error (if any), and returns the exit code to stop with
+int die(void);
+int compile(int argc, char **argv); // in the current compilation context (see anicCompile() for running one in a fresh context)
 
 #endif
@@ -1,14 +1,19 @@
 #include "genner.h"
 
 #include "outputOperators.h"
-
-// genner-global variables
-
-int gennerErrorCode;
+#include "stats.h"
 
 // IRTree functions
-IRTree::IRTree(int category) : category(category) {}
+IRTree::IRTree(int category) : category(category) {
+	STAT_COUNT(STAT_IR_TREE_NODES);
+}
 IRTree::~IRTree() {}
+void *IRTree::operator new(size_t size) {
+	return allocNode(OWNED_IR_TREES, size);
+}
+void IRTree::operator delete(void *ptr) {
+	freeNode(ptr);
+}
 void IRTree::asmDump(string &asmString) const {
 	switch(category) {
 		case CATEGORY_LABEL:
@@ -78,9 +83,7 @@ void IRTree::asmDump(string &asmString) const {
 
 // LabelTree functions
 LabelTree::LabelTree(SeqTree *code) : IRTree(CATEGORY_LABEL), id(getUniqueId()), code(code) {}
-LabelTree::~LabelTree() {
-	delete code;
-}
+LabelTree::~LabelTree() {} // the compilation frees the subtrees (see allocNode())
 string LabelTree::toString(unsigned int tabDepth) const {
 	string acc(id);
 	acc += '(';
@@ -94,11 +97,7 @@ void LabelTree::asmDump(string &asmString) const {
 
 // SeqTree functions
 SeqTree::SeqTree(const vector<CodeTree *> &codeList) : IRTree(CATEGORY_SEQ), codeList(codeList) {}
-SeqTree::~SeqTree() {
-	for (vector<CodeTree *>::const_iterator iter = codeList.begin(); iter != codeList.end(); iter++) {
-		delete (*iter);
-	}
-}
+SeqTree::~SeqTree() {} // the compilation frees the subtrees (see allocNode())
 string SeqTree::toString(unsigned int tabDepth) const {
 	string acc;
 	for (vector<CodeTree *>::const_iterator iter = codeList.begin(); iter != codeList.end(); iter++) {
@@ -263,7 +262,7 @@ void CompoundTree::asmDump(string &asmString) const {
 
 // TempTree functions
 TempTree::TempTree(OpTree *opNode) : DataTree(CATEGORY_TEMP), opNode(opNode) {}
-TempTree::~TempTree() {delete opNode;}
+TempTree::~TempTree() {} // the compilation frees the subtrees (see allocNode())
 string TempTree::toString(unsigned int tabDepth) const {
 	string acc("(");
 	acc += opNode->toString(tabDepth+1);
@@ -276,7 +275,7 @@ void TempTree::asmDump(string &asmString) const {
 
 // ReadTree functions
 ReadTree::ReadTree(DataTree *address) : DataTree(CATEGORY_READ), address(address) {}
-ReadTree::~ReadTree() {delete address;}
+ReadTree::~ReadTree() {} // the compilation frees the subtrees (see allocNode())
 string ReadTree::toString(unsigned int tabDepth) const {
 	string acc("R(");
 	acc += address->toString(tabDepth+1);
@@ -390,7 +389,7 @@ void OpTree::asmDump(string &asmString) const {
 
 // UnOpTree functions
 UnOpTree::UnOpTree(int kind, DataTree *subNode) : OpTree(CATEGORY_UNOP, kind), subNode(subNode) {}
-UnOpTree::~UnOpTree() {delete subNode;}
+UnOpTree::~UnOpTree() {} // the compilation frees the subtrees (see allocNode())
 string UnOpTree::toString(unsigned int tabDepth) const {
 	string acc(kindToString());
 	acc += '(';
@@ -404,7 +403,7 @@ void UnOpTree::asmDump(string &asmString) const {
 
 // BinOpTree functions
 BinOpTree::BinOpTree(int kind, DataTree *subNodeLeft, DataTree *subNodeRight) : OpTree(CATEGORY_BINOP, kind), subNodeLeft(subNodeLeft), subNodeRight(subNodeRight) {}
-BinOpTree::~BinOpTree() {delete subNodeLeft; delete subNodeRight;}
+BinOpTree::~BinOpTree() {} // the compilation frees the subtrees (see allocNode())
 string BinOpTree::toString(unsigned int tabDepth) const {
 	string acc(kindToString());
 	acc += '(';
@@ -420,7 +419,7 @@ void BinOpTree::asmDump(string &asmString) const {
 
 // ConvOpTree functions
 ConvOpTree::ConvOpTree(int kind, DataTree *subNode) : OpTree(CATEGORY_CONVOP, kind), subNode(subNode) {}
-ConvOpTree::~ConvOpTree() {delete subNode;}
+ConvOpTree::~ConvOpTree() {} // the compilation frees the subtrees (see allocNode())
 string ConvOpTree::toString(unsigned int tabDepth) const {
 	string acc(kindToString());
 	acc += '(';
@@ -485,7 +484,7 @@ void CodeTree::asmDump(string &asmString) const {
 
 // LockTree functions
 LockTree::LockTree(DataTree *address) : CodeTree(CATEGORY_LOCK), address(address) {}
-LockTree::~LockTree() {delete address;}
+LockTree::~LockTree() {} // the compilation frees the subtrees (see allocNode())
 string LockTree::toString(unsigned int tabDepth) const {
 	string acc("L(");
 	acc += address->toString(tabDepth+1);
@@ -498,7 +497,7 @@ void LockTree::asmDump(string &asmString) const {
 
 // UnlockTree functions
 UnlockTree::UnlockTree(DataTree *address) : CodeTree(CATEGORY_UNLOCK), address(address) {}
-UnlockTree::~UnlockTree() {delete address;}
+UnlockTree::~UnlockTree() {} // the compilation frees the subtrees (see allocNode())
 string UnlockTree::toString(unsigned int tabDepth) const {
 	string acc("U(");
 	acc += address->toString(tabDepth+1);
@@ -511,7 +510,7 @@ void UnlockTree::asmDump(string &asmString) const {
 
 // CondTree functions
 CondTree::CondTree(DataTree *test, CodeTree *trueBranch, CodeTree *falseBranch) : CodeTree(CATEGORY_COND), test(test), trueBranch(trueBranch), falseBranch(falseBranch) {}
-CondTree::~CondTree() {delete test; delete trueBranch; delete falseBranch;}
+CondTree::~CondTree() {} // the compilation frees the subtrees (see allocNode())
 string CondTree::toString(unsigned int tabDepth) const {
 	string acc("?(");
 	acc += test->toString(tabDepth+1);
@@ -528,11 +527,7 @@ void CondTree::asmDump(string &asmString) const {
 
 // JumpTree functions
 JumpTree::JumpTree(DataTree *test, const vector<SeqTree *> &jumpTable) : CodeTree(CATEGORY_JUMP), test(test), jumpTable(jumpTable) {}
-JumpTree::~JumpTree() {
-	for (vector<SeqTree *>::const_iterator iter = jumpTable.begin(); iter != jumpTable.end(); iter++) {
-		delete (*iter);
-	}
-}
+JumpTree::~JumpTree() {} // the compilation frees the subtrees (see allocNode())
 string JumpTree::toString(unsigned int tabDepth) const {
 	string acc("J(");
 	for (unsigned int i = 0; i < jumpTable.size(); i++) {
@@ -552,7 +547,7 @@ void JumpTree::asmDump(string &asmString) const {
 
 // WriteTree functions
 WriteTree::WriteTree(DataTree *source, DataTree *address) : CodeTree(CATEGORY_WRITE), source(source), address(address) {}
-WriteTree::~WriteTree() {delete source; delete address;}
+WriteTree::~WriteTree() {} // the compilation frees the subtrees (see allocNode())
 string WriteTree::toString(unsigned int tabDepth) const {
 	string acc("W(");
 	acc += source->toString(tabDepth+1);
@@ -567,7 +562,7 @@ void WriteTree::asmDump(string &asmString) const {
 
 // CopyTree functions
 CopyTree::CopyTree(DataTree *sourceAddress, DataTree *destinationAddress, uint32_t length) : CodeTree(CATEGORY_COPY), sourceAddress(sourceAddress), destinationAddress(destinationAddress), length(length) {}
-CopyTree::~CopyTree() {delete sourceAddress; delete destinationAddress;}
+CopyTree::~CopyTree() {} // the compilation frees the subtrees (see allocNode())
 string CopyTree::toString(unsigned int tabDepth) const {
 	string acc("C(");
 	acc += sourceAddress->toString(tabDepth+1);
@@ -604,11 +599,11 @@ void SchedTree::asmDump(string &asmString) const {
 int gen(SchedTree *codeRoot, string &asmString) {
 
 	// initialize local error code
-	gennerErrorCode = 0;
+	gennerErrorCode() = 0;
 	
 	// recursively generate the assembly code for the program
 	codeRoot->asmDump(asmString);
 
 	// finally, return to the caller
-	return gennerErrorCode ? 1 : 0;
+	return gennerErrorCode() ? 1 : 0;
 }
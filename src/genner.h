@@ -45,6 +45,8 @@ class IRTree {
 		// allocators/deallocators
 		IRTree(int category);
 		virtual ~IRTree();
+		static void *operator new(size_t size); // IRTrees belong to the compilation that allocated them (see allocNode())
+		static void operator delete(void *ptr);
 		// core methods
 		string toString(unsigned int tabDepth = 1) const;
 		void asmDump(string &asmString) const;
@@ -10,6 +10,7 @@
 #include <map>
 #include <deque>
 #include <stack>
+#include <sstream>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -17,6 +18,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <limits.h>
+#include <pthread.h>
 
 using std::cin;
 using std::cout;
@@ -26,6 +28,7 @@ using std::flush;
 using std::ifstream;
 using std::ofstream;
 using std::ostream;
+using std::ostringstream;
 using std::string;
 using std::vector;
 using std::deque;
@@ -36,8 +39,14 @@ using std::make_pair;
 
 // class forward declarations
 
+class SourceBuffer;
+class Token;
+class TokenPipe;
 class Tree;
+class TreeArena;
+class Ast;
 class SymbolTree;
+class StatusLog;
 class Type;
 class TypeList;
 class StdType;
@@ -74,57 +83,16 @@ class IRTree;
 		class CopyTree;
 		class SchedTree;
 
-// global variable linkage specifiers
+// per-compilation state (see context.h)
 
-extern int optimizationLevel;
-extern bool verboseOutput;
-extern bool silentMode;
-extern bool codedOutput;
-extern int tabModulus;
-extern bool eventuallyGiveUp;
+class CompilerContext;
 
-extern vector<string> inFileNames;
-
-extern int driverErrorCode;
-extern int lexerErrorCode;
-extern int parserErrorCode;
-extern int semmerErrorCode;
-extern int gennerErrorCode;
-
-extern Type *nullType;
-extern Type *errType;
-class StdType;
-extern StdType *stdBoolType;
-extern StdType *stdIntType;
-extern StdType *stdFloatType;
-extern StdType *stdCharType;
-extern StdType *stdStringType;
-extern StdType *stdBoolLitType;
-
-extern StdType *inIntType;
-extern StdType *inFloatType;
-extern StdType *inCharType;
-extern StdType *inStringType;
-extern ObjectType *stringerType;
-extern ObjectType *boolUnOpType;
-extern ObjectType *intUnOpType;
-extern ObjectType *boolBinOpType;
-extern ObjectType *intBinOpType;
-extern ObjectType *floatBinOpType;
-extern ObjectType *boolCompOpType;
-extern ObjectType *intCompOpType;
-extern ObjectType *floatCompOpType;
-extern ObjectType *charCompOpType;
-extern ObjectType *stringCompOpType;
-
-extern StdType *stdLibType;
-extern SymbolTree *stdLib;
-
-extern IRTree *nopCode;
+extern __thread bool semmerErrorMuted;
 
 // global function forward declarations
 
 unsigned int getUniqueInt();
 string getUniqueId();
+void logSemmerError(const string &text);
 
 #endif
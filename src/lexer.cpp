@@ -1,17 +1,34 @@
 #include "lexer.h"
 
 #include "outputOperators.h"
+#include "stats.h"
 
-// lexer-global variables
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
 
-int lexerErrorCode;
+#if defined(__x86_64__) || defined(__i386__)
+#define LEXER_SIMD
+#include <immintrin.h>
+#endif
+
+// lexer tables
+#include "../tmp/lexerNodeRaw.h"
 
 // Token functions
-Token::Token(int tokenType) : tokenType(tokenType), fileIndex(STANDARD_LIBRARY_FILE_INDEX), row(0), col(0) {}
-Token::Token(int tokenType, const string &s, unsigned int fileIndex, int row, int col) : tokenType(tokenType), s(s), fileIndex(fileIndex), row(row), col(col) {}
-Token::Token(const Token &otherToken) : tokenType(otherToken.tokenType), s(otherToken.s), fileIndex(otherToken.fileIndex), row(otherToken.row), col(otherToken.col) {}
-Token::~Token() {}
-Token &Token::operator=(Token &otherToken) {tokenType = otherToken.tokenType; s = otherToken.s; fileIndex = otherToken.fileIndex; row = otherToken.row; col = otherToken.col; return *this;}
+Token::Token(int tokenType) : tokenType(tokenType), offset(0), length(0), fileIndex(STANDARD_LIBRARY_FILE_INDEX), row(0), col(0), atom(NULL_ATOM) {}
+Token::Token(int tokenType, unsigned int offset, unsigned int length, unsigned int fileIndex, int row, int col, Atom atom) :
+	tokenType(tokenType), offset(offset), length(length), fileIndex(fileIndex), row(row), col(col), atom(atom) {}
+const char *Token::text() const {
+	return (length != 0) ? inFiles()[fileIndex]->text(offset) : "";
+}
+string Token::s() const {
+	return string(text(), length);
+}
+bool Token::textEquals(const char *str) const {
+	return (strncmp(text(), str, length) == 0 && str[length] == '\0');
+}
 Token::operator string() const {
 	string acc("[");
 	COLOR( acc += SET_TERM(BRIGHT_CODE AND CYAN_CODE); )
@@ -19,7 +36,7 @@ Token::operator string() const {
 	COLOR( acc += SET_TERM(RESET_CODE); )
 	acc += ' ';
 	COLOR( acc += SET_TERM(BRIGHT_CODE AND WHITE_CODE); )
-	acc += s;
+	acc.append(text(), length);
 	COLOR( acc += SET_TERM(RESET_CODE); )
 	acc += " (";
 	char tempBuf[MAX_INT_STRING_LENGTH];
@@ -32,6 +49,212 @@ Token::operator string() const {
 	return acc;
 }
 
+// SourceBuffer functions
+SourceBuffer::SourceBuffer() : data(NULL), size(0), mapped(false) {}
+SourceBuffer::~SourceBuffer() {
+	if (mapped) {
+		munmap((void *)data, size);
+	} else {
+		free((void *)data);
+	}
+}
+bool SourceBuffer::load(const string &fileName) {
+	if (fileName == STD_IN_FILE_NAME) { // if we're reading from standard input, bulk-read it
+		return load(STDIN_FILENO);
+	}
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) { // if opening the file failed, return an error
+		return false;
+	}
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || S_ISDIR(fileStat.st_mode)) { // if we can't stat the file or it isn't readable as a file, return an error
+		close(fd);
+		return false;
+	}
+	if (S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) { // if it's a non-empty regular file, try to map it in
+		void *mapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED) { // if the mapping succeeded, we're done
+			madvise(mapping, fileStat.st_size, MADV_SEQUENTIAL);
+			data = (const char *)mapping;
+			size = fileStat.st_size;
+			mapped = true;
+			close(fd);
+			return true;
+		}
+	}
+	// otherwise, fall back to bulk-reading the file (e.g. for pipes and character devices)
+	bool retVal = load(fd);
+	close(fd);
+	return retVal;
+}
+bool SourceBuffer::load(int fd) {
+	size_t capacity = 0;
+	char *buf = NULL;
+	for(;;) { // read blocks until EOF
+		if (size == capacity) { // if the buffer is full, grow it
+			capacity = (capacity == 0) ? SOURCE_READ_BLOCK_SIZE : capacity*2;
+			char *newBuf = (char *)realloc(buf, capacity);
+			if (newBuf == NULL) { // if we ran out of memory, return an error
+				free(buf);
+				size = 0;
+				return false;
+			}
+			buf = newBuf;
+		}
+		ssize_t bytesRead = read(fd, buf + size, capacity - size);
+		if (bytesRead > 0) { // if we got some data, log it
+			size += bytesRead;
+		} else if (bytesRead == 0) { // else if we hit EOF, we're done
+			break;
+		} else if (errno != EINTR) { // else if the read failed for real, return an error
+			free(buf);
+			size = 0;
+			return false;
+		}
+	}
+	data = buf;
+	mapped = false;
+	return true;
+}
+
+const char *SourceBuffer::text(unsigned int offset) const {
+	return (offset < size) ? (data + offset) : (arena.data() + (offset - size));
+}
+unsigned int SourceBuffer::materialize(const char *str, unsigned int length) {
+	unsigned int retVal = size + arena.size();
+	arena.append(str, length);
+	return retVal;
+}
+
+// scanning kernels
+
+// returns a pointer to the first character in [cur,end) that is one of the stop characters a, b, c, or d (or end if there is none)
+static const char *findAnyScalar(const char *cur, const char *end, char a, char b, char c, char d) {
+	for (; cur != end; cur++) {
+		char ch = *cur;
+		if (ch == a || ch == b || ch == c || ch == d) {
+			break;
+		}
+	}
+	return cur;
+}
+// returns a pointer to the first character in [cur,end) that isn't the character a (or end if there is none)
+static const char *skipRunScalar(const char *cur, const char *end, char a) {
+	while (cur != end && *cur == a) {
+		cur++;
+	}
+	return cur;
+}
+
+#ifdef LEXER_SIMD
+
+#ifndef __SSE2__
+__attribute__((target("sse2")))
+#endif
+static const char *findAnySse2(const char *cur, const char *end, char a, char b, char c, char d) {
+	const __m128i va = _mm_set1_epi8(a);
+	const __m128i vb = _mm_set1_epi8(b);
+	const __m128i vc = _mm_set1_epi8(c);
+	const __m128i vd = _mm_set1_epi8(d);
+	while (end - cur >= 16) { // scan in 16-byte strides
+		__m128i chunk = _mm_loadu_si128((const __m128i *)cur);
+		__m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)),
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, vc), _mm_cmpeq_epi8(chunk, vd)));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(hits);
+		if (mask != 0) {
+			return cur + __builtin_ctz(mask);
+		}
+		cur += 16;
+	}
+	return findAnyScalar(cur, end, a, b, c, d);
+}
+#ifndef __SSE2__
+__attribute__((target("sse2")))
+#endif
+static const char *skipRunSse2(const char *cur, const char *end, char a) {
+	const __m128i va = _mm_set1_epi8(a);
+	while (end - cur >= 16) { // scan in 16-byte strides
+		__m128i chunk = _mm_loadu_si128((const __m128i *)cur);
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, va)) ^ 0xFFFFu;
+		if (mask != 0) {
+			return cur + __builtin_ctz(mask);
+		}
+		cur += 16;
+	}
+	return skipRunScalar(cur, end, a);
+}
+
+__attribute__((target("avx2")))
+static const char *findAnyAvx2(const char *cur, const char *end, char a, char b, char c, char d) {
+	const __m256i va = _mm256_set1_epi8(a);
+	const __m256i vb = _mm256_set1_epi8(b);
+	const __m256i vc = _mm256_set1_epi8(c);
+	const __m256i vd = _mm256_set1_epi8(d);
+	while (end - cur >= 32) { // scan in 32-byte strides
+		__m256i chunk = _mm256_loadu_si256((const __m256i *)cur);
+		__m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, va), _mm256_cmpeq_epi8(chunk, vb)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(chunk, vc), _mm256_cmpeq_epi8(chunk, vd)));
+		unsigned int mask = (unsigned int)_mm256_movemask_epi8(hits);
+		if (mask != 0) {
+			return cur + __builtin_ctz(mask);
+		}
+		cur += 32;
+	}
+	return findAnyScalar(cur, end, a, b, c, d);
+}
+__attribute__((target("avx2")))
+static const char *skipRunAvx2(const char *cur, const char *end, char a) {
+	const __m256i va = _mm256_set1_epi8(a);
+	while (end - cur >= 32) { // scan in 32-byte strides
+		__m256i chunk = _mm256_loadu_si256((const __m256i *)cur);
+		unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, va));
+		if (mask != 0) {
+			return cur + __builtin_ctz(mask);
+		}
+		cur += 32;
+	}
+	return skipRunScalar(cur, end, a);
+}
+
+#endif
+
+// the scanning kernels in use, as selected for the host CPU
+struct ScanKernels {
+	const char *(*findAny)(const char *cur, const char *end, char a, char b, char c, char d);
+	const char *(*skipRun)(const char *cur, const char *end, char a);
+};
+
+static ScanKernels selectScanKernels() {
+	ScanKernels retVal = { findAnyScalar, skipRunScalar };
+#ifdef LEXER_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		retVal.findAny = findAnyAvx2;
+		retVal.skipRun = skipRunAvx2;
+	} else if (__builtin_cpu_supports("sse2")) {
+		retVal.findAny = findAnySse2;
+		retVal.skipRun = skipRunSse2;
+	}
+#endif
+	return retVal;
+}
+
+static const ScanKernels scanKernels = selectScanKernels();
+
+// advances row and col over the (already-consumed) characters in [cur,end)
+static void advancePosition(const char *cur, const char *end, int &row, int &col) {
+	for (; cur != end; cur++) {
+		if (*cur == '\n') {
+			row++;
+			col = 0;
+		} else if (*cur == '\t') {
+			col = (col - (col % tabModulus()) + tabModulus());
+		} else {
+			col++;
+		}
+	}
+}
+
 // main lexing functions
 
 int isWhiteSpace(unsigned char c) {
@@ -46,22 +269,26 @@ int isTab(unsigned char c) {
 	return (c == '\t');
 }
 
-void resetState(string &s, int &state, int &tokenType) {
+void resetState(int &state, int &tokenType, unsigned int &tokenLength) {
 	// reset the state variables
-	s.clear(); // clear the raw token buffer
+	tokenLength = 0; // clear the raw token extent
 	state = 0;
 	tokenType = -1;
 	// return normally
 	return;
 }
 
-void commitToken(string &s, int &state, int &tokenType, unsigned int fileIndex, int rowStart, int colStart, vector<Token> *outputVector, char c) {
+void commitToken(int &state, int &tokenType, unsigned int tokenOffset, unsigned int &tokenLength, unsigned int fileIndex, int rowStart, int colStart, TokenRing &ring) {
 	// first, build up the token
-	Token t(tokenType, s, fileIndex, rowStart, colStart);
-	// now, commit it to the output vector
-	outputVector->push_back(t);
+	Token t(tokenType, tokenOffset, tokenLength, fileIndex, rowStart, colStart);
+	if (tokenType == TOKEN_ID) { // intern identifiers now, so that binding never has to compare their text
+		t.atom = intern(t.text(), tokenLength);
+	}
+	STAT_COUNT(STAT_TOKENS);
+	// now, commit it to the output ring
+	ring.push(t);
 	// finally, reset our state back to the default
-	resetState(s, state, tokenType);
+	resetState(state, tokenType, tokenLength);
 	// finally, return normally
 	return;
 }
@@ -75,60 +302,90 @@ string hex(unsigned char c) {
 }
 
 // discard input up until the end of the current token
-void discardToken(ifstream *in, char c, int &row, int &col, bool &done) {
+void discardToken(const char *&cur, const char *end, char c, int &row, int &col, bool &done) {
 	for(;;) {
-		bool retVal = (in == NULL ? cin.get(c) : in->get(c));
+		if (cur == end) { // if we hit the end of the file, flag the fact that we're done and continue lexing
+			done = true;
+			return;
+		}
+		c = *cur++;
 		// handle newline cursor logging properly
 		if (isNewLine(c)) {
 			row++;
 			col = 0;
 		} else if (isTab(c)) {
-			col = (col - (col % tabModulus) + tabModulus);
+			col = (col - (col % tabModulus()) + tabModulus());
 		} else {
 			col++;
 		}
-		if (!retVal) { // if we hit the end of the file, flag the fact that we're done and continue lexing
-			done = true;
-			return;
-		} else if (isWhiteSpace(c)) { // else if it was whitespace, continue lexing normally
+		if (isWhiteSpace(c)) { // if it was whitespace, continue lexing normally
 			return;
 		}
 	}
 }
 
-vector<Token> *lex(ifstream *in, unsigned int fileIndex) {
+// TokenRing functions
+TokenRing::TokenRing(unsigned int capacity) : tokens(new Token[capacity]), capacity(capacity), head(0), count(0) {}
+TokenRing::~TokenRing() {
+	delete[] tokens;
+}
+bool TokenRing::empty() const {
+	return (count == 0);
+}
+bool TokenRing::full() const {
+	return (count == capacity);
+}
+void TokenRing::push(const Token &t) {
+	unsigned int tail = head + count;
+	if (tail >= capacity) {
+		tail -= capacity;
+	}
+	tokens[tail] = t;
+	count++;
+}
+Token TokenRing::pop() {
+	Token retVal = tokens[head];
+	if (++head == capacity) {
+		head = 0;
+	}
+	count--;
+	return retVal;
+}
 
-	// initialize local error code
-	lexerErrorCode = 0;
+// Lexer functions
+Lexer::Lexer(SourceBuffer *in, unsigned int fileIndex, ostream &lexerErrorStream) : in(in), fileIndex(fileIndex), lexerErrorStream(lexerErrorStream), lexerErrorCode(0), finished(false),
+	cur(in->data), end(in->data + in->size), carryOver('\0'), tokenOffset(0), tokenLength(0), materialized(false), state(0), tokenType(-1),
+	row(1), col(0), rowStart(-1), colStart(-1), done(false) {}
+Lexer::~Lexer() {}
 
-	// declare and initialize lexer structure
-#include "../tmp/lexerNodeRaw.h"
-	// declare output vector
-	vector<Token> *outputVector = new vector<Token>();
-	// input character buffers
+bool Lexer::scan(TokenRing &ring) {
+	if (!finished) {
+		finished = !scanTokens(ring);
+	}
+	return !finished;
+}
+
+// note: the lexer state lives in the Lexer's data members, so this can return whenever the ring fills up and pick up where it left off on the next call
+bool Lexer::scanTokens(TokenRing &ring) {
+
+	// input character buffer
 	char c;
-	char carryOver = '\0';
-	// output character buffer
-	string s;
-	// state variables
-	int state = 0;
-	int tokenType = -1;
-	// the position in the file we're currently in
-	int row = 1;
-	int col = 0;
-	int rowStart = -1;
-	int colStart = -1;
-	// loop flags
-	bool done = false;
 	for(;;) { // per-character loop
 
 lexerLoopTop: ;
+		// if there's no room in the ring for another token, yield to the consumer
+		// (each pass through the loop commits at most one token)
+		if (ring.full()) {
+			return true;
+		}
 		// get a new character
 		if (carryOver != '\0') { // if there is a character to carry over, use it
 			c = carryOver;
 			carryOver = '\0';
 		} else { // otherwise, grab a character from the input
-			if ( !(in == NULL ? cin.get(c) : in->get(c)) ) { // if getting a character fails, flag the fact that we're done now
+			if (cur != end) { // if there are characters left, grab the next one
+				c = *cur++;
+			} else { // else if we're out of characters, flag the fact that we're done now
 				if (done) { // if this is the second time we're trying to read EOF, break out of the loop
 					break;
 				}
@@ -138,7 +395,7 @@ lexerLoopTop: ;
 			}
 			// either way, we just got a character, so advance the column count
 			if (isTab(c)) {
-				col = (col - (col % tabModulus) + tabModulus);
+				col = (col - (col % tabModulus()) + tabModulus());
 			} else {
 				col++;
 			}
@@ -149,30 +406,53 @@ lexerLoopTop: ;
 			if (tokenType == TOKEN_ERROR) { // if we got whitespace space while in error mode,
 				lexerError(fileIndex,rowStart,colStart,"whitespace-truncated token");
 				// throw away this token and continue parsing
-				resetState(s, state, tokenType);
+				resetState(state, tokenType, tokenLength);
 				carryOver = c;
 			} else if (tokenType != -1) { // else if we were in a commitable state, commit this token to the output vector
-				commitToken(s, state, tokenType, fileIndex, rowStart, colStart, outputVector, c);
+				commitToken(state, tokenType, tokenOffset, tokenLength, fileIndex, rowStart, colStart, ring);
 			}
 			if (isNewLine(c)) { // newline?
 				// bump up the row count and carriage return the column
 				row++;
 				col = 0;
 			}
+			if (carryOver == '\0') { // if we're not re-processing this character, skip the rest of the whitespace run in bulk
+				for(;;) {
+					const char *runEnd = scanKernels.skipRun(cur, end, ' ');
+					col += runEnd - cur;
+					cur = runEnd;
+					if (cur == end) {
+						break;
+					}
+					c = *cur;
+					if (isNewLine(c)) {
+						row++;
+						col = 0;
+					} else if (isTab(c)) {
+						col = (col - (col % tabModulus()) + tabModulus());
+					} else if (c == '\r') {
+						col++;
+					} else {
+						break;
+					}
+					cur++;
+				}
+			}
 		} else { // else if it was a non-whitepace character, check if there is a valid transition for this state
-			LexerNode transition = state == -1 ? lexerNode[255][(unsigned char)c] : lexerNode[state][(unsigned char)c];
+			LexerNode transition = lexerNode[state][lexerCharClass[(unsigned char)c]];
 			if (transition.tokenType != -1) { // if the transition is valid
 				// first, set rowStart amd colStart if we're coming from the core state
 				if (state == 0) {
 					rowStart = row;
 					colStart = col;
+					tokenOffset = (cur - in->data) - 1;
 				}
 				// second, check if we're jumping into a failure state
 				if(transition.tokenType == TOKEN_FAIL) { // if it's a failure state, print an error, reset, and continue
 					// print the error message
 					lexerError(fileIndex,row,col,"token mangled by stray character 0x"<<hex(c));
 					// also, reset state
-					resetState(s, state, tokenType);
+					resetState(state, tokenType, tokenLength);
 					// however, carry over the faulting character, as it might be useful for later debugging
 					carryOver = c;
 					// finally, continue from the top of the loop
@@ -181,40 +461,42 @@ lexerLoopTop: ;
 				// now, branch based on the type of transition it was
 				if (transition.tokenType == TOKEN_REGCOMMENT) { // if it's a transition into regular comment mode
 					// first, reset our state
-					resetState(s, state, tokenType);
+					resetState(state, tokenType, tokenLength);
 					// finally, scan and discard characters up to and including the next newline
-					for(;;) { // scan until we hit either EOF or a newline
-						bool retVal = (in == NULL ? cin.get(c) : in->get(c));
-						if (!retVal) { // if we hit EOF, flag the fact that we're done and jump to the top of the loop
-							done = true;
-							goto lexerLoopTop;
-						} else if (isNewLine(c)) { // if we hit a newline, break out of this loop and continue normally
-							row++;
-							col = 0;
-							break;
-						} else if (isTab(c)) {
-							col = (col - (col % tabModulus) + tabModulus);
-						} else {
-							col++;
-						}
+					const char *lineEnd = scanKernels.findAny(cur, end, '\n', '\n', '\n', '\n');
+					if (lineEnd == end) { // if we hit EOF, flag the fact that we're done and jump to the top of the loop
+						advancePosition(cur, end, row, col);
+						cur = end;
+						done = true;
+						goto lexerLoopTop;
 					}
+					// otherwise, we hit a newline, so consume it and continue normally
+					cur = lineEnd + 1;
+					row++;
+					col = 0;
 				} else if (transition.tokenType == TOKEN_STARCOMMENT) { // else if it's a transition into star comment mode
 					// first, reset our state
-					resetState(s, state, tokenType);
+					resetState(state, tokenType, tokenLength);
 					// next, scan and discard characters up to and including the next * /
 					char lastChar = '\0';
 					for(;;) { // scan until we hit either EOF or a * /
-						bool retVal = (in == NULL ? cin.get(c) : in->get(c));
-						if (isTab(c)) {
-							col = (col - (col % tabModulus) + tabModulus);
-						} else {
-							col++;
+						if (lastChar != '*') { // if we're not right after a *, skip ahead to the next character that matters
+							const char *runEnd = scanKernels.findAny(cur, end, '*', '\n', '\t', '*');
+							col += runEnd - cur;
+							cur = runEnd;
 						}
-						if (!retVal) { // if we hit EOF, flag a critical comment truncation error and signal that we're done
+						if (cur == end) { // if we hit EOF, flag a critical comment truncation error and signal that we're done
 							lexerError(fileIndex,rowStart,colStart,"/* comment truncated by EOF");
 							done = true;
 							goto lexerLoopTop;
-						} else if (isNewLine(c)) { // if we hit a newline, update the row and col as necessary
+						}
+						c = *cur++;
+						if (isTab(c)) {
+							col = (col - (col % tabModulus()) + tabModulus());
+						} else {
+							col++;
+						}
+						if (isNewLine(c)) { // if we hit a newline, update the row and col as necessary
 							row++;
 							col = 0;
 						} else if (lastChar == '*' && c == '/') { // else if we've found the end of the comment, simply break out of the loop
@@ -227,16 +509,26 @@ lexerLoopTop: ;
 					tokenType = transition.tokenType;
 					// pre-decide the terminal that should signal the end of the quote
 					char termChar = (tokenType == TOKEN_CQUOTE) ? '\'' : '\"';
+					// the quoted text starts right after the opening quote
+					tokenOffset = cur - in->data;
+					materialized = false;
 					// whether the last character seen was the escape character
 					bool lastCharWasEsc = false;
 					for(;;) { // scan until we hit either EOF or the termChar
-						bool retVal = (in == NULL ? cin.get(c) : in->get(c));
-						if (isTab(c)) {
-							col = (col - (col % tabModulus) + tabModulus);
-						} else {
-							col++;
+						if (!lastCharWasEsc) { // if we're not in the middle of an escape sequence, log the run of plain characters in bulk
+							const char *runEnd = scanKernels.findAny(cur, end, termChar, ESCAPE_CHARACTER, '\n', '\t');
+							unsigned int runLength = runEnd - cur;
+							if (runLength > (MAX_TOKEN_LENGTH-1) - tokenLength) { // leave any overflowing character to the regular path below
+								runLength = (MAX_TOKEN_LENGTH-1) - tokenLength;
+							}
+							if (materialized) {
+								s.append(cur, runLength);
+							}
+							tokenLength += runLength;
+							col += runLength;
+							cur += runLength;
 						}
-						if (!retVal) { // if we hit EOF, flag a critical comment truncation error and signal that we're done
+						if (cur == end) { // if we hit EOF, flag a critical comment truncation error and signal that we're done
 							if (termChar == '\'') {
 								lexerError(fileIndex,rowStart,colStart,"character literal truncated by EOF");
 							} else {
@@ -245,9 +537,20 @@ lexerLoopTop: ;
 							done = true;
 							goto lexerLoopTop;
 						}
+						c = *cur++;
+						if (isTab(c)) {
+							col = (col - (col % tabModulus()) + tabModulus());
+						} else {
+							col++;
+						}
 						// escape character handling
 						if (c == ESCAPE_CHARACTER && !lastCharWasEsc) { // if it's the escape character and not a double, log this and wait for the next character
 							lastCharWasEsc = true;
+							// the text can no longer be referenced in place, so switch to materializing it
+							if (!materialized) {
+								s.assign(in->data + tokenOffset, tokenLength);
+								materialized = true;
+							}
 							// continue so the character isn't logged, and the condition is unflagged
 							continue;
 						} else if (lastCharWasEsc) { // else if the last character was an escape character, specially handle this one
@@ -301,11 +604,15 @@ lexerLoopTop: ;
 								col = 0;
 								goto lexerLoopTop;
 							} else if (c == termChar) { // else if we've found the end of the quote
-								if (termChar == '\'' && s.size() > 1) { // if this is an overflowing CQUOTE, throw a CQUOTE overflow error
+								if (termChar == '\'' && tokenLength > 1) { // if this is an overflowing CQUOTE, throw a CQUOTE overflow error
 									lexerError(fileIndex,rowStart,colStart,"character literal overflow");
 								}
+								// if the text was materialized, move it into the arena
+								if (materialized) {
+									tokenOffset = in->materialize(s.data(), tokenLength);
+								}
 								// either way, commit the token and continue with processing
-								commitToken(s, state, tokenType, fileIndex, rowStart, colStart, outputVector, c);
+								commitToken(state, tokenType, tokenOffset, tokenLength, fileIndex, rowStart, colStart, ring);
 								break;
 							}
 						} else { // else if we *do* need to force the character to commit due to escaping
@@ -314,27 +621,30 @@ lexerLoopTop: ;
 						}
 
 						// character logging
-						if (s.size() < (MAX_TOKEN_LENGTH-1)) { // else if there is room in the buffer for this character, log it
-							s += c;
+						if (tokenLength < (MAX_TOKEN_LENGTH-1)) { // else if there is room in the buffer for this character, log it
+							if (materialized) {
+								s += c;
+							}
+							tokenLength++;
 						} else { // else if there is no more room in the buffer for this character, discard the token with an error
 							lexerError(fileIndex,rowStart,colStart,"quoted literal overflow");
 							// also, reset state and scan to the end of this token
-							resetState(s, state, tokenType);
-							discardToken(in, c, row, col, done);
+							resetState(state, tokenType, tokenLength);
+							discardToken(cur, end, c, row, col, done);
 							// finally, break out of the quote loop
 							break;
 						} // if there is room in the buffer
 					} // for (;;)
 				} else { // else if it's any other regular valid transition
-					if (s.size() < (MAX_TOKEN_LENGTH-1)) { // if there is room in the buffer for this character, log it
-						s += c;
+					if (tokenLength < (MAX_TOKEN_LENGTH-1)) { // if there is room in the buffer for this character, log it
+						tokenLength++;
 						tokenType = transition.tokenType;
 						state = transition.toState;
 					} else { // else if there is no more room in the buffer for this character, discard the token with an error
 						lexerError(fileIndex,rowStart,colStart,"token overflow");
 						// also, reset state and scan to the end of this token
-						resetState(s, state, tokenType);
-						discardToken(in, c, row, col, done);
+						resetState(state, tokenType, tokenLength);
+						discardToken(cur, end, c, row, col, done);
 					}
 				}
 			} else { // else if the transition isn't valid
@@ -342,17 +652,17 @@ lexerLoopTop: ;
 					lexerError(fileIndex,row,col,"stray character 0x"<<hex(c));
 					// now, reset the state and try to recover by eating up characters until we hit whitespace or EOF
 					// reset state
-					resetState(s, state, tokenType);
-					discardToken(in, c, row, col, done);
+					resetState(state, tokenType, tokenLength);
+					discardToken(cur, end, c, row, col, done);
 				} else if (tokenType == TOKEN_ERROR) { // else if it's an invalid transition from an error state, flag it
 					// print the error message
 					lexerError(fileIndex,row,col,"token truncated by stray character 0x"<<hex(c));
 					// also, reset state
-					resetState(s, state, tokenType);
+					resetState(state, tokenType, tokenLength);
 					// however, carry over the faulting character, as it might be useful for later debugging
 					carryOver = c;
 				} else { // else if there is a valid commit pending, do it and carry over this character for the next round
-					commitToken(s, state, tokenType, fileIndex, rowStart, colStart, outputVector, c);
+					commitToken(state, tokenType, tokenOffset, tokenLength, fileIndex, rowStart, colStart, ring);
 					// also, carry over the current character to the next round
 					carryOver = c;
 				}
@@ -362,24 +672,122 @@ lexerLoopTop: ;
 
 	// per-character loop is done now
 
-	// finally, test the error code to see if we should propagate it up the chain or return normally
-	if (lexerErrorCode) {
+	// if there were no errors, terminate the stream with the end token
+	// (the ring has room for it, since we checked at the top of the last pass through the loop)
+	if (!lexerErrorCode) {
+		Token termToken(TOKEN_END, in->materialize("EOF", 3), 3, fileIndex, 0, 0);
+		STAT_COUNT(STAT_TOKENS);
+		ring.push(termToken);
+	}
+	// either way, the input is exhausted
+	return false;
+}
+
+// TokenSource functions
+TokenSource::TokenSource() : ended(false) {}
+TokenSource::~TokenSource() {}
+Token TokenSource::next() {
+	if (ended) { // if the stream has already ended, keep repeating the end token
+		return Token(TOKEN_END);
+	}
+	Token retVal = pull();
+	if (retVal.tokenType == TOKEN_END) {
+		ended = true;
+	}
+	return retVal;
+}
+void TokenSource::drain() {
+	while (!ended) {
+		next();
+	}
+}
+
+VectorTokenSource::VectorTokenSource(vector<Token> *lexeme) : lexeme(lexeme), pos(0) {}
+VectorTokenSource::~VectorTokenSource() {}
+Token VectorTokenSource::pull() {
+	return (pos < lexeme->size()) ? (*lexeme)[pos++] : Token(TOKEN_END);
+}
+
+LexerTokenSource::LexerTokenSource(SourceBuffer *in, unsigned int fileIndex, ostream &lexerErrorStream) : lexer(in, fileIndex, lexerErrorStream), ring(TOKEN_RING_SIZE) {}
+LexerTokenSource::~LexerTokenSource() {}
+Token LexerTokenSource::pull() {
+	if (ring.empty()) { // if we've run out of tokens, lex some more
+		lexer.scan(ring);
+	}
+	// if the lexer failed, it doesn't produce an end token, so stand one in
+	return ring.empty() ? Token(TOKEN_END) : ring.pop();
+}
+
+TokenPipe::TokenPipe(unsigned int capacity) : ring(capacity) {
+	pthread_mutex_init(&lock, NULL);
+	pthread_cond_init(&notEmpty, NULL);
+	pthread_cond_init(&notFull, NULL);
+}
+TokenPipe::~TokenPipe() {
+	pthread_cond_destroy(&notFull);
+	pthread_cond_destroy(&notEmpty);
+	pthread_mutex_destroy(&lock);
+}
+void TokenPipe::put(TokenRing &batch) {
+	pthread_mutex_lock(&lock);
+	while (!batch.empty()) {
+		while (ring.full()) { // wait for the consumer to make room
+			pthread_cond_wait(&notFull, &lock);
+		}
+		while (!batch.empty() && !ring.full()) {
+			ring.push(batch.pop());
+		}
+		pthread_cond_signal(&notEmpty);
+	}
+	pthread_mutex_unlock(&lock);
+}
+Token TokenPipe::pull() {
+	pthread_mutex_lock(&lock);
+	while (ring.empty()) { // wait for the producer to supply some tokens
+		pthread_cond_wait(&notEmpty, &lock);
+	}
+	bool wasFull = ring.full();
+	Token retVal = ring.pop();
+	if (wasFull) {
+		pthread_cond_signal(&notFull);
+	}
+	pthread_mutex_unlock(&lock);
+	return retVal;
+}
+void TokenPipe::rearm() {
+	drain();
+	pthread_mutex_lock(&lock);
+	ended = false;
+	pthread_mutex_unlock(&lock);
+}
+
+// lexes the whole file into a token vector; returns NULL if there were errors
+vector<Token> *lex(SourceBuffer *in, unsigned int fileIndex, ostream &lexerErrorStream) {
+	vector<Token> *outputVector = new vector<Token>();
+	Lexer lexer(in, fileIndex, lexerErrorStream);
+	TokenRing ring(TOKEN_BATCH_SIZE);
+	for(;;) { // drain the ring into the vector until the lexer is done
+		bool moreInput = lexer.scan(ring);
+		while (!ring.empty()) {
+			outputVector->push_back(ring.pop());
+		}
+		if (!moreInput) {
+			break;
+		}
+	}
+	// test the error code to see if we should propagate it up the chain or return normally
+	if (lexer.lexerErrorCode) {
 		// deallocate the output vector, since we're just going to return null
 		delete outputVector;
 		return NULL;
-	} else {
-		// augment the vector with the end token
-		string eofString("EOF");
-		Token termToken(TOKEN_END, eofString, fileIndex, 0, 0);
-		outputVector->push_back(termToken);
-		// print out the lexeme if we're in verbose mode
-		VERBOSE(
-			for (unsigned int tokenIndex = 0; tokenIndex < outputVector->size(); tokenIndex++) {
-				cout << (*outputVector)[tokenIndex] << " " ;
-			} // per-token loop
-			cout << "\n";
-		)
-		// finally, return the vector to the caller
-		return outputVector;
 	}
+	// print out the lexeme if we're in verbose mode
+	VERBOSE(
+		for (unsigned int tokenIndex = 0; tokenIndex < outputVector->size(); tokenIndex++) {
+			outStream() << (*outputVector)[tokenIndex] << " " ;
+		} // per-token loop
+		outStream() << "\n";
+	)
+	// finally, return the vector to the caller
+	return outputVector;
 }
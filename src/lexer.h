@@ -5,27 +5,163 @@
 #include "constantDefs.h"
 #include "driver.h"
 
+#include "atoms.h"
+
 #include "../tmp/lexerStruct.h"
 
 class Token {
 	public:
 		// data members
 		int tokenType;
-		string s;
+		unsigned int offset; // the position of the token's text in its file's SourceBuffer
+		unsigned int length; // the length of the token's text
 		unsigned int fileIndex;
 		int row;
 		int col;
+		Atom atom; // the interned text of the token (identifiers only; NULL_ATOM otherwise)
 		// allocators/deallocators
 		Token(int tokenType = TOKEN_STD);
-		Token(int tokenType, const string &s, unsigned int fileIndex, int row, int col);
-		Token(const Token &otherToken);
-		~Token();
+		Token(int tokenType, unsigned int offset, unsigned int length, unsigned int fileIndex, int row, int col, Atom atom = NULL_ATOM);
+		// accessors
+		const char *text() const; // note: the returned text is not null-terminated
+		string s() const;
+		bool textEquals(const char *str) const;
 		// operators
-		Token &operator=(Token &otherToken);
 		operator string() const;
 };
 
-vector<Token> *lex(ifstream *in, unsigned int fileIndex);
+class SourceBuffer {
+	public:
+		// data members
+		const char *data; // the raw contents of the source file
+		size_t size; // the length of data, in bytes
+		bool mapped; // whether data is a memory mapping of the file (as opposed to a heap buffer)
+		string arena; // storage for token text that doesn't appear verbatim in data (e.g. escaped literals); addressed by offsets starting at size
+		// allocators/deallocators
+		SourceBuffer();
+		~SourceBuffer();
+		// loaders
+		bool load(const string &fileName); // map in the given file (or bulk-read standard input if it's STD_IN_FILE_NAME); returns false on failure
+		bool load(int fd); // bulk-read the given file descriptor until EOF; returns false on failure
+		// accessors
+		const char *text(unsigned int offset) const;
+		unsigned int materialize(const char *str, unsigned int length); // copy the given text into the arena and return its offset
+};
+
+class TokenRing {
+	public:
+		// data members
+		Token *tokens;
+		unsigned int capacity;
+		unsigned int head; // the index of the oldest token in the ring
+		unsigned int count; // the number of tokens currently in the ring
+		// allocators/deallocators
+		TokenRing(unsigned int capacity);
+		~TokenRing();
+		// accessors
+		bool empty() const;
+		bool full() const;
+		// core methods
+		void push(const Token &t);
+		Token pop();
+};
+
+class Lexer {
+	public:
+		// data members
+		SourceBuffer *in;
+		unsigned int fileIndex;
+		ostream &lexerErrorStream;
+		int lexerErrorCode;
+		bool finished; // whether the input has been exhausted (or lexing has been given up on)
+		// input cursor
+		const char *cur;
+		const char *end;
+		char carryOver; // a character to re-process before reading any further input
+		// the extent of the current token's text in the source buffer
+		unsigned int tokenOffset;
+		unsigned int tokenLength;
+		// buffer for quoted literals that need to be materialized (i.e. ones containing escape sequences)
+		string s;
+		bool materialized;
+		// state variables
+		int state;
+		int tokenType;
+		// the position in the file we're currently in
+		int row;
+		int col;
+		int rowStart;
+		int colStart;
+		bool done; // whether we've hit EOF
+		// allocators/deallocators
+		Lexer(SourceBuffer *in, unsigned int fileIndex, ostream &lexerErrorStream);
+		~Lexer();
+		// core methods
+		bool scan(TokenRing &ring); // lex tokens into the ring until it fills up or the input runs out; returns false once the input is exhausted
+	private:
+		bool scanTokens(TokenRing &ring);
+};
+
+// a pull-based source of tokens for the parser; every token stream ends with a TOKEN_END token
+class TokenSource {
+	public:
+		// data members
+		bool ended; // whether the TOKEN_END token has been handed out
+		// allocators/deallocators
+		TokenSource();
+		virtual ~TokenSource();
+		// core methods
+		Token next(); // get the next token (repeating TOKEN_END once the stream has ended)
+		void drain(); // discard the remaining tokens in the stream
+	protected:
+		virtual Token pull() = 0;
+};
+
+// a token source that reads from an already-lexed token vector
+class VectorTokenSource : public TokenSource {
+	public:
+		// data members
+		vector<Token> *lexeme;
+		unsigned int pos;
+		// allocators/deallocators
+		VectorTokenSource(vector<Token> *lexeme);
+		~VectorTokenSource();
+	protected:
+		Token pull();
+};
+
+// a token source that lexes its file on demand through a bounded token ring
+class LexerTokenSource : public TokenSource {
+	public:
+		// data members
+		Lexer lexer;
+		TokenRing ring;
+		// allocators/deallocators
+		LexerTokenSource(SourceBuffer *in, unsigned int fileIndex, ostream &lexerErrorStream);
+		~LexerTokenSource();
+	protected:
+		Token pull();
+};
+
+// a token source fed by a lexer running on another thread, through a bounded token ring
+class TokenPipe : public TokenSource {
+	public:
+		// data members
+		TokenRing ring;
+		pthread_mutex_t lock;
+		pthread_cond_t notEmpty;
+		pthread_cond_t notFull;
+		// allocators/deallocators
+		TokenPipe(unsigned int capacity);
+		~TokenPipe();
+		// core methods
+		void put(TokenRing &batch); // move all of the tokens in the batch into the pipe, blocking while it's full
+		void rearm(); // discard the rest of the current file's tokens, and start handing out the next file's
+	protected:
+		Token pull();
+};
+
+vector<Token> *lex(SourceBuffer *in, unsigned int fileIndex, ostream &lexerErrorStream);
 
 // post-includes
 
@@ -2,8 +2,8 @@
 #define LEXER_STRUCT_NODE_H
 
 struct lexerNodeStruct {
-	int tokenType;
-	int toState;
+	short tokenType;
+	short toState;
 };
 typedef struct lexerNodeStruct LexerNode;
 
@@ -0,0 +1,14 @@
+#ifndef _LIBANIC_H_
+#define _LIBANIC_H_
+
+#include <iostream>
+
+// library interface to the compiler (libanic.a)
+
+// compiles as directed by the given command line (as in 'anic argv[1]...'), writing what would go to the standard output and error streams to out
+// and err instead; returns the exit code that anic would have returned
+// note: each call runs in its own compilation context (which frees everything that the call allocated), so any number of calls can run at once on
+// separate threads
+int anicCompile(int argc, char **argv, std::ostream &out, std::ostream &err);
+
+#endif
@@ -0,0 +1,18 @@
+#include "driver.h"
+
+#include "context.h"
+#include "server.h"
+
+int main(int argc, char **argv) {
+	// set up the compilation context that the whole run works in
+	CompilerContext context(cout, cerr);
+	compilerContext = &context;
+	// if there's a compile server running (and this isn't one being started), let it do the compiling
+	if (!(argc == 3 && strcmp(argv[1], "-D") == 0)) {
+		int exitCode;
+		if (forwardToServer(argc, argv, exitCode)) {
+			return exitCode;
+		}
+	}
+	return compile(argc, argv);
+}
@@ -1,24 +1,80 @@
 #include "parser.h"
 
 #include "outputOperators.h"
+#include "stats.h"
+#include "ast.h"
 
-// parser-global variables
+// parser tables
+#include "../tmp/ruleRhsLengthRaw.h"
+#include "../tmp/ruleLhsTokenTypeRaw.h"
+#include "../tmp/ruleLhsTokenStringRaw.h"
+#include "../tmp/parserNodeRaw.h"
+
+#define TRACE(s) if (traced) {s} // like VERBOSE, but resolved at compile time in the templated parse loop
+
+// looks up the transition for the given state and label in the compressed parse table
+inline ParserNode parserNode(unsigned int state, unsigned int label) {
+	unsigned int slot = parserBase[state] + label;
+	PackedParserNode node = (parserCheck[slot] == state) ? parserEntry[slot] : parserDefault[state];
+	ParserNode retVal = { (int)PARSER_NODE_ACTION(node), (unsigned int)PARSER_NODE_N(node) };
+	return retVal;
+}
+
+// TreeArena functions
+
+TreeArena::TreeArena() : cur(NULL), end(NULL) {}
+TreeArena::~TreeArena() {
+	release();
+}
+
+void *TreeArena::alloc(size_t size) {
+	size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1); // keep everything pointer-aligned
+	if (cur == NULL || (size_t)(end - cur) < size) { // if the current block is full, start a new one
+		size_t blockSize = (size > TREE_ARENA_BLOCK_SIZE) ? size : TREE_ARENA_BLOCK_SIZE;
+		cur = new char[blockSize];
+		end = cur + blockSize;
+		blocks.push_back(cur);
+	}
+	void *retVal = cur;
+	cur += size;
+	return retVal;
+}
 
-int parserErrorCode;
+void TreeArena::release() {
+	for (unsigned int i=0; i<blocks.size(); i++) {
+		delete[] blocks[i];
+	}
+	blocks.clear();
+	cur = end = NULL;
+}
 
 // Tree functions
 
 // constructors
-Tree::Tree(const Token &t) : t(t), next(NULL), back(NULL), child(NULL), parent(NULL), status(TypeStatus()) {}
-Tree::Tree(const Token &t, Tree *next, Tree *back, Tree *child, Tree *parent) : t(t), next(next), back(back), child(child), parent(parent), status(TypeStatus()) {}
-Tree::Tree(const TypeStatus &status) : next(NULL), back(NULL), child(NULL), parent(NULL), status(status) {}
-Tree::Tree(deque<unsigned int> *depthList) : t(TOKEN_RAW_VECTOR), next((Tree *)depthList) {}
+Tree::Tree(const Token &t) : t(t), next(NULL), back(NULL), child(NULL), parent(NULL), ast(NULL), status(TypeStatus()), claim(0), log(NULL) {
+	STAT_COUNT(STAT_TREE_NODES);
+}
+Tree::Tree(const Token &t, Tree *next, Tree *back, Tree *child, Tree *parent) : t(t), next(next), back(back), child(child), parent(parent), ast(NULL), status(TypeStatus()), claim(0), log(NULL) {
+	STAT_COUNT(STAT_TREE_NODES);
+}
+Tree::Tree(const TypeStatus &status) : next(NULL), back(NULL), child(NULL), parent(NULL), ast(NULL), status(status), claim(0), log(NULL) {
+	STAT_COUNT(STAT_TREE_NODES);
+}
+Tree::Tree(deque<unsigned int> *depthList) : t(TOKEN_RAW_VECTOR), next((Tree *)depthList), ast(NULL), claim(0), log(NULL) {
+	STAT_COUNT(STAT_TREE_NODES);
+}
 
-// destructor
-Tree::~Tree() {
-	delete next;
-	delete child;
+// arena allocators
+void *Tree::operator new(size_t size) { // nodes outside of the arenas belong to the compilation that allocated them
+	return allocNode(OWNED_TREES, size);
+}
+void *Tree::operator new(size_t size, TreeArena &arena) {
+	return arena.alloc(size);
+}
+void Tree::operator delete(void *ptr) {
+	freeNode(ptr);
 }
+void Tree::operator delete(void *ptr, TreeArena &arena) {} // arena memory is only released with the whole arena
 
 // core methods
 IRTree *Tree::code() const {
@@ -111,53 +167,101 @@ void Tree::operator&=(Tree *parent) {
 }
 
 // converters
-Tree::operator string() const {
+void Tree::atomPath(vector<Atom> &path) const {
+	path.clear();
 	if (*this == TOKEN_NonArrayedIdentifier || *this == TOKEN_ArrayedIdentifier || *this == TOKEN_OpenIdentifier) { // if this is an identifier-style Tree node, decode it
-		string retVal(child->t.s); // ID or DPERIOD
+		path.push_back((*child == TOKEN_ID) ? child->t.atom : ATOM_RECALL); // ID or DPERIOD
 		// invariant: cur is a non-NULL child of NonArrayedIdentifierSuffix, ArrayedIdentifierSuffix, or IdentifierSuffix
 		for(const Tree *cur = child->next->child; cur != NULL; cur = (cur->next->next != NULL) ? cur->next->next->child : NULL) {
 			// log the extension
 			const Tree *curn = cur->next; // ID, ArrayAccess, or TIMES
 			if (*curn == TOKEN_ID) {
-				retVal += '.';
-				retVal += curn->t.s;
+				path.push_back(curn->t.atom);
 			} else if (*curn == TOKEN_ArrayAccess) {
 				// check to make sure that the expressions are compatible with STD_INT
 				if (curn->child->next->next->next == NULL) { // if there's only one subscript
 					TypeStatus expStatus = getStatusExp(curn->child->next);
-					if (!(*expStatus >> *stdIntType)) { // if the types are incompatible, flag an error
+					if (!(*expStatus >> *stdIntType())) { // if the types are incompatible, flag an error
 						Token curToken = curn->child->next->t; // Exp
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"array subscript is invalid");
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (subscript type is "<<expStatus<<")");
 					}
-					retVal += ".[]";
+					path.push_back(ATOM_SUBSCRIPT);
 				} else { // else if this is an extent subscript
 					TypeStatus leftExpStatus = getStatusExp(curn->child->next);
-					if (!(*leftExpStatus >> *stdIntType)) { // if the types are incompatible, flag an error
+					if (!(*leftExpStatus >> *stdIntType())) { // if the types are incompatible, flag an error
 						Token curToken = curn->child->next->t; // Exp
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"left extent subscript is invalid");
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (subscript type is "<<leftExpStatus<<")");
 					}
 					TypeStatus rightExpStatus = getStatusExp(curn->child->next);
-					if (!(*rightExpStatus >> *stdIntType)) { // if the types are incompatible, flag an error
+					if (!(*rightExpStatus >> *stdIntType())) { // if the types are incompatible, flag an error
 						Token curToken = curn->child->next->next->next->t; // Exp
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"right extent subscript is invalid");
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (subscript type is "<<rightExpStatus<<")");
 					}
-					retVal += ".[:]";
+					path.push_back(ATOM_RANGE_SUBSCRIPT);
 				}
 			}
 		}
-		return retVal;
+	}
+}
+Tree::operator string() const {
+	vector<Atom> path;
+	atomPath(path);
+	if (!path.empty()) { // if this is an identifier-style Tree node, join up its path
+		return rebuildId(path, path.size()-1);
 	} else { // else if this is not an identifier-style Tree node, return a blank string
 		return "";
 	}
 }
 
+// ParserStack functions
+
+ParserStack::ParserStack(unsigned int capacity) : states(new unsigned int[capacity]), trees(new Tree *[capacity]), capacity(capacity), top(0) {
+	// push the initial state
+	states[0] = 0;
+	trees[0] = NULL;
+}
+ParserStack::~ParserStack() {
+	delete[] states;
+	delete[] trees;
+}
+
+unsigned int ParserStack::topState() const {
+	return states[top];
+}
+Tree *ParserStack::topTree() const {
+	return trees[top];
+}
+Tree *ParserStack::handle(unsigned int n) const {
+	return trees[top - n + 1];
+}
+
+void ParserStack::push(unsigned int state, Tree *tree) {
+	if (top + 1 == capacity) { // if the stack is full, double its size
+		unsigned int *newStates = new unsigned int[capacity * 2];
+		Tree **newTrees = new Tree *[capacity * 2];
+		memcpy(newStates, states, capacity * sizeof(unsigned int));
+		memcpy(newTrees, trees, capacity * sizeof(Tree *));
+		delete[] states;
+		delete[] trees;
+		states = newStates;
+		trees = newTrees;
+		capacity *= 2;
+	}
+	top++;
+	states[top] = state;
+	trees[top] = tree;
+}
+void ParserStack::pop(unsigned int n) {
+	top -= n;
+}
+
 // main parsing functions
 
-void shiftToken(Tree *&treeCur, Token &t) {
-	Tree *treeToAdd = new Tree(t, NULL, treeCur, NULL, NULL);
+void shiftToken(Tree *&treeCur, Token &t, TreeArena &treeArena) {
+	Tree *treeToAdd = new (treeArena) Tree(t, NULL, treeCur, NULL, NULL);
 	// link right from the current node
 	if (treeCur != NULL) {
 		*treeCur += treeToAdd;
@@ -166,8 +270,8 @@ void shiftToken(Tree *&treeCur, Token &t) {
 	treeCur = treeToAdd;
 }
 
-void promoteToken(Tree *&treeCur, Token &t) {
-	Tree *treeToAdd = new Tree(t, NULL, (treeCur != NULL) ? treeCur->back : NULL, treeCur, (treeCur != NULL) ? treeCur->parent : NULL);
+void promoteToken(Tree *&treeCur, Token &t, TreeArena &treeArena) {
+	Tree *treeToAdd = new (treeArena) Tree(t, NULL, (treeCur != NULL) ? treeCur->back : NULL, treeCur, (treeCur != NULL) ? treeCur->parent : NULL);
 	// relatch on the left
 	if (treeCur != NULL && treeCur->back != NULL) {
 		*(treeCur->back) += treeToAdd;
@@ -186,49 +290,44 @@ void promoteToken(Tree *&treeCur, Token &t) {
 }
 
 // treeCur is guaranteed not to be NULL in this case
-void shiftPromoteNullToken(Tree *&treeCur, Token &t) {
-	Tree *treeToAdd = new Tree(t, NULL, treeCur, NULL, NULL);
+void shiftPromoteNullToken(Tree *&treeCur, Token &t, TreeArena &treeArena) {
+	Tree *treeToAdd = new (treeArena) Tree(t, NULL, treeCur, NULL, NULL);
 	// link in the newly allocated node
 	*treeCur += treeToAdd;
 	// set treeCur to the newly allocated node
 	treeCur = treeToAdd;
 }
 
-int parse(vector<Token> *lexeme, Tree *&parseme, unsigned int fileIndex) {
+// the shift-reduce loop, specialized on whether it dumps a trace of the parser's actions (so that the untraced one carries no tracing code)
+template <bool traced> int parseLoop(TokenSource &lexeme, Tree *&parseme, TreeArena &treeArena, unsigned int fileIndex, ostream &parserErrorStream) {
 
 	// initialize local error code
-	parserErrorCode = 0;
-
-	// initialize parser structures
-#include "../tmp/ruleRhsLengthRaw.h"
-#include "../tmp/ruleLhsTokenTypeRaw.h"
-#include "../tmp/ruleLhsTokenStringRaw.h"
-#include "../tmp/parserNodeRaw.h"
+	int parserErrorCode = 0;
 
-	// iterate through the lexemes and do the actual parsing
+	// pull lexemes from the token source and do the actual parsing
 	// initialize the current bit of tree that we're examining
 	Tree *treeCur = NULL;
-	// initialize the state stack and push the initial state onto it
-	stack<unsigned int> stateStack;
-	stateStack.push(0);
+	// initialize the state stack (which starts out holding the initial state)
+	ParserStack stateStack(PARSER_STACK_SIZE);
 
-	for(vector<Token>::iterator lexemeIter = lexeme->begin(); lexemeIter != lexeme->end(); lexemeIter++) {
+	for(;;) {
+
+		// get the next token of input
+		Token t = lexeme.next();
 
 transitionParserState: ;
 
 		// get the current state off the top of the stack
-		unsigned int curState = stateStack.top();
-		// peek at the next token of input
-		Token &t = *lexemeIter;
+		unsigned int curState = stateStack.topState();
 		// get the transition node for the current state
-		ParserNode transition = parserNode[curState][t.tokenType];
+		ParserNode transition = parserNode(curState, t.tokenType);
 
 		// branch based on the type of action dictated by the transition
 		if (transition.action == ACTION_SHIFT) {
-			shiftToken(treeCur, t);
-			stateStack.push(transition.n);
+			shiftToken(treeCur, t, treeArena);
+			stateStack.push(transition.n, treeCur);
 
-			VERBOSE( cout << "\t" <<
+			TRACE( outStream() << "\t" <<
 				COLOREXP(SET_TERM(BRIGHT_CODE AND MAGENTA_CODE)) << "SHIFT" << COLOREXP(SET_TERM(RESET_CODE)) <<
 				"\t" << curState << "\t->\t" << transition.n << "\t[" <<
 				COLOREXP(SET_TERM(BRIGHT_CODE AND CYAN_CODE)) << tokenType2String(t.tokenType) << COLOREXP(SET_TERM(RESET_CODE)) <<
@@ -237,12 +336,10 @@ transitionParserState: ;
 		} else if (transition.action == ACTION_REDUCE) {
 			unsigned int numRhs = ruleRhsLength[transition.n];
 			int tokenType = ruleLhsTokenType[transition.n];
-			if (numRhs > 1) {
-				treeCur = treeCur->goBack(numRhs-1);
-			}
-			for (unsigned int i=0; i<numRhs; i++) {
-				stateStack.pop();
+			if (numRhs > 1) { // find the leftmost node of the handle
+				treeCur = stateStack.handle(numRhs);
 			}
+			stateStack.pop(numRhs);
 			// create the token that the promoted node will have
 			Token t;
 			t.tokenType = tokenType;
@@ -251,19 +348,18 @@ transitionParserState: ;
 			t.col = treeCur != NULL ? treeCur->t.col : 0;
 			// promote the current token, as appropriate
 			if (numRhs != 0 || treeCur == NULL) { // if it's not the NULL-shifting promotion case
-				promoteToken(treeCur, t);
+				promoteToken(treeCur, t, treeArena);
 			} else { // else if it is the NULL-shifting promotion case
-				shiftPromoteNullToken(treeCur, t); // note: the above case handles treeCur == NULL
+				shiftPromoteNullToken(treeCur, t, treeArena); // note: the above case handles treeCur == NULL
 			}
 			// take the goto branch of the new transition
-			int tempState = stateStack.top();
-			stateStack.push(parserNode[tempState][tokenType].n);
+			stateStack.push(parserNode(stateStack.topState(), tokenType).n, treeCur);
 
-			VERBOSE(
+			TRACE(
 				const char *tokenString = ruleLhsTokenString[transition.n];
-				cout << "\t" <<
+				outStream() << "\t" <<
 					COLOREXP(SET_TERM(BRIGHT_CODE AND GREEN_CODE)) << "REDUCE" << COLOREXP(SET_TERM(RESET_CODE)) <<
-					"\t" << curState << "\t->\t" << stateStack.top() << "\t<" <<
+					"\t" << curState << "\t->\t" << stateStack.topState() << "\t<" <<
 					COLOREXP(SET_TERM(BRIGHT_CODE AND CYAN_CODE)) << tokenString << COLOREXP(SET_TERM(RESET_CODE)) <<
 					">\n";
 			)
@@ -271,7 +367,7 @@ transitionParserState: ;
 			goto transitionParserState;
 		} else if (transition.action == ACTION_ACCEPT) {
 
-			VERBOSE( cout << "\t" <<
+			TRACE( outStream() << "\t" <<
 				COLOREXP(SET_TERM(BRIGHT_CODE AND WHITE_CODE)) << "ACCEPT" << COLOREXP(SET_TERM(RESET_CODE)) <<
 				"\n"; )
 
@@ -281,7 +377,7 @@ transitionParserState: ;
 			if (t.tokenType == TOKEN_CQUOTE || t.tokenType == TOKEN_SQUOTE) {
 				errorString += "quoted literal";
 			} else {
-				errorString += "\'" + t.s + "\'";
+				errorString += "\'" + t.s() + "\'";
 			}
 			parserError(fileIndex, t.row, t.col, errorString);
 			break;
@@ -290,10 +386,20 @@ transitionParserState: ;
 
 	if (parserErrorCode) { // if there was an error, clean up
 		// deallocate the unfinished tree, since there was an error anyway
-		delete treeCur;
-	} else { // else if there were no errors, log the root parseme into the return slot
+		treeArena.release();
+	} else { // else if there were no errors, lower the tree's expressions and log the root parseme into the return slot
+		lower(treeCur, treeArena);
 		parseme = treeCur;
 	}
 	// return to the caller
 	return parserErrorCode;
 }
+
+
+int parse(TokenSource &lexeme, Tree *&parseme, TreeArena &treeArena, unsigned int fileIndex, ostream &parserErrorStream) {
+	if (verboseOutput()) {
+		return parseLoop<true>(lexeme, parseme, treeArena, fileIndex, parserErrorStream);
+	} else {
+		return parseLoop<false>(lexeme, parseme, treeArena, fileIndex, parserErrorStream);
+	}
+}
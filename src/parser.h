@@ -16,6 +16,21 @@ class TypeStatus;
 class IRTree;
 class DataTree;
 
+// bump allocator for parse tree nodes; nodes are never freed individually, only all at once
+class TreeArena {
+	public:
+		// data members
+		vector<char *> blocks;
+		char *cur; // the next free byte in the current block
+		char *end; // the end of the current block
+		// allocators/deallocators
+		TreeArena();
+		~TreeArena();
+		// core methods
+		void *alloc(size_t size);
+		void release(); // frees every node allocated from the arena
+};
+
 class Tree {
 	public:
 		// data members
@@ -25,13 +40,21 @@ class Tree {
 		Tree *child;
 		Tree *parent;
 		SymbolTree *env; // the symbol environment in which this node occurs
+		Ast *ast; // the lowered form of this node (Exp, Primary, PrimaryBase, and BracketedExp only)
 		TypeStatus status; // the status coming OUT of this node
+		volatile unsigned int claim; // which thread is deriving status, during parallel semantic analysis (see StatusClaim)
+		StatusLog *log; // the errors and memoized calls logged while deriving status in parallel; NULL if there were none
 		// allocators/deallocators
 		Tree(const Token &t);
 		Tree(const Token &t, Tree *next, Tree *back, Tree *child, Tree *parent);
 		Tree(const TypeStatus &status);
 		Tree(deque<unsigned int> *depthList);
-		~Tree();
+		// note: Trees don't own anything (see StatusLog for their logs), so they're trivially destructible and arena nodes are simply released with their arena
+		// arena allocators
+		void *operator new(size_t size);
+		void *operator new(size_t size, TreeArena &arena);
+		void operator delete(void *ptr);
+		void operator delete(void *ptr, TreeArena &arena);
 		// core methods
 		IRTree *code() const;
 		Type &typeRef() const;
@@ -52,10 +75,31 @@ class Tree {
 		void operator*=(Tree *child);
 		void operator&=(Tree *parent);
 		// converters
+		void atomPath(vector<Atom> &path) const; // only for identifier kinds; typechecks any array subscripts along the way
 		operator string() const; // only for SuffixedIdentifier or NonArraySuffixedIdentifier kinds
 };
 
-int parse(vector<Token> *lexeme, Tree *&parseme, unsigned int fileIndex);
+// the parser's state stack, with a parallel stack of the Tree nodes that were shifted or promoted into each state
+class ParserStack {
+	public:
+		// data members
+		unsigned int *states;
+		Tree **trees;
+		unsigned int capacity;
+		unsigned int top; // the index of the top entry
+		// allocators/deallocators
+		ParserStack(unsigned int capacity);
+		~ParserStack();
+		// accessors
+		unsigned int topState() const;
+		Tree *topTree() const;
+		Tree *handle(unsigned int n) const; // the leftmost of the top n Tree nodes
+		// core methods
+		void push(unsigned int state, Tree *tree);
+		void pop(unsigned int n);
+};
+
+int parse(TokenSource &lexeme, Tree *&parseme, TreeArena &treeArena, unsigned int fileIndex, ostream &parserErrorStream);
 
 // post-includes
 #include "semmer.h"
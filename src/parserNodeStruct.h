@@ -14,4 +14,15 @@ struct parserNodeStruct {
 };
 typedef struct parserNodeStruct ParserNode;
 
+// packed 16-bit representation used in the generated tables: the action in the high bits, and n in the low ones
+typedef unsigned short PackedParserNode;
+
+#define PARSER_NODE_N_BITS 13
+#define MAX_PARSER_NODE_N ((1 << PARSER_NODE_N_BITS) - 1)
+#define PACK_PARSER_NODE(action, n) ((PackedParserNode)(((action) << PARSER_NODE_N_BITS) | (n)))
+#define PARSER_NODE_ACTION(p) ((p) >> PARSER_NODE_N_BITS)
+#define PARSER_NODE_N(p) ((p) & MAX_PARSER_NODE_N)
+
+#define PARSER_NO_STATE 0xFFFF // marks an unused slot in the compressed table's check vector
+
 #endif
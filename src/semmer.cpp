@@ -1,62 +1,549 @@
 #include "semmer.h"
 
 #include "outputOperators.h"
+#include "cache.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <set>
+using std::sort;
+using std::set;
 
 // semmer-global variables
 
-int semmerErrorCode;
-
-Type *nullType;
-Type *errType;
-StdType *stdBoolType;
-StdType *stdIntType;
-StdType *stdFloatType;
-StdType *stdCharType;
-StdType *stdStringType;
-StdType *stdBoolLitType;
-StdType *inIntType;
-StdType *inFloatType;
-StdType *inCharType;
-StdType *inStringType;
-ObjectType *stringerType;
-ObjectType *boolUnOpType;
-ObjectType *intUnOpType;
-ObjectType *boolBinOpType;
-ObjectType *intBinOpType;
-ObjectType *floatBinOpType;
-ObjectType *boolCompOpType;
-ObjectType *intCompOpType;
-ObjectType *floatCompOpType;
-ObjectType *charCompOpType;
-ObjectType *stringCompOpType;
-StdType *stdLibType;
-SymbolTree *stdLib;
-IRTree *nopCode;
+__thread bool semmerErrorMuted = false; // whether errors are being raised while formatting another error
+
+StdTypes sharedStdTypes; // the standard types, which every compilation's context points at (see initSemmerGlobals())
+pthread_once_t stdTypesBuilt = PTHREAD_ONCE_INIT; // the standard types are built once per process, the first time that they're needed
+
+// parallel semmer state
+__thread unsigned int semmerWorkerId = 0; // this thread's worker id (1 and up) in the parallel semmer; 0 outside of it
+__thread unsigned int semmerTask = 0; // the number of the task that this thread is running in the parallel semmer
+__thread StatusClaim *currentStatusClaim = NULL; // the innermost node that this thread is deriving the status of
+__thread BindingCache *workerBindingCache = NULL; // this worker's private bindId() cache
+
+// SymbolScope functions
+SymbolScope::SymbolScope() : keys(NULL), values(NULL), capacity(0), count(0), orderValid(true) {}
+SymbolScope::SymbolScope(const SymbolScope &other) : keys(NULL), values(NULL), capacity(0), count(0), orderValid(false) {
+	*this = other;
+}
+SymbolScope::~SymbolScope() {
+	delete[] keys;
+	delete[] values;
+}
+unsigned int SymbolScope::size() const {
+	return count;
+}
+unsigned int SymbolScope::slot(Atom key, unsigned int capacity) {
+	return (key * 2654435761u) & (capacity-1); // multiplicative hash; atoms are dense, so this spreads runs of them across the table
+}
+SymbolTree *SymbolScope::find(Atom key) const {
+	if (semmerMode() == SEMMER_THREADED) { // other threads might be adding fake nodes, so read optimistically and retry if anything was written meanwhile
+		for(;;) {
+			unsigned int version = __atomic_load_n(&compilerContext->scopeVersion, __ATOMIC_ACQUIRE); // (what probe() finds was published by the write that left this version)
+			if (!(version & 1)) {
+				SymbolTree *retVal = probe(key);
+				__sync_synchronize();
+				if (__atomic_load_n(&compilerContext->scopeVersion, __ATOMIC_RELAXED) == version) {
+					return retVal;
+				}
+			}
+		}
+	}
+	if (count == 0) {
+		return NULL;
+	}
+	for (unsigned int pos = slot(key, capacity); keys[pos] != NULL_ATOM; pos = (pos+1) & (capacity-1)) {
+		if (keys[pos] == key) {
+			return values[pos];
+		}
+	}
+	return NULL;
+}
+// like find(), but safe (if not necessarily correct) to run concurrently with a write; the result is only valid if no write happened meanwhile
+SymbolTree *SymbolScope::probe(Atom key) const {
+	unsigned int probeCapacity = capacity;
+	__sync_synchronize(); // grow() publishes its arrays before their capacity, so the arrays are at least this big
+	Atom *probeKeys = keys;
+	SymbolTree **probeValues = values;
+	if (probeCapacity == 0) {
+		return NULL;
+	}
+	unsigned int pos = slot(key, probeCapacity);
+	for (unsigned int i=0; i < probeCapacity && probeKeys[pos] != NULL_ATOM; i++, pos = (pos+1) & (probeCapacity-1)) {
+		if (probeKeys[pos] == key) {
+			return probeValues[pos];
+		}
+	}
+	return NULL;
+}
+// orders scope entries by the text of their keys
+struct ScopeEntryCmp {
+	bool operator()(const pair<Atom, SymbolTree *> &a, const pair<Atom, SymbolTree *> &b) const {
+		return (atomString(a.first) < atomString(b.first));
+	}
+};
+const vector<SymbolTree *> &SymbolScope::sorted() const {
+	if (semmerMode() == SEMMER_THREADED) { // other threads might be adding fake nodes, so rebuild under the write lock
+		pthread_mutex_lock(&compilerContext->scopeWriteLock);
+		sortInternal();
+		pthread_mutex_unlock(&compilerContext->scopeWriteLock);
+	} else {
+		sortInternal();
+	}
+	return order;
+}
+void SymbolScope::sortInternal() const {
+	if (orderValid) {
+		return;
+	}
+	vector<pair<Atom, SymbolTree *> > entries;
+	entries.reserve(count);
+	for (unsigned int i=0; i<capacity; i++) {
+		if (keys[i] != NULL_ATOM) {
+			entries.push_back(make_pair(keys[i], values[i]));
+		}
+	}
+	sort(entries.begin(), entries.end(), ScopeEntryCmp());
+	order.clear();
+	for (unsigned int i=0; i<entries.size(); i++) {
+		order.push_back(entries[i].second);
+	}
+	orderValid = true;
+}
+void SymbolScope::grow() {
+	unsigned int newCapacity = (capacity == 0) ? SYMBOL_SCOPE_INITIAL_SIZE : capacity*2;
+	Atom *newKeys = new Atom[newCapacity];
+	SymbolTree **newValues = new SymbolTree *[newCapacity];
+	for (unsigned int i=0; i<newCapacity; i++) {
+		newKeys[i] = NULL_ATOM;
+	}
+	for (unsigned int i=0; i<capacity; i++) {
+		if (keys[i] != NULL_ATOM) {
+			unsigned int pos = slot(keys[i], newCapacity);
+			while (newKeys[pos] != NULL_ATOM) {
+				pos = (pos+1) & (newCapacity-1);
+			}
+			newKeys[pos] = keys[i];
+			newValues[pos] = values[i];
+		}
+	}
+	// publish the new arrays before the new capacity, so that lock-free readers never index past the end of the arrays that they see
+	Atom *oldKeys = keys;
+	SymbolTree **oldValues = values;
+	keys = newKeys;
+	values = newValues;
+	__sync_synchronize();
+	capacity = newCapacity;
+	if (semmerMode() == SEMMER_THREADED) { // readers might still be probing the old arrays, so keep them around until the workers are done
+		compilerContext->retiredScopeKeys.push_back(oldKeys);
+		compilerContext->retiredScopeValues.push_back(oldValues);
+	} else {
+		delete[] oldKeys;
+		delete[] oldValues;
+	}
+}
+bool SymbolScope::insert(Atom key, SymbolTree *value) {
+	if ((count+1)*4 > capacity*3) { // keep the load factor at or below three quarters
+		grow();
+	}
+	unsigned int pos = slot(key, capacity);
+	for (; keys[pos] != NULL_ATOM; pos = (pos+1) & (capacity-1)) {
+		if (keys[pos] == key) {
+			return false;
+		}
+	}
+	keys[pos] = key;
+	values[pos] = value;
+	count++;
+	orderValid = false;
+	if (compilerContext->scopeInsertLog != NULL) {
+		compilerContext->scopeInsertLog->push_back(key);
+	}
+	return true;
+}
+void SymbolScope::erase(Atom key) {
+	if (count == 0) {
+		return;
+	}
+	unsigned int pos = slot(key, capacity);
+	for (; keys[pos] != key; pos = (pos+1) & (capacity-1)) {
+		if (keys[pos] == NULL_ATOM) { // if the key isn't present, there's nothing to do
+			return;
+		}
+	}
+	// shift back any later entries in the probe run that would otherwise become unreachable
+	unsigned int hole = pos;
+	for (unsigned int cur = (hole+1) & (capacity-1); keys[cur] != NULL_ATOM; cur = (cur+1) & (capacity-1)) {
+		unsigned int home = slot(keys[cur], capacity);
+		if (((cur - home) & (capacity-1)) >= ((cur - hole) & (capacity-1))) { // if the entry's home is at or before the hole, it can move into it
+			keys[hole] = keys[cur];
+			values[hole] = values[cur];
+			hole = cur;
+		}
+	}
+	keys[hole] = NULL_ATOM;
+	count--;
+	orderValid = false;
+}
+SymbolScope &SymbolScope::operator=(const SymbolScope &other) {
+	if (this != &other) {
+		if (capacity != other.capacity) {
+			delete[] keys;
+			delete[] values;
+			capacity = other.capacity;
+			keys = (capacity != 0) ? new Atom[capacity] : NULL;
+			values = (capacity != 0) ? new SymbolTree *[capacity] : NULL;
+		}
+		for (unsigned int i=0; i<capacity; i++) {
+			keys[i] = other.keys[i];
+			values[i] = other.values[i];
+		}
+		count = other.count;
+		orderValid = false;
+	}
+	return *this;
+}
+
+// BindingCache functions
+BindingCache::BindingCache() : capacity(BINDING_CACHE_INITIAL_SIZE) {
+	slots = new unsigned int[capacity];
+	for (unsigned int i=0; i<capacity; i++) {
+		slots[i] = 0;
+	}
+}
+BindingCache::~BindingCache() {
+	delete[] slots;
+}
+unsigned int BindingCache::hashKey(SymbolTree *env, const vector<Atom> &path, Type *recallType) {
+	// FNV-1a over the key components
+	unsigned int hash = 2166136261u;
+	hash = (hash ^ (unsigned int)(uintptr_t)env) * 16777619u;
+	hash = (hash ^ (unsigned int)(uintptr_t)recallType) * 16777619u;
+	for (unsigned int i=0; i<path.size(); i++) {
+		hash = (hash ^ path[i]) * 16777619u;
+	}
+	return hash;
+}
+bool BindingCache::matches(const BindingCacheEntry &entry, SymbolTree *env, const vector<Atom> &path, Type *recallType) const {
+	if (entry.env != env || entry.recallType != recallType || entry.pathLength != path.size()) {
+		return false;
+	}
+	for (unsigned int i=0; i<path.size(); i++) {
+		if (pathPool[entry.pathOffset + i] != path[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+const BindingCacheEntry *BindingCache::find(SymbolTree *env, const vector<Atom> &path, Type *recallType) const {
+	unsigned int hash = hashKey(env, path, recallType);
+	for (unsigned int pos = hash & (capacity-1); slots[pos] != 0; pos = (pos+1) & (capacity-1)) {
+		const BindingCacheEntry &entry = entries[slots[pos]-1];
+		if (entry.hash == hash && matches(entry, env, path, recallType)) {
+			return &entry;
+		}
+	}
+	return NULL;
+}
+void BindingCache::grow() {
+	delete[] slots;
+	capacity *= 2;
+	slots = new unsigned int[capacity];
+	for (unsigned int i=0; i<capacity; i++) {
+		slots[i] = 0;
+	}
+	for (unsigned int i=0; i<entries.size(); i++) {
+		unsigned int pos = entries[i].hash & (capacity-1);
+		while (slots[pos] != 0) {
+			pos = (pos+1) & (capacity-1);
+		}
+		slots[pos] = i+1;
+	}
+}
+void BindingCache::insert(SymbolTree *env, const vector<Atom> &path, Type *recallType, SymbolTree *st, bool needsConstantization) {
+	if ((entries.size()+1)*2 > capacity) { // keep the load factor at or below one half
+		grow();
+	}
+	BindingCacheEntry entry;
+	entry.hash = hashKey(env, path, recallType);
+	entry.env = env;
+	entry.recallType = recallType;
+	entry.pathOffset = pathPool.size();
+	entry.pathLength = path.size();
+	entry.st = st;
+	entry.needsConstantization = needsConstantization;
+	pathPool.insert(pathPool.end(), path.begin(), path.end());
+	entries.push_back(entry);
+	unsigned int pos = entry.hash & (capacity-1);
+	while (slots[pos] != 0) {
+		pos = (pos+1) & (capacity-1);
+	}
+	slots[pos] = entries.size();
+}
+void BindingCache::clear() {
+	if (entries.empty()) {
+		return;
+	}
+	for (unsigned int i=0; i<capacity; i++) {
+		slots[i] = 0;
+	}
+	entries.clear();
+	pathPool.clear();
+}
+
+// StatusEvent functions
+StatusEvent::StatusEvent(StatusLog **callee, SymbolTree *root, const string &text) : callee(callee), root(root), text(text) {}
+StatusEvent::~StatusEvent() {}
+
+// StatusLog functions
+StatusLog::StatusLog() : replayed(false), nextLog(NULL) {}
+StatusLog::~StatusLog() {}
+// reports the logged errors in the order that the sequential semmer would have, by replaying each called node's log in place of its first call
+void StatusLog::replay() {
+	replayed = true;
+	for (unsigned int i=0; i < events.size(); i++) {
+		const StatusEvent &event = events[i];
+		if (event.callee == NULL) { // if it's an error, report it
+			errStream() << event.text;
+			semmerErrorCode()++;
+		} else if (*(event.callee) != NULL && !((*(event.callee))->replayed)) { // else if it's the first call to a node that logged something, the node would have been derived here
+			(*(event.callee))->replay();
+		} else if (event.root != NULL && event.root->defSite->status.type->category != CATEGORY_ERRORTYPE) { // else if it's a repeated SymbolTree lookup, redo its check
+			verifyCopyImport(event.root);
+		}
+	}
+}
+
+// StatusClaim functions
+StatusClaim::StatusClaim(volatile unsigned int &claim, StatusLog *&log) : claim(claim), log(log), root(NULL), owned(false), prev(NULL), contextual(false) {}
+StatusClaim::~StatusClaim() {
+	if (owned) { // if we claimed the node, log the call in the caller's log, publish the node's status, and wake up anyone waiting for it
+		currentStatusClaim = prev;
+		recordCall(root);
+		if (__sync_fetch_and_or(&claim, CLAIM_DONE | (contextual ? CLAIM_CONTEXTUAL : 0)) & CLAIM_WAITERS) { // (the claim word already holds our task)
+			pthread_mutex_lock(&compilerContext->statusClaimLock);
+			pthread_cond_broadcast(&compilerContext->statusClaimPublished);
+			pthread_mutex_unlock(&compilerContext->statusClaimLock);
+		}
+	}
+}
+// determines whether the caller has to derive the node's status, waiting for other threads deriving it if necessary
+int StatusClaim::acquire(const TypeStatus &status, SymbolTree *root, bool contextual) {
+	if (semmerMode() == SEMMER_SEQUENTIAL) {
+		return (status.type != NULL) ? CLAIM_MEMOIZED : CLAIM_COMPUTE;
+	} else if (semmerMode() == SEMMER_REPLAY) { // replay the node's log in place of the call that would have derived it
+		if (status.type != NULL && log != NULL && !(log->replayed)) {
+			log->replay();
+			return CLAIM_SETTLED;
+		}
+		return (status.type != NULL) ? CLAIM_MEMOIZED : CLAIM_COMPUTE;
+	}
+	// otherwise, we're in the threaded semmer
+	for(;;) {
+		unsigned int cur = __atomic_load_n(&claim, __ATOMIC_ACQUIRE);
+		if (cur == CLAIM_FREE) { // claim the node if nobody has (re-reading the claim word if somebody just did)
+			cur = __sync_val_compare_and_swap(&claim, CLAIM_FREE, semmerTask);
+		}
+		if (cur == CLAIM_FREE) { // if we claimed the node, derive it (the call is logged once the node is derived, since nothing else can be logged in between)
+			if (status.type != NULL) { // if the status was derived before typing went parallel (or is predefined), publish it as it is and use it
+				if (__sync_lock_test_and_set(&claim, CLAIM_DONE) & CLAIM_WAITERS) {
+					pthread_mutex_lock(&compilerContext->statusClaimLock);
+					pthread_cond_broadcast(&compilerContext->statusClaimPublished);
+					pthread_mutex_unlock(&compilerContext->statusClaimLock);
+				}
+				return CLAIM_MEMOIZED;
+			}
+			this->root = root;
+			owned = true;
+			this->contextual = contextual;
+			prev = currentStatusClaim;
+			currentStatusClaim = this;
+			return CLAIM_COMPUTE;
+		} else if (cur & CLAIM_DONE) { // else if the status has been published, log the call and use it
+			if (!(cur & CLAIM_TASK)) { // if it was derived before typing went parallel, nothing was logged for it
+				return CLAIM_MEMOIZED;
+			}
+			checkOrder(cur);
+			recordCall(root);
+			return CLAIM_SETTLED;
+		} else if ((cur & CLAIM_TASK) == semmerTask) { // else if this thread is deriving the node further up its stack, do what the sequential semmer would
+			// unless the node is simply being handed on to another typing function (as getStatusSymbolTree() does with declarations),
+			// everything between here and the node is now being derived from the node's partial status, so it depends on where the recursion was entered
+			for (StatusClaim *stackCur = currentStatusClaim; stackCur != NULL && &(currentStatusClaim->claim) != &claim; stackCur = stackCur->prev) {
+				stackCur->contextual = true;
+				if (&(stackCur->claim) == &claim) {
+					break;
+				}
+			}
+			return (status.type != NULL) ? CLAIM_MEMOIZED : CLAIM_COMPUTE;
+		} else if (!wait()) { // else if waiting for the owner would deadlock, give up on the phase (the sequential semmer would have derived the node inside the owner's derivation)
+			__sync_lock_test_and_set(&compilerContext->semmerOutOfOrder, 1);
+			return CLAIM_ABANDONED;
+		}
+	}
+}
+void StatusClaim::record(const StatusEvent &event) {
+	if (log == NULL) {
+		log = new StatusLog();
+		// hand the log over to the compilation, which frees it along with the rest of the compilation's nodes
+		StatusLog *head = NULL;
+		do {
+			log->nextLog = head;
+			head = __sync_val_compare_and_swap(&compilerContext->statusLogs, log->nextLog, log);
+		} while (head != log->nextLog);
+	}
+	log->events.push_back(event);
+}
+// logs a call to this claim's node against the node that this thread is deriving
+// note: calls to nodes that are done deriving and logged nothing themselves are left out, since replaying them would do nothing
+void StatusClaim::recordCall(SymbolTree *root) {
+	if (currentStatusClaim != NULL && log != NULL) {
+		currentStatusClaim->record(StatusEvent(&log, root, string()));
+	}
+}
+// flags the parallel phase as out of order if the given published claim was derived by a later task (which the sequential semmer would have left to this one) in a way that depended on the context
+void StatusClaim::checkOrder(unsigned int cur) {
+	if ((cur & CLAIM_CONTEXTUAL) && (cur & CLAIM_TASK) > semmerTask) {
+		__sync_lock_test_and_set(&compilerContext->semmerOutOfOrder, 1);
+	}
+}
+// returns the worker running the task that holds the given claim word (0 if none does)
+unsigned int claimOwner(unsigned int cur) {
+	if (cur != CLAIM_FREE && !(cur & CLAIM_DONE)) {
+		for (unsigned int i=1; i < compilerContext->semmerWorkerTasks.size(); i++) {
+			if (compilerContext->semmerWorkerTasks[i] == (cur & CLAIM_TASK)) {
+				return i;
+			}
+		}
+	}
+	return 0;
+}
+// blocks until the claim is published; returns false (without waiting) if the claim's owner is itself waiting on this thread, directly or not
+bool StatusClaim::wait() {
+	bool retVal = true;
+	pthread_mutex_lock(&compilerContext->statusClaimLock);
+	for(;;) {
+		unsigned int cur = __atomic_load_n(&claim, __ATOMIC_ACQUIRE);
+		if (cur & CLAIM_DONE) {
+			break;
+		}
+		if (!(cur & CLAIM_WAITERS) && !__sync_bool_compare_and_swap(&claim, cur, cur | CLAIM_WAITERS)) { // flag that there's a waiter; if the claim changed meanwhile, re-check it
+			continue;
+		}
+		// follow the chain of owners waiting on other owners; if it leads back to this thread, waiting would deadlock
+		unsigned int owner = claimOwner(cur);
+		for (unsigned int i=0; i < compilerContext->statusClaimWaits.size() && owner != 0 && owner != semmerWorkerId; i++) {
+			volatile unsigned int *ownerWait = compilerContext->statusClaimWaits[owner];
+			owner = (ownerWait != NULL) ? claimOwner(__atomic_load_n(ownerWait, __ATOMIC_ACQUIRE)) : 0;
+		}
+		if (owner == semmerWorkerId) {
+			retVal = false;
+			break;
+		}
+		compilerContext->statusClaimWaits[semmerWorkerId] = &claim;
+		pthread_cond_wait(&compilerContext->statusClaimPublished, &compilerContext->statusClaimLock);
+		compilerContext->statusClaimWaits[semmerWorkerId] = NULL;
+	}
+	pthread_mutex_unlock(&compilerContext->statusClaimLock);
+	return retVal;
+}
+
+// logs an error raised in the threaded semmer against the node being derived, so that it can be replayed in order later
+void logSemmerError(const string &text) {
+	__sync_fetch_and_add(&compilerContext->semmerErrorsLogged, 1);
+	if (currentStatusClaim != NULL) {
+		currentStatusClaim->record(StatusEvent(NULL, NULL, text));
+	} // otherwise, the error came from a task's own lookup of a memoized node, which the replay redoes anyway
+}
+
+// SemmerTaskQueue functions
+SemmerTaskQueue::SemmerTaskQueue(unsigned int head, unsigned int tail) : head(head), tail(tail) {
+	pthread_mutex_init(&lock, NULL);
+}
+SemmerTaskQueue::~SemmerTaskQueue() {
+	pthread_mutex_destroy(&lock);
+}
+bool SemmerTaskQueue::pop(unsigned int &task) {
+	pthread_mutex_lock(&lock);
+	bool retVal = (head < tail);
+	if (retVal) {
+		task = head++;
+	}
+	pthread_mutex_unlock(&lock);
+	return retVal;
+}
+bool SemmerTaskQueue::steal(unsigned int &task) {
+	pthread_mutex_lock(&lock);
+	bool retVal = (head < tail);
+	if (retVal) {
+		task = --tail;
+	}
+	pthread_mutex_unlock(&lock);
+	return retVal;
+}
+
+// SemmerPool functions
+// deals the tasks out to the workers in contiguous runs, so that each worker starts on neighbouring (and likely related) nodes
+SemmerPool::SemmerPool(unsigned int numTasks, unsigned int numWorkers, void (*work)(unsigned int task)) : work(work), nextWorkerId(0), context(compilerContext) {
+	for (unsigned int i=0; i<numWorkers; i++) {
+		queues.push_back(new SemmerTaskQueue((unsigned int)((unsigned long)numTasks*i/numWorkers), (unsigned int)((unsigned long)numTasks*(i+1)/numWorkers)));
+	}
+}
+SemmerPool::~SemmerPool() {
+	for (unsigned int i=0; i<queues.size(); i++) {
+		delete queues[i];
+	}
+}
 
 // SymbolTree functions
-SymbolTree::SymbolTree(int kind, const string &id, Tree *defSite, SymbolTree *copyImportSite) : kind(kind), id(id), defSite(defSite), copyImportSite(copyImportSite), parent(NULL),
-		offsetKindInternal(OFFSET_NULL), numRaws(0), numBlocks(0), numPartitions(0) {
+SymbolTree::SymbolTree(int kind, const string &id, Tree *defSite, SymbolTree *copyImportSite) : kind(kind), id(id), atom(intern(id)), defSite(defSite), copyImportSite(copyImportSite), parent(NULL),
+		offsetKindInternal(OFFSET_NULL), numRaws(0), numBlocks(0), numPartitions(0), numShares(0) {
+	STAT_COUNT(STAT_SYMBOL_TREE_NODES);
+	if (defSite != NULL) {
+		defSite->env = this;
+	}
+}
+SymbolTree::SymbolTree(int kind, const char *id, Tree *defSite, SymbolTree *copyImportSite) : kind(kind), id(id), atom(intern(this->id)), defSite(defSite), copyImportSite(copyImportSite), parent(NULL), 
+		offsetKindInternal(OFFSET_NULL), numRaws(0), numBlocks(0), numPartitions(0), numShares(0) {
+	STAT_COUNT(STAT_SYMBOL_TREE_NODES);
 	if (defSite != NULL) {
 		defSite->env = this;
 	}
 }
-SymbolTree::SymbolTree(int kind, const char *id, Tree *defSite, SymbolTree *copyImportSite) : kind(kind), id(id), defSite(defSite), copyImportSite(copyImportSite), parent(NULL), 
-		offsetKindInternal(OFFSET_NULL), numRaws(0), numBlocks(0), numPartitions(0) {
+SymbolTree::SymbolTree(int kind, Atom id, Tree *defSite, SymbolTree *copyImportSite) : kind(kind), id(atomString(id)), atom(id), defSite(defSite), copyImportSite(copyImportSite), parent(NULL),
+		offsetKindInternal(OFFSET_NULL), numRaws(0), numBlocks(0), numPartitions(0), numShares(0) {
+	STAT_COUNT(STAT_SYMBOL_TREE_NODES);
 	if (defSite != NULL) {
 		defSite->env = this;
 	}
 }
-SymbolTree::SymbolTree(int kind, const string &id, Type *defType, SymbolTree *copyImportSite) : kind(kind), id(id), copyImportSite(copyImportSite), parent(NULL),
-		offsetKindInternal(OFFSET_NULL), numRaws(0), numBlocks(0), numPartitions(0){
+SymbolTree::SymbolTree(int kind, const string &id, Type *defType, SymbolTree *copyImportSite) : kind(kind), id(id), atom(intern(id)), copyImportSite(copyImportSite), parent(NULL),
+		offsetKindInternal(OFFSET_NULL), numRaws(0), numBlocks(0), numPartitions(0), numShares(0){
+	STAT_COUNT(STAT_SYMBOL_TREE_NODES);
+	TypeStatus status(defType, NULL); defSite = new Tree(status); defSite->env = this;
+}
+SymbolTree::SymbolTree(int kind, const char *id, Type *defType, SymbolTree *copyImportSite) : kind(kind), id(id), atom(intern(this->id)), copyImportSite(copyImportSite), parent(NULL),
+		offsetKindInternal(OFFSET_NULL), numRaws(0), numBlocks(0), numPartitions(0), numShares(0){
+	STAT_COUNT(STAT_SYMBOL_TREE_NODES);
 	TypeStatus status(defType, NULL); defSite = new Tree(status); defSite->env = this;
 }
-SymbolTree::SymbolTree(int kind, const char *id, Type *defType, SymbolTree *copyImportSite) : kind(kind), id(id), copyImportSite(copyImportSite), parent(NULL),
-		offsetKindInternal(OFFSET_NULL), numRaws(0), numBlocks(0), numPartitions(0){
+SymbolTree::SymbolTree(int kind, Atom id, Type *defType, SymbolTree *copyImportSite) : kind(kind), id(atomString(id)), atom(id), copyImportSite(copyImportSite), parent(NULL),
+		offsetKindInternal(OFFSET_NULL), numRaws(0), numBlocks(0), numPartitions(0), numShares(0){
+	STAT_COUNT(STAT_SYMBOL_TREE_NODES);
 	TypeStatus status(defType, NULL); defSite = new Tree(status); defSite->env = this;
 }
-SymbolTree::SymbolTree(const SymbolTree &st, SymbolTree *parent, SymbolTree *copyImportSite) : kind(st.kind), id(st.id), defSite(st.defSite), copyImportSite(copyImportSite), parent(parent), children(st.children),
-	offsetKindInternal(st.offsetKindInternal), offsetIndexInternal(st.offsetIndexInternal), numRaws(st.numRaws), numBlocks(st.numBlocks), numPartitions(st.numPartitions) {}
+SymbolTree::SymbolTree(const SymbolTree &st, SymbolTree *parent, SymbolTree *copyImportSite) : kind(st.kind), id(st.id), atom(st.atom), defSite(st.defSite), copyImportSite(copyImportSite), parent(parent), children(st.children),
+	offsetKindInternal(st.offsetKindInternal), offsetIndexInternal(st.offsetIndexInternal), numRaws(st.numRaws), numBlocks(st.numBlocks), numPartitions(st.numPartitions), numShares(st.numShares) {
+	STAT_COUNT(STAT_SYMBOL_TREE_NODES);
+}
 SymbolTree::~SymbolTree() {}
+void *SymbolTree::operator new(size_t size) {
+	return allocNode(OWNED_SYMBOL_TREES, size);
+}
+void SymbolTree::operator delete(void *ptr) {
+	freeNode(ptr);
+}
 unsigned int SymbolTree::addRaw() {return (numRaws++);}
 unsigned int SymbolTree::addBlock() {return (numBlocks++);}
 unsigned int SymbolTree::addPartition() {return (numPartitions++);}
@@ -104,12 +591,13 @@ SymbolTree &SymbolTree::operator=(const SymbolTree &st) {
 	kind = st.kind;
 	defSite = st.defSite;
 	copyImportSite = st.copyImportSite;
-	if (id != st.id) { // if the id is changing
+	if (atom != st.atom) { // if the id is changing
 		if (parent != NULL) { // ... and there exists a parent, fix up the parent's children map to use the new id
-			parent->children.erase(id);
-			parent->children.insert(make_pair(st.id, this));
+			parent->children.erase(atom);
+			parent->children.insert(st.atom, this);
 		}
 		id = st.id; // either way, update the id
+		atom = st.atom;
 	}
 	children = st.children;
 	return *this;
@@ -118,9 +606,8 @@ SymbolTree &SymbolTree::operator*=(SymbolTree *st) {
 	// first, check for conflicting bindings
 	if (st->kind == KIND_STD || st->kind == KIND_DECLARATION || st->kind == KIND_PARAMETER) { // if this is a conflictable (non-special system-level binding)
 		// per-symbol loop
-		map<string, SymbolTree *>::const_iterator conflictFind = children.find(st->id);
-		if (conflictFind != children.end()) { // if we've found a conflict
-			SymbolTree *conflictSt = (*conflictFind).second;
+		SymbolTree *conflictSt = children.find(st->atom);
+		if (conflictSt != NULL) { // if we've found a conflict
 			Token curDefToken;
 			if (st->defSite != NULL) { // if there is a definition site for the current symbol
 				curDefToken = st->defSite->t;
@@ -145,7 +632,7 @@ SymbolTree &SymbolTree::operator*=(SymbolTree *st) {
 			return *this;
 		}
 	}	// binding is now known to be conflict-free, so log it normally
-	children.insert(make_pair(st->id, st));
+	children.insert(st->atom, st);
 	if (st != NULL) {
 		st->parent = this;
 		return *st;
@@ -236,8 +723,9 @@ string SymbolTree::toString(unsigned int tabDepth) {
 		COLOR( acc += SET_TERM(RESET_CODE); )
 	}
 	acc += '\n';
-	for (map<string, SymbolTree *>::iterator childIter = children.begin(); childIter != children.end(); childIter++) {
-		SymbolTree *childCur = (*childIter).second;
+	const vector<SymbolTree *> &childList = children.sorted();
+	for (unsigned int i=0; i < childList.size(); i++) {
+		SymbolTree *childCur = childList[i];
 		if (childCur != NULL) {
 			acc += childCur->toString(tabDepth+1);
 		}
@@ -251,44 +739,48 @@ SymbolTree::operator string() {
 // Main semantic analysis functions
 
 void catStdNodes(SymbolTree *&stRoot) {
-	*stRoot *= new SymbolTree(KIND_STD, "int", stdIntType);
-	*stRoot *= new SymbolTree(KIND_STD, "float", stdFloatType);
-	*stRoot *= new SymbolTree(KIND_STD, "bool", stdBoolType);
-	*stRoot *= new SymbolTree(KIND_STD, "char", stdCharType);
-	*stRoot *= new SymbolTree(KIND_STD, "string", stdStringType);
-	*stRoot *= new SymbolTree(KIND_STD, "true", stdBoolLitType);
-	*stRoot *= new SymbolTree(KIND_STD, "false", stdBoolLitType);
+	*stRoot *= new SymbolTree(KIND_STD, "int", stdIntType());
+	*stRoot *= new SymbolTree(KIND_STD, "float", stdFloatType());
+	*stRoot *= new SymbolTree(KIND_STD, "bool", stdBoolType());
+	*stRoot *= new SymbolTree(KIND_STD, "char", stdCharType());
+	*stRoot *= new SymbolTree(KIND_STD, "string", stdStringType());
+	*stRoot *= new SymbolTree(KIND_STD, "true", stdBoolLitType());
+	*stRoot *= new SymbolTree(KIND_STD, "false", stdBoolLitType());
 }
 
 void catStdLib(SymbolTree *&stRoot) {
 	// system nodes
 	// streams
-	*stdLib *= new SymbolTree(KIND_STD, "inInt", inIntType);
-	*stdLib *= new SymbolTree(KIND_STD, "inFloat", inFloatType);
-	*stdLib *= new SymbolTree(KIND_STD, "inChar", inCharType);
-	*stdLib *= new SymbolTree(KIND_STD, "inString", inStringType);
-	*stdLib *= new SymbolTree(KIND_STD, "out", stringerType);
-	*stdLib *= new SymbolTree(KIND_STD, "err", stringerType);
+	*stdLib() *= new SymbolTree(KIND_STD, "inInt", inIntType());
+	*stdLib() *= new SymbolTree(KIND_STD, "inFloat", inFloatType());
+	*stdLib() *= new SymbolTree(KIND_STD, "inChar", inCharType());
+	*stdLib() *= new SymbolTree(KIND_STD, "inString", inStringType());
+	*stdLib() *= new SymbolTree(KIND_STD, "out", stringerType());
+	*stdLib() *= new SymbolTree(KIND_STD, "err", stringerType());
 	// control nodes
-	*stdLib *= new SymbolTree(KIND_STD, "randInt", new StdType(STD_INT, SUFFIX_LATCH));
-	*stdLib *= new SymbolTree(KIND_STD, "delay", new FilterType(new StdType(STD_INT), nullType, SUFFIX_LATCH));
+	*stdLib() *= new SymbolTree(KIND_STD, "randInt", new StdType(STD_INT, SUFFIX_LATCH));
+	*stdLib() *= new SymbolTree(KIND_STD, "delay", new FilterType(new StdType(STD_INT), nullType(), SUFFIX_LATCH));
 	// standard library
 	// generators
-	*stdLib *= new SymbolTree(KIND_STD, "gen", new FilterType(new StdType(STD_INT), new StdType(STD_INT, SUFFIX_STREAM, 1), SUFFIX_LATCH));
+	*stdLib() *= new SymbolTree(KIND_STD, "gen", new FilterType(new StdType(STD_INT), new StdType(STD_INT, SUFFIX_STREAM, 1), SUFFIX_LATCH));
 	// concatenate the library to the root
-	*stRoot *= stdLib;
+	*stRoot *= stdLib();
 }
 
-void initSemmerGlobals() {
+// builds the standard types and the nop IRTree into the current compilation's context, and publishes them for all later compilations
+// note: they can't be laid out as constant data ahead of time, since Types are polymorphic and own vectors, so the first compilation in each process pays for them
+void buildStdTypes() {
+	StdTypes &types = compilerContext->stdTypes; // (published below)
+	allocatingSharedNodes = true; // none of the compilations own these
 	// build the standard types
-	nullType = new StdType(STD_NULL); nullType->referensible = false;
-	errType = new ErrorType();
-	stdBoolType = new StdType(STD_BOOL); stdBoolType->referensible = false;
-	stdIntType = new StdType(STD_INT); stdIntType->referensible = false;
-	stdFloatType = new StdType(STD_FLOAT); stdFloatType->referensible = false;
-	stdCharType = new StdType(STD_CHAR); stdCharType->referensible = false;
-	stdStringType = new StdType(STD_STRING); stdStringType->referensible = false;
-	stdBoolLitType = new StdType(STD_BOOL, SUFFIX_LATCH);
+	types.nullType = new StdType(STD_NULL); types.nullType->referensible = false;
+	types.errType = new ErrorType();
+	types.stdBoolType = new StdType(STD_BOOL); types.stdBoolType->referensible = false;
+	types.stdIntType = new StdType(STD_INT); types.stdIntType->referensible = false;
+	types.stdFloatType = new StdType(STD_FLOAT); types.stdFloatType->referensible = false;
+	types.stdCharType = new StdType(STD_CHAR); types.stdCharType->referensible = false;
+	types.stdStringType = new StdType(STD_STRING); types.stdStringType->referensible = false;
+	types.stdBoolLitType = new StdType(STD_BOOL, SUFFIX_LATCH);
 	// build some auxiliary types
 	// latches
 	Type *boolLatchType = new StdType(STD_BOOL, SUFFIX_LATCH);
@@ -296,84 +788,92 @@ void initSemmerGlobals() {
 	Type *floatLatchType = new StdType(STD_FLOAT, SUFFIX_LATCH);
 	// pairs
 	vector<Type *> boolPair;
-	boolPair.push_back(stdBoolType); boolPair.push_back(stdBoolType);
+	boolPair.push_back(types.stdBoolType); boolPair.push_back(types.stdBoolType);
 	Type *boolPairType = new TypeList(boolPair);
 	
 	vector<Type *> intPair;
-	intPair.push_back(stdIntType); intPair.push_back(stdIntType);
+	intPair.push_back(types.stdIntType); intPair.push_back(types.stdIntType);
 	Type *intPairType = new TypeList(intPair);
 	
 	vector<Type *> floatPair;
-	floatPair.push_back(stdFloatType); floatPair.push_back(stdFloatType);
+	floatPair.push_back(types.stdFloatType); floatPair.push_back(types.stdFloatType);
 	Type *floatPairType = new TypeList(floatPair);
 	
 	vector<Type *> charPair;
-	charPair.push_back(stdCharType); charPair.push_back(stdCharType);
+	charPair.push_back(types.stdCharType); charPair.push_back(types.stdCharType);
 	Type *charPairType = new TypeList(charPair);
 	
 	vector<Type *> stringPair;
-	stringPair.push_back(stdStringType); stringPair.push_back(stdStringType);
+	stringPair.push_back(types.stdStringType); stringPair.push_back(types.stdStringType);
 	Type *stringPairType = new TypeList(stringPair);
 	// build the in* types
-	inIntType = new StdType(STD_INT, SUFFIX_LATCH); inIntType->instantiable = false;
-	inFloatType = new StdType(STD_FLOAT, SUFFIX_LATCH); inFloatType->instantiable = false;
-	inCharType = new StdType(STD_CHAR, SUFFIX_LATCH); inCharType->instantiable = false;
-	inStringType = new StdType(STD_STRING, SUFFIX_LATCH); inStringType->instantiable = false;
+	types.inIntType = new StdType(STD_INT, SUFFIX_LATCH); types.inIntType->instantiable = false;
+	types.inFloatType = new StdType(STD_FLOAT, SUFFIX_LATCH); types.inFloatType->instantiable = false;
+	types.inCharType = new StdType(STD_CHAR, SUFFIX_LATCH); types.inCharType->instantiable = false;
+	types.inStringType = new StdType(STD_STRING, SUFFIX_LATCH); types.inStringType->instantiable = false;
 	// build the stringerType
 	StructorList instructorList;
 	StructorList stringerOutstructorList;
-	TypeList *stringOutstructorType = new TypeList(stdStringType); stringOutstructorType->referensible = false;
+	TypeList *stringOutstructorType = new TypeList(types.stdStringType); stringOutstructorType->referensible = false;
 	stringerOutstructorList.add(stringOutstructorType);
-	stringerType = new ObjectType(instructorList, stringerOutstructorList, SUFFIX_LIST, 1); stringerType->referensible = false; stringerType->instantiable = false;
+	types.stringerType = new ObjectType(instructorList, stringerOutstructorList, SUFFIX_LIST, 1); types.stringerType->referensible = false; types.stringerType->instantiable = false;
 	// prepare to build the standard operator types
 	TypeList *filterOutstructorType;
 	StructorList opOutstructorList;
 	// build the boolUnOpType
-	filterOutstructorType = new TypeList(new FilterType(stdBoolType, boolLatchType, SUFFIX_LATCH));
+	filterOutstructorType = new TypeList(new FilterType(types.stdBoolType, boolLatchType, SUFFIX_LATCH));
 	opOutstructorList = stringerOutstructorList; opOutstructorList.add(filterOutstructorType);
-	boolUnOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); boolUnOpType->referensible = false;
+	types.boolUnOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); types.boolUnOpType->referensible = false;
 	// build the intUnOpType
-	filterOutstructorType = new TypeList(new FilterType(stdIntType, intLatchType, SUFFIX_LATCH));
+	filterOutstructorType = new TypeList(new FilterType(types.stdIntType, intLatchType, SUFFIX_LATCH));
 	opOutstructorList = stringerOutstructorList; opOutstructorList.add(filterOutstructorType);
-	intUnOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); intUnOpType->referensible = false;
+	types.intUnOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); types.intUnOpType->referensible = false;
 	// build the boolBinOpType
 	filterOutstructorType = new TypeList(new FilterType(boolPairType, boolLatchType, SUFFIX_LATCH));
 	opOutstructorList = stringerOutstructorList; opOutstructorList.add(filterOutstructorType);
-	boolBinOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); boolBinOpType->referensible = false;
+	types.boolBinOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); types.boolBinOpType->referensible = false;
 	// build the intBinOpType
 	filterOutstructorType = new TypeList(new FilterType(intPairType, intLatchType, SUFFIX_LATCH));
 	opOutstructorList = stringerOutstructorList; opOutstructorList.add(filterOutstructorType);
-	intBinOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); intBinOpType->referensible = false;
+	types.intBinOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); types.intBinOpType->referensible = false;
 	// build the floatBinOpType
 	filterOutstructorType = new TypeList(new FilterType(floatPairType, floatLatchType, SUFFIX_LATCH));
 	opOutstructorList = stringerOutstructorList; opOutstructorList.add(filterOutstructorType);
-	floatBinOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); floatBinOpType->referensible = false;
+	types.floatBinOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); types.floatBinOpType->referensible = false;
 	// build the boolCompOpType
 	filterOutstructorType = new TypeList(new FilterType(boolPairType, boolLatchType, SUFFIX_LATCH));
 	opOutstructorList = stringerOutstructorList; opOutstructorList.add(filterOutstructorType);
-	boolCompOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); boolCompOpType->referensible = false;
+	types.boolCompOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); types.boolCompOpType->referensible = false;
 	// build the intCompOpType
 	filterOutstructorType = new TypeList(new FilterType(intPairType, boolLatchType, SUFFIX_LATCH));
 	opOutstructorList = stringerOutstructorList; opOutstructorList.add(filterOutstructorType);
-	intCompOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); intCompOpType->referensible = false;
+	types.intCompOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); types.intCompOpType->referensible = false;
 	// build the floatCompOpType
 	filterOutstructorType = new TypeList(new FilterType(floatPairType, boolLatchType, SUFFIX_LATCH));
 	opOutstructorList = stringerOutstructorList; opOutstructorList.add(filterOutstructorType);
-	floatCompOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); floatCompOpType->referensible = false;
+	types.floatCompOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); types.floatCompOpType->referensible = false;
 	// build the charCompOpType
 	filterOutstructorType = new TypeList(new FilterType(charPairType, boolLatchType, SUFFIX_LATCH));
 	opOutstructorList = stringerOutstructorList; opOutstructorList.add(filterOutstructorType);
-	charCompOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); charCompOpType->referensible = false;
+	types.charCompOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); types.charCompOpType->referensible = false;
 	// build the stringCompOpType
 	filterOutstructorType = new TypeList(new FilterType(stringPairType, boolLatchType, SUFFIX_LATCH));
 	opOutstructorList = stringerOutstructorList; opOutstructorList.add(filterOutstructorType);
-	stringCompOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); stringCompOpType->referensible = false;
+	types.stringCompOpType = new ObjectType(instructorList, opOutstructorList, SUFFIX_LATCH); types.stringCompOpType->referensible = false;
 	// build the standard library type
-	stdLibType = new StdType(STD_STD, SUFFIX_LATCH); stdLibType->referensible = false; stdLibType->instantiable = false;
-	// build the standard library node
-	stdLib = new SymbolTree(KIND_STD, STANDARD_LIBRARY_STRING, stdLibType);
+	types.stdLibType = new StdType(STD_STD, SUFFIX_LATCH); types.stdLibType->referensible = false; types.stdLibType->instantiable = false;
 	// build the nop IRTree
-	nopCode = new CodeTree(CATEGORY_NOP);
+	types.nopCode = new CodeTree(CATEGORY_NOP);
+	allocatingSharedNodes = false;
+	sharedStdTypes = compilerContext->stdTypes;
+}
+
+void initSemmerGlobals() {
+	// get the standard types, building them if this is the first compilation in the process
+	pthread_once(&stdTypesBuilt, buildStdTypes);
+	compilerContext->stdTypes = sharedStdTypes;
+	// build the standard library node
+	stdLib() = new SymbolTree(KIND_STD, STANDARD_LIBRARY_STRING, stdLibType());
 }
 
 SymbolTree *genDefaultDefs() {
@@ -387,6 +887,19 @@ SymbolTree *genDefaultDefs() {
 	return stRoot;
 }
 
+// builds the standard types and the default definitions in advance (e.g. once in a compile server, rather than in each of the compilations that it forks off)
+void warmSemmer() {
+	initSemmerGlobals();
+	compilerContext->warmDefaultDefs = genDefaultDefs();
+}
+
+// generates a unique suffix for fake (anonymous) node identifiers; suffixes sort in order of generation
+string getFakeIdSuffix() {
+	char tempBuf[MAX_INT_STRING_LENGTH];
+	sprintf(tempBuf, "%010u", getUniqueInt());
+	return tempBuf;
+}
+
 // recursively extracts the appropriate nodes from the given tree and appropriately populates the passed containers
 void buildSt(Tree *tree, SymbolTree *st, vector<SymbolTree *> &importList) {
 	// base case
@@ -398,11 +911,11 @@ void buildSt(Tree *tree, SymbolTree *st, vector<SymbolTree *> &importList) {
 	// recursive cases
 	if (*tree == TOKEN_Declaration) { // if it's a Declaration-style node
 		Token defToken = tree->child->t; // ID, AT, or DAT
-		if (defToken.tokenType != TOKEN_ID || (defToken.s != "null" && defToken.s != "true" && defToken.s != "false")) { // if this isn't a standard literal override, proceed normally
+		if (defToken.tokenType != TOKEN_ID || (!defToken.textEquals("null") && !defToken.textEquals("true") && !defToken.textEquals("false"))) { // if this isn't a standard literal override, proceed normally
 			Tree *dcn = tree->child->next;
 			if (*dcn == TOKEN_EQUALS) { // standard static declaration
 				// allocate the new declaration node
-				SymbolTree *newDef = new SymbolTree(KIND_DECLARATION, tree->child->t.s, tree);
+				SymbolTree *newDef = new SymbolTree(KIND_DECLARATION, tree->child->t.atom, tree);
 				// ... and link it in
 				*st *= newDef;
 				// recurse
@@ -421,7 +934,7 @@ void buildSt(Tree *tree, SymbolTree *st, vector<SymbolTree *> &importList) {
 				buildSt(tree->next, st, importList); // right
 			}
 		} else { // else if this is a standard literal override, flag an error
-			semmerError(defToken.fileIndex,defToken.row,defToken.col,"redefinition of standard literal '"<<defToken.s<<"'");
+			semmerError(defToken.fileIndex,defToken.row,defToken.col,"redefinition of standard literal '"<<defToken.s()<<"'");
 		}
 	} else if (*tree == TOKEN_Block || *tree == TOKEN_Object) { // if it's a block-style node
 		// allocate the new block definition node
@@ -431,10 +944,10 @@ void buildSt(Tree *tree, SymbolTree *st, vector<SymbolTree *> &importList) {
 		if (*tree == TOKEN_Block) { // if it's a block node, use a regular identifier
 			kind = KIND_BLOCK;
 			fakeId = BLOCK_NODE_STRING;
-		} else { // else if it's an object node, generate a fake identifier from a hash of the Tree node
+		} else { // else if it's an object node, generate a unique fake identifier
 			kind = KIND_OBJECT;
 			fakeId = OBJECT_NODE_STRING;
-			fakeId += (uintptr_t)tree;
+			fakeId += getFakeIdSuffix();
 		}
 		SymbolTree *blockDef = new SymbolTree(kind, fakeId, tree);
 		// latch the new node into the SymbolTree trunk
@@ -444,16 +957,16 @@ void buildSt(Tree *tree, SymbolTree *st, vector<SymbolTree *> &importList) {
 		buildSt(tree->next, st, importList); // right
 	} else if (*tree == TOKEN_Filter || *tree == TOKEN_ExplicitFilter) { // if it's a filter-style node
 		// allocate the new filter definition node
-		// generate a fake identifier for the filter node from a hash of the Tree node
+		// generate a unique fake identifier for the filter node
 		string fakeId(FILTER_NODE_STRING);
-		fakeId += (uintptr_t)tree;
+		fakeId += getFakeIdSuffix();
 		SymbolTree *filterDef = new SymbolTree(KIND_FILTER, fakeId, tree);
 		// parse out the header's parameter declarations and add them to the st
 		Tree *pl = (*(tree->child) == TOKEN_FilterHeader) ? tree->child->child->next : NULL; // RSQUARE, ParamList, RetList, or NULL
 		if (pl != NULL && *pl == TOKEN_ParamList) { // if there is a parameter list to process
 			for (Tree *param = pl->child; param != NULL; param = (param->next != NULL) ? param->next->next->child : NULL) { // per-param loop
 				// allocate the new parameter definition node
-				SymbolTree *paramDef = new SymbolTree(KIND_PARAMETER, param->child->next->t.s, param);
+				SymbolTree *paramDef = new SymbolTree(KIND_PARAMETER, param->child->next->t.atom, param);
 				// ... and link it into the filter definition node
 				*filterDef *= paramDef;
 			}
@@ -465,9 +978,9 @@ void buildSt(Tree *tree, SymbolTree *st, vector<SymbolTree *> &importList) {
 		buildSt(tree->next, st, importList); // right
 	} else if (*tree == TOKEN_Instructor || *tree == TOKEN_LastInstructor) { // if it's an instructor-style node
 		// allocate the new instructor definition node
-		// generate a fake identifier for the instructor node from a hash of the Tree node
+		// generate a unique fake identifier for the instructor node
 		string fakeId(INSTRUCTOR_NODE_STRING);
-		fakeId += (uintptr_t)tree;
+		fakeId += getFakeIdSuffix();
 		SymbolTree *consDef = new SymbolTree(KIND_INSTRUCTOR, fakeId, tree);
 		// .. and link it in
 		*st *= consDef;
@@ -477,7 +990,7 @@ void buildSt(Tree *tree, SymbolTree *st, vector<SymbolTree *> &importList) {
 			Tree *pl = conscn->child->next; // ParamList
 			for (Tree *param = pl->child; param != NULL; param = (param->next != NULL) ? param->next->next->child : NULL) { // per-param loop
 				// allocate the new parameter definition node
-				SymbolTree *paramDef = new SymbolTree(KIND_PARAMETER, param->child->next->t.s, param);
+				SymbolTree *paramDef = new SymbolTree(KIND_PARAMETER, param->child->next->t.atom, param);
 				// ... and link it into the instructor definition node
 				*consDef *= paramDef;
 			}
@@ -487,9 +1000,9 @@ void buildSt(Tree *tree, SymbolTree *st, vector<SymbolTree *> &importList) {
 		buildSt(tree->next, st, importList); // right
 	} else if (*tree == TOKEN_Outstructor) { // if it's an outstructor-style node
 		// allocate the new outstructor definition node
-		// generate a fake identifier for the outstructor node from a hash of the Tree node
+		// generate a unique fake identifier for the outstructor node
 		string fakeId(OUTSTRUCTOR_NODE_STRING);
-		fakeId += (uintptr_t)tree;
+		fakeId += getFakeIdSuffix();
 		SymbolTree *consDef = new SymbolTree(KIND_OUTSTRUCTOR, fakeId, tree);
 		// .. and link it in
 		*st *= consDef;
@@ -498,7 +1011,7 @@ void buildSt(Tree *tree, SymbolTree *st, vector<SymbolTree *> &importList) {
 		buildSt(tree->next, st, importList); // right
 	} else if (*tree == TOKEN_Instantiation && st->kind != KIND_DECLARATION) { // if it's a non-bound (inlined) instantiation-style node
 		string fakeId(INSTANTIATION_NODE_STRING);
-		fakeId += (uintptr_t)tree;
+		fakeId += getFakeIdSuffix();
 		// allocate the new instantiation node
 		SymbolTree *newDef = new SymbolTree(KIND_INSTANTIATION, fakeId, tree);
 		// ... and link it in
@@ -513,60 +1026,49 @@ void buildSt(Tree *tree, SymbolTree *st, vector<SymbolTree *> &importList) {
 	}
 }
 
-// chops up the passed in string into its period-delimited components
-vector<string> chopId(const string &s) {
-	vector<string> retVal;
-	string acc;
-	for (unsigned int i=0; i < s.size(); i++) {
-		if (s[i] != '.') { // if this character isn't a period
-			acc += s[i];
-		} else if (s[i+1] == '.') { // else if this character is a period and the next one is as well (can only occur at the beginning of an identifier)
-			i++;
-			acc += "..";
-		} else {
-			retVal.push_back(acc);
-			acc.clear();
-		}
-	}
-	if (acc.size() > 0) { // commit the last token if necessary
-		retVal.push_back(acc);
+// attaches a fake node to the given parent, returning the node that ends up attached
+// (in the threaded semmer, another thread might have attached an identical one first, in which case that one is used)
+SymbolTree *attachFakeNode(SymbolTree *parent, SymbolTree *fakeStNode) {
+	if (semmerMode() != SEMMER_THREADED) {
+		*parent *= fakeStNode;
+		return fakeStNode;
+	}
+	pthread_mutex_lock(&compilerContext->scopeWriteLock);
+	SymbolTree *retVal = parent->children.find(fakeStNode->atom);
+	if (retVal == NULL) { // if nobody beat us to it, attach the node, flagging the write to lock-free readers
+		__sync_fetch_and_add(&compilerContext->scopeVersion, 1);
+		*parent *= fakeStNode;
+		__sync_fetch_and_add(&compilerContext->scopeVersion, 1);
+		compilerContext->parallelFakeNodes.push_back(make_pair(parent, fakeStNode));
+		retVal = fakeStNode;
+	} else {
+		delete fakeStNode;
 	}
+	pthread_mutex_unlock(&compilerContext->scopeWriteLock);
 	return retVal;
 }
 
-// rebuilds a string representation of this identifier from a chopped list and a depth
-string rebuildId(const vector<string> &choppedList, unsigned int depth) {
-	string acc;
-	for (unsigned int i=0; i <= depth; i++) {
-		acc += choppedList[i];
-		if (i != depth) {
-			acc += '.';
-		}
-	}
-	return acc;
-}
-
 // reports errors
 // second component is whether we passed through constantication for this binding
-pair<SymbolTree *, bool> bindId(const string &s, SymbolTree *env, const TypeStatus &inStatus = TypeStatus()) {
-	vector<string> id = chopId(s); // chop up the input identifier into its components
+pair<SymbolTree *, bool> bindIdUncached(const vector<Atom> &id, SymbolTree *env, const TypeStatus &inStatus) {
 	SymbolTree *stRoot = NULL; // the latch point of the binding
-	if (id[0] == "..") { // if the identifier begins with a recall
+	if (id[0] == ATOM_RECALL) { // if the identifier begins with a recall
 		Type *recallType = inStatus.type;
 		if (recallType) { // if there's a recall binding passed in, use a fake SymbolTree node for it
 			// generate a fake identifier for the recall binding node from a hash of the recall identifier's Type object
 			string fakeId(FAKE_RECALL_NODE_PREFIX);
-			fakeId += (unsigned int)inStatus;
+			char tempBuf[MAX_INT_STRING_LENGTH];
+			sprintf(tempBuf, "%lX", (unsigned long)(uintptr_t)inStatus);
+			fakeId += tempBuf;
+			Atom fakeAtom = intern(fakeId);
 			// check if a SymbolTree node with this identifier already exists -- if so, use it
-			map<string, SymbolTree *>::const_iterator fakeFind = env->children.find(fakeId);
-			if (fakeFind != env->children.end()) { // if we found a match, use it
-				stRoot = (*fakeFind).second;
+			SymbolTree *fakeFind = env->children.find(fakeAtom);
+			if (fakeFind != NULL) { // if we found a match, use it
+				stRoot = fakeFind;
 			} else { // else if we didn't find a match, create a new fake latch point to use
-				SymbolTree *fakeStNode = new SymbolTree(KIND_FAKE, fakeId);
-				// attach the new fake node to the main SymbolTree
-				*env *= fakeStNode;
-				// accept the new fake node as the latch point
-				stRoot = fakeStNode;
+				SymbolTree *fakeStNode = new SymbolTree(KIND_FAKE, fakeAtom);
+				// attach the new fake node to the main SymbolTree and accept it as the latch point
+				stRoot = attachFakeNode(env, fakeStNode);
 			}
 		} else { // else if there is no known recall binding, return an error
 			return make_pair((SymbolTree *)NULL, false);
@@ -576,16 +1078,16 @@ pair<SymbolTree *, bool> bindId(const string &s, SymbolTree *env, const TypeStat
 			if ((stCur->kind == KIND_STD ||
 					stCur->kind == KIND_DECLARATION ||
 					stCur->kind == KIND_PARAMETER) &&
-					stCur->id == id[0]) { // if this is a valid latch point, log it and break
+					stCur->atom == id[0]) { // if this is a valid latch point, log it and break
 				stRoot = stCur;
 				break;
 			} else if (stCur->kind == KIND_BLOCK ||
 					stCur->kind == KIND_OBJECT ||
 					stCur->kind == KIND_INSTRUCTOR ||
 					stCur->kind == KIND_FILTER) { // else if this is a valid basis block, scan its children for a latch point
-				map<string, SymbolTree *>::const_iterator latchFind = stCur->children.find(id[0]);
-				if (latchFind != stCur->children.end()) { // if we've found a latch point in the children
-					stRoot = (*latchFind).second;
+				SymbolTree *latchFind = stCur->children.find(id[0]);
+				if (latchFind != NULL) { // if we've found a latch point in the children
+					stRoot = latchFind;
 					break;
 				}
 			}
@@ -596,15 +1098,15 @@ pair<SymbolTree *, bool> bindId(const string &s, SymbolTree *env, const TypeStat
 		SymbolTree *stCur = stRoot; // the basis under which we're hoping to bind the current sub-identifier (KIND_STD, KIND_DECLARATION, or KIND_PARAMETER)
 		for (unsigned int i = 1; i < id.size(); i++) { // for each sub-identifier of the identifier we're trying to find the binding for
 			bool success = false;
-			Type *stCurType = errType;
+			Type *stCurType = errType();
 			if (stCur->kind == KIND_STD) { // if it's a standard system-level binding, look in the list of children for a match to this sub-identifier
-				map<string, SymbolTree *>::const_iterator childFind = stCur->children.find(id[i]);
-				if (childFind != stCur->children.end()) { // if there's a match to this sub-identifier, proceed
+				SymbolTree *childFind = stCur->children.find(id[i]);
+				if (childFind != NULL) { // if there's a match to this sub-identifier, proceed
 					if (*(stCur->defSite->status.type) == STD_STD) { // if it's the root std node, just log the child as stCur and continue in the derivation
-						stCur = (*childFind).second;
+						stCur = childFind;
 						success = true;
 					} else { // else if it's not the root std node, use the subidentifier's type for derivation, as usual
-						stCurType = (*childFind).second->defSite->status.type;
+						stCurType = childFind->defSite->status.type;
 					}
 				}
 			} else if (stCur->kind == KIND_DECLARATION) { // else if it's a Declaration binding, carefully get its type
@@ -623,36 +1125,34 @@ pair<SymbolTree *, bool> bindId(const string &s, SymbolTree *env, const TypeStat
 					Token curToken = stCur->defSite->t;
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"member access on unmembered identifier '"<<rebuildId(id, i)<<"'");
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (identifier type is "<<stCurType<<")");
-					stCurType = errType;
+					stCurType = errType();
 				} else if (stCurType->suffix == SUFFIX_ARRAY || stCurType->suffix == SUFFIX_POOL) { // else if it's an array or pool, ensure that we're accessing it using a subscript
-					if (id[i] == "[]" || id[i] == "[:]") { // if we're accessing it via a subscript, accept it and proceed deeper into the binding
+					if (id[i] == ATOM_SUBSCRIPT || id[i] == ATOM_RANGE_SUBSCRIPT) { // if we're accessing it via a subscript, accept it and proceed deeper into the binding
 						// if it's an array type, flag the fact that it must be constantized
 						if (stCurType->suffix == SUFFIX_ARRAY) {
 							needsConstantization = true;
 						}
 						// we're about to fake a SymbolTree node for this subscript access
 						// but first, check if a SymbolTree node has already been faked for this member
-						map<string, SymbolTree *>::const_iterator fakeFind = stCur->children.find(id[i]);
-						if (fakeFind != stCur->children.end()) { // if we've already faked a SymbolTree node for this member, accept it and proceed deeper into the binding
-							stCur = (*fakeFind).second;
+						SymbolTree *fakeFind = stCur->children.find(id[i]);
+						if (fakeFind != NULL) { // if we've already faked a SymbolTree node for this member, accept it and proceed deeper into the binding
+							stCur = fakeFind;
 						} else { // else if we haven't yet faked a SymbolTree node for this member, do so now
 							Type *mutableStCurType = stCurType;
-							if (id[i] == "[]") { // if it's an expression access (as opposed to a range access), decrease the type's depth
+							if (id[i] == ATOM_SUBSCRIPT) { // if it's an expression access (as opposed to a range access), decrease the type's depth
 								mutableStCurType = mutableStCurType->copy(); // make a mutable copy of the type
 								mutableStCurType->decreaseDepth();
 							}
 							SymbolTree *fakeStNode = new SymbolTree(KIND_FAKE, id[i], mutableStCurType);
-							// attach the new fake node to the main SymbolTree
-							*stCur *= fakeStNode;
-							// accept the new fake node and proceed deeper into the binding
-							stCur = fakeStNode;
+							// attach the new fake node to the main SymbolTree, accept it, and proceed deeper into the binding
+							stCur = attachFakeNode(stCur, fakeStNode);
 						}
 						success = true; // all of the above branches lead to success
 					} else {
 						Token curToken = stCur->defSite->t;
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"non-subscript access on identifier '"<<rebuildId(id, i)<<"'");
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (identifier type is "<<stCurType<<")");
-						stCurType = errType;
+						stCurType = errType();
 					}
 				} else if (stCurType->category == CATEGORY_OBJECTTYPE) { // else if it's an Object constant or latch (the only other category that can have sub-identifiers)
 					// if it's a constant type, flag the fact that this identifier will need to be constantized
@@ -661,22 +1161,19 @@ pair<SymbolTree *, bool> bindId(const string &s, SymbolTree *env, const TypeStat
 					}
 					// proceed with binding the sub-identifier as normal by trying to find a match in the Object's members
 					ObjectType *stCurTypeCast = ((ObjectType *)stCurType);
-					MemberList::iterator findIter = stCurTypeCast->memberList.find(id[i]);
+					MemberList::iterator findIter = stCurTypeCast->memberList.find(atomString(id[i]));
 					if (findIter != stCurTypeCast->memberList.end()) { // if we managed to find a matching sub-identifier
 						if ((*findIter).defSite() != NULL) { // if the member has a real definition site, accept it and proceed deeper into the binding
 							stCur = (*findIter).defSite()->env;
 						} else { // else if the member has no real definition site, we'll need to fake a SymbolTree node for it
 							// but first, check if a SymbolTree node has already been faked for this member
-							map<string, SymbolTree *>::const_iterator fakeFindIter = stCur->children.find(id[i]);
-							if (fakeFindIter != stCur->children.end()) { // if we've already faked a SymbolTree node for this member, accept it and proceed deeper into the binding
-								stCur = (*fakeFindIter).second;
-								stCur = (*fakeFindIter).second;
+							SymbolTree *fakeFind = stCur->children.find(id[i]);
+							if (fakeFind != NULL) { // if we've already faked a SymbolTree node for this member, accept it and proceed deeper into the binding
+								stCur = fakeFind;
 							} else { // else if we haven't yet faked a SymbolTree node for this member, do so now
 								SymbolTree *fakeStNode = new SymbolTree(KIND_FAKE, id[i], (*findIter));
-								// attach the new fake node to the main SymbolTree
-								*stCur *= fakeStNode;
-								// accept the new fake node and proceed deeper into the binding
-								stCur = fakeStNode;
+								// attach the new fake node to the main SymbolTree, accept it, and proceed deeper into the binding
+								stCur = attachFakeNode(stCur, fakeStNode);
 							}
 						}
 						success = true; // all of the above branches lead to success
@@ -694,157 +1191,225 @@ pair<SymbolTree *, bool> bindId(const string &s, SymbolTree *env, const TypeStat
 	}
 }
 
-void subImportDecls(vector<SymbolTree *> importList) {
-	bool stdExplicitlyImported = false;
-	for(;;) { // per-change loop
-		// per-import loop
-		vector<SymbolTree *> redoList; // the list of imports that we couldn't handle this round and must redo in the next one
-		for (vector<SymbolTree *>::const_iterator importIter = importList.begin(); importIter != importList.end(); importIter++) {
-			// extract the import path out of the iterator
-			Tree *importdcn = (*importIter)->defSite->child->next;
-			bool copyImport = (*importdcn == TOKEN_LSQUARE); // whether this is a copy-import
-			Tree *importId = copyImport ? importdcn->next : importdcn; // ImportIdentifier
-			string importPath = *(importId->child); // NonArrayedIdentifier, ArrayedIdentifier, or OpenIdentifier
-			SymbolTree *importParent = (*importIter)->parent;
-			// try to find a binding for this import
-			SymbolTree *binding = bindId(importPath, *importIter).first;
-			if (binding != NULL) { // if we found a valid binding
-				// check for the standard library import special case
-				if (binding == stdLib) { // if the import binds to the standard library node
-					if ((*importIter)->kind == KIND_CLOSED_IMPORT) { // if this is a closed-import of the standard library node
-						if (copyImport) { // if it was a copy-import, log the copy-import site as the standard library node (this will flag an error later)
-							(*importIter)->copyImportSite = stdLib;
-						}
-						if (!stdExplicitlyImported) { // if it's the first standard import, flag it as handled and let it slide
-							(*importIter)->id = STANDARD_IMPORT_DECL_STRING;
-							stdExplicitlyImported = true;
-							continue;
-						}
-					} else /* if ((*importIter)->kind == KIND_OPEN_IMPORT) */ { // else if this is an open-import of the standard library node
-						// add in the imported nodes, scanning for conflicts along the way
-						bool firstInsert = true;
-						for (map<string, SymbolTree *>::const_iterator childIter = binding->children.begin();
-								childIter != binding->children.end();
-								childIter++) {
-							// check for naming conflicts
-							map<string, SymbolTree *>::const_iterator conflictFind = importParent->children.find((*childIter).second->id);
-							if (conflictFind == importParent->children.end()) { // if there were no member naming conflicts
-								if (firstInsert) { // if this is the first insertion, copy in place of the import placeholder node
-									if (copyImport) { // if this is a copy-import
-										**importIter = SymbolTree(*((*childIter).second), importParent, (*childIter).second); // scope to the local environment
-									} else { // else if this is not a copy-import
-										**importIter = SymbolTree(*((*childIter).second), (*childIter).second->parent, NULL); // scope to the foreign environment
-									}
-									firstInsert = false;
-								} else { // else if this is not the first insertion, latch in a copy of the child
-									SymbolTree *baseChildCopy = new SymbolTree(*((*childIter).second), NULL, (copyImport) ? (*childIter).second : NULL); // build the copy, scoping to NULL for now
-									*((*importIter)->parent) *= baseChildCopy; // latch in the copy
-									// correct the scope based on whether this is a copy-import or not
-									if (copyImport) { // if this is a copy-import
-										baseChildCopy->parent = importParent; // scope to the local environment
-									} else { // else if this is not a copy-import
-										baseChildCopy->parent = (*childIter).second->parent; // scope to the foreign environment
-									}
-								}
-							} // else if there is a member naming conflict, do nothing; the import is overridden by what's already there
-						}
-					}
-				} else { // else if the import doesn't bind to the standard library node, proceed with normal import processing
-					string importPathTip = binding->id; // must exist if binding succeeed
-					if ((*importIter)->kind == KIND_CLOSED_IMPORT) { // if this is a closed-import
-						// check to make sure that this import doesn't cause a binding conflict
-						string importPathTip = binding->id; // must exist if binding succeeed
-						map<string, SymbolTree *>::const_iterator conflictFind = importParent->children.find(importPathTip);
-						if (conflictFind == importParent->children.end()) { // there was no conflict, so just copy the binding in place of the import placeholder node
+// reports errors
+// memoizing wrapper around bindIdUncached(); only successful bindings are cached, so failures are re-tried (and re-reported) as before
+pair<SymbolTree *, bool> bindId(const vector<Atom> &id, SymbolTree *env, const TypeStatus &inStatus = TypeStatus()) {
+	Type *recallType = (id[0] == ATOM_RECALL) ? inStatus.type : NULL; // recall identifiers bind relative to the recall type, so it's part of the key
+	BindingCache &cache = (workerBindingCache != NULL) ? *workerBindingCache : *(compilerContext->bindingCache); // parallel semmer workers each keep their own
+	const BindingCacheEntry *cached = cache.find(env, id, recallType);
+	if (cached != NULL) {
+		return make_pair(cached->st, cached->needsConstantization);
+	}
+	pair<SymbolTree *, bool> retVal = bindIdUncached(id, env, inStatus);
+	if (retVal.first != NULL) {
+		cache.insert(env, id, recallType, retVal.first, retVal.second);
+	}
+	return retVal;
+}
+
+// substitutes a single import declaration into the symbol tree, logging its path in importPath; returns false if it can't be bound (yet)
+bool subImportDecl(SymbolTree *importSt, vector<Atom> &importPath, bool &stdExplicitlyImported) {
+	// extract the import path out of the import node
+	Tree *importdcn = importSt->defSite->child->next;
+	bool copyImport = (*importdcn == TOKEN_LSQUARE); // whether this is a copy-import
+	Tree *importId = copyImport ? importdcn->next : importdcn; // ImportIdentifier
+	importId->child->atomPath(importPath); // NonArrayedIdentifier, ArrayedIdentifier, or OpenIdentifier
+	SymbolTree *importParent = importSt->parent;
+	// try to find a binding for this import
+	SymbolTree *binding = bindId(importPath, importSt).first;
+	if (binding != NULL) { // if we found a valid binding
+		// the substitution below changes what identifiers bind to, so forget all cached bindings
+		compilerContext->bindingCache->clear();
+		// check for the standard library import special case
+		if (binding == stdLib()) { // if the import binds to the standard library node
+			if (importSt->kind == KIND_CLOSED_IMPORT) { // if this is a closed-import of the standard library node
+				if (copyImport) { // if it was a copy-import, log the copy-import site as the standard library node (this will flag an error later)
+					importSt->copyImportSite = stdLib();
+				}
+				if (!stdExplicitlyImported) { // if it's the first standard import, flag it as handled and let it slide
+					importSt->id = STANDARD_IMPORT_DECL_STRING;
+					importSt->atom = intern(STANDARD_IMPORT_DECL_STRING);
+					stdExplicitlyImported = true;
+					return true;
+				}
+			} else /* if (importSt->kind == KIND_OPEN_IMPORT) */ { // else if this is an open-import of the standard library node
+				// add in the imported nodes, scanning for conflicts along the way
+				bool firstInsert = true;
+				vector<SymbolTree *> childList = binding->children.sorted(); // copy, since importing can mutate the scopes
+				for (vector<SymbolTree *>::const_iterator childIter = childList.begin(); childIter != childList.end(); childIter++) {
+					// check for naming conflicts
+					if (importParent->children.find((*childIter)->atom) == NULL) { // if there were no member naming conflicts
+						if (firstInsert) { // if this is the first insertion, copy in place of the import placeholder node
 							if (copyImport) { // if this is a copy-import
-								**importIter = SymbolTree(*binding, importParent, binding); // scope to the local environment
+								*importSt = SymbolTree(**childIter, importParent, *childIter); // scope to the local environment
 							} else { // else if this is not a copy-import
-								**importIter = SymbolTree(*binding, binding->parent, NULL); // scope to the foreign environment
-							}
-						} else { // else if there was a conflict, flag an error
-							Token curDefToken = importId->child->t; // child of NonArrayedIdentifier or ArrayedIdentifier
-							Token prevDefToken;
-							if ((*conflictFind).second->defSite != NULL) { // if there is a definition site for the previous symbol
-								prevDefToken = (*conflictFind).second->defSite->t;
-							} else { // otherwise, it must be a standard definition, so make up the token as if it was
-								prevDefToken.fileIndex = STANDARD_LIBRARY_FILE_INDEX;
-								prevDefToken.row = 0;
-								prevDefToken.col = 0;
+								*importSt = SymbolTree(**childIter, (*childIter)->parent, NULL); // scope to the foreign environment
 							}
-							semmerError(curDefToken.fileIndex,curDefToken.row,curDefToken.col,"name conflict in importing '"<<importPathTip<<"'");
-							semmerError(prevDefToken.fileIndex,prevDefToken.row,prevDefToken.col,"-- (conflicting definition was here)");
-						}
-					} else /* if ((*importIter)->kind == KIND_OPEN_IMPORT) */ { // else if this is an open-import
-						// verify that what's being open-imported is actually an object by finding an object-style child in the binding's children
-						map<string, SymbolTree *>::const_iterator bindingChildIter;
-						for (bindingChildIter = binding->children.begin(); bindingChildIter != binding->children.end(); bindingChildIter++) {
-							if ((*bindingChildIter).second->kind == KIND_OBJECT) {
-								break;
+							firstInsert = false;
+						} else { // else if this is not the first insertion, latch in a copy of the child
+							SymbolTree *baseChildCopy = new SymbolTree(**childIter, NULL, (copyImport) ? *childIter : NULL); // build the copy, scoping to NULL for now
+							*(importSt->parent) *= baseChildCopy; // latch in the copy
+							// correct the scope based on whether this is a copy-import or not
+							if (copyImport) { // if this is a copy-import
+								baseChildCopy->parent = importParent; // scope to the local environment
+							} else { // else if this is not a copy-import
+								baseChildCopy->parent = (*childIter)->parent; // scope to the foreign environment
 							}
 						}
-						if (bindingChildIter != binding->children.end()) { // if we found an object-style child in this open-import's children (it's a valid open-impoprt of an object)
-							SymbolTree *bindingBase = (*bindingChildIter).second; // KIND_OBJECT; this node's children are the ones we're going to import in
-							// add in the imported nodes, scanning for conflicts along the way
-							bool firstInsert = true;
-							for (map<string, SymbolTree *>::const_iterator bindingBaseIter = bindingBase->children.begin();
-									bindingBaseIter != bindingBase->children.end();
-									bindingBaseIter++) {
-								// check for member naming conflicts (constructor type conflicts will be resolved later)
-								map<string, SymbolTree *>::const_iterator conflictFind = importParent->children.find((*bindingBaseIter).second->id);
-								if (conflictFind == importParent->children.end()) { // if there were no member naming conflicts
-									if (firstInsert) { // if this is the first insertion, copy in place of the import placeholder node
-										if (copyImport) { // if this is a copy-import
-											**importIter = SymbolTree(*((*bindingBaseIter).second), importParent, (*bindingBaseIter).second); // scope to the local environment
-										} else { // else if this is not a copy-import
-											**importIter = SymbolTree(*((*bindingBaseIter).second), (*bindingBaseIter).second->parent, NULL); // scope to the foreign environment
-										}
-										firstInsert = false;
-									} else { // else if this is not the first insertion, latch in a copy of the child
-										SymbolTree *baseChildCopy = new SymbolTree(*((*bindingBaseIter).second), NULL, (copyImport) ? (*bindingBaseIter).second : NULL); // build the copy, scoping to NULL for now
-										*((*importIter)->parent) *= baseChildCopy; // latch in the copy
-										// correct the scope based on whether this is a copy-import or not
-										if (copyImport) { // if this is a copy-import
-											baseChildCopy->parent = importParent; // scope to the local environment
-										} else { // else if this is not a copy-import
-											baseChildCopy->parent = (*bindingBaseIter).second->parent; // scope to the foreign environment
-										}
-									}
-								} // else if there is a member naming conflict, do nothing; the import is overridden by what's already there
-							}
-						} else { // else if we didn't find an object-style child in this open-import's children (it's an open-impoprt of a non-object), flag an error
-							Token curDefToken = importId->child->t; // child of NonArrayedIdentifier or ArrayedIdentifier
-							Token prevDefToken;
-							if (binding->defSite != NULL) { // if there is a definition site for the previous symbol
-								prevDefToken = binding->defSite->t;
-							} else { // otherwise, it must be a standard definition, so make up the token as if it was
-								prevDefToken.fileIndex = STANDARD_LIBRARY_FILE_INDEX;
-								prevDefToken.row = 0;
-								prevDefToken.col = 0;
+					} // else if there is a member naming conflict, do nothing; the import is overridden by what's already there
+				}
+			}
+		} else { // else if the import doesn't bind to the standard library node, proceed with normal import processing
+			string importPathTip = binding->id; // must exist if binding succeeed
+			if (importSt->kind == KIND_CLOSED_IMPORT) { // if this is a closed-import
+				// check to make sure that this import doesn't cause a binding conflict
+				SymbolTree *conflictFind = importParent->children.find(binding->atom);
+				if (conflictFind == NULL) { // there was no conflict, so just copy the binding in place of the import placeholder node
+					if (copyImport) { // if this is a copy-import
+						*importSt = SymbolTree(*binding, importParent, binding); // scope to the local environment
+					} else { // else if this is not a copy-import
+						*importSt = SymbolTree(*binding, binding->parent, NULL); // scope to the foreign environment
+					}
+				} else { // else if there was a conflict, flag an error
+					Token curDefToken = importId->child->t; // child of NonArrayedIdentifier or ArrayedIdentifier
+					Token prevDefToken;
+					if (conflictFind->defSite != NULL) { // if there is a definition site for the previous symbol
+						prevDefToken = conflictFind->defSite->t;
+					} else { // otherwise, it must be a standard definition, so make up the token as if it was
+						prevDefToken.fileIndex = STANDARD_LIBRARY_FILE_INDEX;
+						prevDefToken.row = 0;
+						prevDefToken.col = 0;
+					}
+					semmerError(curDefToken.fileIndex,curDefToken.row,curDefToken.col,"name conflict in importing '"<<importPathTip<<"'");
+					semmerError(prevDefToken.fileIndex,prevDefToken.row,prevDefToken.col,"-- (conflicting definition was here)");
+				}
+			} else /* if (importSt->kind == KIND_OPEN_IMPORT) */ { // else if this is an open-import
+				// verify that what's being open-imported is actually an object by finding an object-style child in the binding's children
+				const vector<SymbolTree *> &bindingChildList = binding->children.sorted();
+				vector<SymbolTree *>::const_iterator bindingChildIter;
+				for (bindingChildIter = bindingChildList.begin(); bindingChildIter != bindingChildList.end(); bindingChildIter++) {
+					if ((*bindingChildIter)->kind == KIND_OBJECT) {
+						break;
+					}
+				}
+				if (bindingChildIter != bindingChildList.end()) { // if we found an object-style child in this open-import's children (it's a valid open-impoprt of an object)
+					SymbolTree *bindingBase = *bindingChildIter; // KIND_OBJECT; this node's children are the ones we're going to import in
+					// add in the imported nodes, scanning for conflicts along the way
+					bool firstInsert = true;
+					vector<SymbolTree *> bindingBaseList = bindingBase->children.sorted(); // copy, since importing can mutate the scopes
+					for (vector<SymbolTree *>::const_iterator bindingBaseIter = bindingBaseList.begin(); bindingBaseIter != bindingBaseList.end(); bindingBaseIter++) {
+						// check for member naming conflicts (constructor type conflicts will be resolved later)
+						if (importParent->children.find((*bindingBaseIter)->atom) == NULL) { // if there were no member naming conflicts
+							if (firstInsert) { // if this is the first insertion, copy in place of the import placeholder node
+								if (copyImport) { // if this is a copy-import
+									*importSt = SymbolTree(**bindingBaseIter, importParent, *bindingBaseIter); // scope to the local environment
+								} else { // else if this is not a copy-import
+									*importSt = SymbolTree(**bindingBaseIter, (*bindingBaseIter)->parent, NULL); // scope to the foreign environment
+								}
+								firstInsert = false;
+							} else { // else if this is not the first insertion, latch in a copy of the child
+								SymbolTree *baseChildCopy = new SymbolTree(**bindingBaseIter, NULL, (copyImport) ? *bindingBaseIter : NULL); // build the copy, scoping to NULL for now
+								*(importSt->parent) *= baseChildCopy; // latch in the copy
+								// correct the scope based on whether this is a copy-import or not
+								if (copyImport) { // if this is a copy-import
+									baseChildCopy->parent = importParent; // scope to the local environment
+								} else { // else if this is not a copy-import
+									baseChildCopy->parent = (*bindingBaseIter)->parent; // scope to the foreign environment
+								}
 							}
-							semmerError(curDefToken.fileIndex,curDefToken.row,curDefToken.col,"open import on non-object '"<<importPathTip<<"'");
-							semmerError(prevDefToken.fileIndex,prevDefToken.row,prevDefToken.col,"-- (importing from here)");
+						} // else if there is a member naming conflict, do nothing; the import is overridden by what's already there
+					}
+				} else { // else if we didn't find an object-style child in this open-import's children (it's an open-impoprt of a non-object), flag an error
+					Token curDefToken = importId->child->t; // child of NonArrayedIdentifier or ArrayedIdentifier
+					Token prevDefToken;
+					if (binding->defSite != NULL) { // if there is a definition site for the previous symbol
+						prevDefToken = binding->defSite->t;
+					} else { // otherwise, it must be a standard definition, so make up the token as if it was
+						prevDefToken.fileIndex = STANDARD_LIBRARY_FILE_INDEX;
+						prevDefToken.row = 0;
+						prevDefToken.col = 0;
+					}
+					semmerError(curDefToken.fileIndex,curDefToken.row,curDefToken.col,"open import on non-object '"<<importPathTip<<"'");
+					semmerError(prevDefToken.fileIndex,prevDefToken.row,prevDefToken.col,"-- (importing from here)");
+				}
+			}
+		}
+	}
+	return (binding != NULL); // if no binding could be found, the import has to wait for one
+
+}
+
+// resolves imports with a worklist; a failed import is only re-attempted once one of the names in its path has been added to some scope
+// (nothing else that binding depends on changes during import resolution), and rounds are processed in declaration order as before
+void subImportDecls(const vector<SymbolTree *> &importList) {
+	bool stdExplicitlyImported = false;
+	unsigned int numImports = importList.size();
+	vector<bool> resolved(numImports, false);
+	vector<bool> scheduled(numImports, true); // whether the import is queued in the current or next round
+	vector<unsigned int> attempts(numImports, 0);
+	vector<vector<pair<unsigned int, unsigned int> > > waiters; // per atom, the imports blocked on it (and the attempt after which they blocked)
+	set<unsigned int> round; // the imports to attempt in the current round, in declaration order
+	set<unsigned int> nextRound;
+	for (unsigned int i=0; i<numImports; i++) {
+		round.insert(i);
+	}
+	vector<Atom> insertLog;
+	compilerContext->scopeInsertLog = &insertLog;
+	while (!round.empty()) { // per-round loop
+		bool progress = false;
+		while (!round.empty()) { // per-import loop
+			unsigned int cur = *(round.begin());
+			round.erase(round.begin());
+			scheduled[cur] = false;
+			attempts[cur]++;
+			vector<Atom> importPath;
+			bool success = subImportDecl(importList[cur], importPath, stdExplicitlyImported);
+			// wake up the imports waiting on any names that were just added; those later in the list get another try in this round, as before
+			for (unsigned int i=0; i<insertLog.size(); i++) {
+				if (insertLog[i] < waiters.size()) {
+					vector<pair<unsigned int, unsigned int> > &atomWaiters = waiters[insertLog[i]];
+					for (unsigned int j=0; j<atomWaiters.size(); j++) {
+						unsigned int waiter = atomWaiters[j].first;
+						if (!resolved[waiter] && !scheduled[waiter] && attempts[waiter] == atomWaiters[j].second) { // if this isn't a stale entry, requeue the import
+							scheduled[waiter] = true;
+							((waiter > cur) ? round : nextRound).insert(waiter);
 						}
 					}
+					atomWaiters.clear();
 				}
-			} else { // else if no binding could be found
-				redoList.push_back(*importIter); // log the failed node for rebinding during the next round
 			}
-		} // per-import loop
-		if (redoList.size() == importList.size()) { // if the import table has stabilized
-			for (vector<SymbolTree *>::const_iterator importIter = redoList.begin(); importIter != redoList.end(); importIter++) {
-				Token curToken = (*importIter)->defSite->t;
-				Tree *importdcn = (*importIter)->defSite->child->next;
-				Tree *importId = (*importdcn == TOKEN_NonArrayedIdentifier || *importdcn == TOKEN_ArrayedIdentifier) ?
-					(*importIter)->defSite->child->next :
-					(*importIter)->defSite->child->next->next; // NonArrayedIdentifier or ArrayedIdentifier
-				string importPath = *importId; // NonArrayedIdentifier or ArrayedIdentifier
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"cannot resolve import '"<<importPath<<"'");
+			insertLog.clear();
+			if (success) {
+				resolved[cur] = true;
+				progress = true;
+			} else { // else if the import failed, block it on all of the names in its path
+				for (unsigned int i=0; i<importPath.size(); i++) {
+					if (importPath[i] >= waiters.size()) {
+						waiters.resize(importPath[i]+1);
+					}
+					waiters[importPath[i]].push_back(make_pair(cur, attempts[cur]));
+				}
 			}
+		} // per-import loop
+		if (!progress) { // if the import table has stabilized
 			break;
-		} else { // else if the import table hasn't stabilized yet, do another substitution round on the failed binding list
-			importList = redoList;
 		}
-	} // per-change loop
+		round.swap(nextRound);
+	} // per-round loop
+	compilerContext->scopeInsertLog = NULL;
+	// flag errors for all of the imports that we couldn't resolve
+	for (unsigned int i=0; i<numImports; i++) {
+		if (!resolved[i]) {
+			SymbolTree *importSt = importList[i];
+			Token curToken = importSt->defSite->t;
+			Tree *importdcn = importSt->defSite->child->next;
+			Tree *importId = (*importdcn == TOKEN_NonArrayedIdentifier || *importdcn == TOKEN_ArrayedIdentifier) ?
+				importSt->defSite->child->next :
+				importSt->defSite->child->next->next; // NonArrayedIdentifier or ArrayedIdentifier
+			string importPath = *importId; // NonArrayedIdentifier or ArrayedIdentifier
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"cannot resolve import '"<<importPath<<"'");
+		}
+	}
 }
 
 // recursively derives the Type trees and offsets of all non-inlined semantic-impacting nodes in the passed-in SymbolTree
@@ -853,13 +1418,32 @@ void semSt(SymbolTree *root, SymbolTree *parent = NULL) {
 		getStatusSymbolTree(root, parent);
 	}
 	// recurse on this node's children
-	for (map<string, SymbolTree *>::const_iterator iter = root->children.begin(); iter != root->children.end(); iter++) {
-		semSt((*iter).second, root);
+	// note: typing can add fake nodes to this scope (which rebuilds the cached order in place), so index rather than hold an iterator
+	const vector<SymbolTree *> &childList = root->children.sorted();
+	for (unsigned int i=0; i < childList.size(); i++) {
+		semSt(childList[i], root);
+	}
+}
+
+// flags lookups of a Declaration that this thread is still deriving further up its stack (i.e. through the thunk published by an Object or Filter Declaration)
+// what such derivations come out as can depend on where the recursion was entered, so interface summaries aren't written for compilations that have them
+void checkDeclarationReentry(Tree *tree) {
+	if (semmerMode() == SEMMER_THREADED) { // only this thread's own derivations are on its stack
+		unsigned int cur = __atomic_load_n(&(tree->claim), __ATOMIC_ACQUIRE);
+		if ((cur & CLAIM_DONE) || (cur & CLAIM_TASK) != semmerTask) {
+			return;
+		}
+	}
+	if (tree->status.type != NULL && tree->status.retType == errType()) { // getStatusDeclaration() leaves the recursion alert set until it's done
+		__sync_lock_test_and_set(&compilerContext->declarationReentered, true); // (threads can flag it concurrently)
 	}
 }
 
 // reports errors; derives the status of this SymbolTree node, as well as deriving its subnode offset properties
 TypeStatus getStatusSymbolTree(SymbolTree *root, SymbolTree *parent, const TypeStatus &inStatus) {
+	if (root->kind == KIND_DECLARATION) {
+		checkDeclarationReentry(root->defSite);
+	}
 	GET_STATUS_SYMBOL_TREE_HEADER;
 	if (root->kind == KIND_DECLARATION) { // if the symbol was defined as a Declaration-style node
 		returnStatus(getStatusDeclaration(tree));
@@ -876,26 +1460,31 @@ TypeStatus getStatusSymbolTree(SymbolTree *root, SymbolTree *parent, const TypeS
 	}
 	GET_STATUS_CODE;
 	// ensure that this isn't a copy-import of a non-referensible node
-	if (root->copyImportSite != NULL && !(root->defSite->status.type->referensible)) { // if it's a copy-import of a non-referensible type, flag an error
-		Token curToken = root->defSite->t;
-		Token sourceToken = root->copyImportSite->defSite->t;
-		semmerError(curToken.fileIndex,curToken.row,curToken.col,"copy import of non-referensible identifier '"<<root->copyImportSite->id<<"'");
-	}
+	verifyCopyImport(root);
 	// generate the intermediate code tree
 	if (root->kind == KIND_DECLARATION || root->kind == KIND_INSTRUCTOR || root->kind == KIND_OUTSTRUCTOR || root->kind == KIND_INSTANTIATION) {
 		returnCode(tree->code());
 	} else if (root->kind == KIND_PARAMETER || root->kind == KIND_FAKE) {
-		returnCode(nopCode);
+		returnCode(nopCode());
 	}
 	GET_STATUS_FOOTER;
 }
 
+// reports errors; flags a copy-import of a non-referensible node (done on every lookup of the node, not just the first)
+void verifyCopyImport(SymbolTree *root) {
+	if (root->copyImportSite != NULL && !(root->defSite->status.type->referensible)) { // if it's a copy-import of a non-referensible type, flag an error
+		Token curToken = root->defSite->t;
+		semmerError(curToken.fileIndex,curToken.row,curToken.col,"copy import of non-referensible identifier '"<<root->copyImportSite->id<<"'");
+	}
+}
+
 // typing function definitions
 
 // reports errors
 TypeStatus getStatusIdentifier(Tree *tree, const TypeStatus &inStatus) {
 	GET_STATUS_HEADER;
-	string id = *tree; // string representation of this identifier
+	vector<Atom> id;
+	tree->atomPath(id); // the atom path of this identifier
 	pair<SymbolTree *, bool> binding = bindId(id, tree->env, inStatus);
 	SymbolTree *st = binding.first;
 	if (st != NULL) { // if we found a binding
@@ -910,395 +1499,400 @@ TypeStatus getStatusIdentifier(Tree *tree, const TypeStatus &inStatus) {
 		}
 	} else { // else if we couldn't find a binding
 		Token curToken = tree->t;
-		semmerError(curToken.fileIndex,curToken.row,curToken.col,"cannot resolve '"<<id<<"'");
+		semmerError(curToken.fileIndex,curToken.row,curToken.col,"cannot resolve '"<<rebuildId(id, id.size()-1)<<"'");
 	}
 	GET_STATUS_CODE;
 	GET_STATUS_FOOTER;
 }
 
+// Ast typing functions
+// note: these use the same GET_STATUS_* helper blocks as the Tree-level typing functions, memoizing into the Ast node's status
+
 // reports errors
-TypeStatus getStatusPrimaryBase(Tree *tree, const TypeStatus &inStatus) {
+TypeStatus getStatusAstLeaf(Ast *tree, const TypeStatus &inStatus) {
 	GET_STATUS_HEADER;
-	Tree *pbc = tree->child; // NonArrayedIdentifier, ArrayedIdentifier, SingleAccessor, PrimLiteral, or BracketedExp
-	if (*pbc == TOKEN_NonArrayedIdentifier || *pbc == TOKEN_ArrayedIdentifier) {
-		returnStatus(getStatusIdentifier(pbc, inStatus));
-	} else if (*pbc == TOKEN_SingleAccessor) { // if it's an accessed term
-		// first, derive the subtype
-		Tree *subSI = pbc->next; // NonArrayedIdentifier or ArrayedIdentifier
-		TypeStatus subStatus = getStatusIdentifier(subSI, inStatus); // NonArrayedIdentifier or ArrayedIdentifier
-		if (*subStatus) { // if we successfully derived a subtype
-			if ((*subStatus).suffix == SUFFIX_LATCH || (*subStatus).suffix == SUFFIX_STREAM) { // if the derived type is a latch or a stream
-				// copy the Type so that our mutations don't propagate to the NonArrayedIdentifier or ArrayedIdentifier
-				TypeStatus mutableSubStatus = subStatus;
-				mutableSubStatus.type = mutableSubStatus.type->copy();
-				// next, make sure the subtype is compatible with the accessor
-				if (mutableSubStatus.type->delatch()) {
-					returnStatus(mutableSubStatus);
-				} else {
-					Token curToken = pbc->child->t; // SLASH
-					semmerError(curToken.fileIndex,curToken.row,curToken.col,"delatch of incompatible type");
-					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (type is "<<subStatus<<")");
-					mutableSubStatus.type->erase();
-				}
-			} else { // else if the derived type isn't a latch or stream (and thus can't be delatched), error
-				Token curToken = pbc->t;
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"delatch of non-latch, non-stream '"<<subSI<<"'");
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (type is "<<inStatus<<")");
-			}
-		}
-	} else if (*pbc == TOKEN_Instantiation) {
-		returnStatus(getStatusInstantiation(pbc, inStatus));
-	} else if (*pbc == TOKEN_ExplicitFilter) {
-		getStatusFilter(pbc, inStatus); // blindly generates a thunk; never fails
-		returnStatus(verifyStatusFilter(pbc)); // return the status resulting from verifying the contents of this filter
-	} else if (*pbc == TOKEN_Object) {
-		getStatusObject(pbc, inStatus); // blindly generates a thunk; never fails
-		returnStatus(verifyStatusObject(pbc)); // return the status resulting from verifying the contents of this object
-	} else if (*pbc == TOKEN_PrimLiteral) {
-		returnStatus(getStatusPrimLiteral(pbc, inStatus));
-	} else if (*pbc == TOKEN_BracketedExp) {
-		returnStatus(getStatusBracketedExp(pbc, inStatus));
-	} else if (*pbc == TOKEN_PrimaryBase) { // postfix operator application
-		TypeStatus baseStatus = getStatusPrimaryBase(pbc, inStatus); // derive the status of the base node
-		if (*baseStatus) { // if we managed to derive the status of the base node
-			if (*baseStatus >> *stdIntType) { // if the base can be converted into an int, return int
-				returnType(new StdType(STD_INT, SUFFIX_LATCH));
-			} else { // else if we couldn't apply the operator to the type of the subnode, flag an error
-				Token curToken = pbc->next->child->t; // the actual operator token
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"postfix operation '"<<curToken.s<<"' on invalid type");
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (type is "<<baseStatus<<")");
-			}
+	Tree *leaf = tree->tree; // NonArrayedIdentifier, ArrayedIdentifier, Instantiation, ExplicitFilter, Object, or PrimLiteral
+	switch (tree->kind) {
+		case AST_IDENTIFIER:
+			returnStatus(getStatusIdentifier(leaf, inStatus));
+		case AST_INSTANTIATION:
+			returnStatus(getStatusInstantiation(leaf, inStatus));
+		case AST_FILTER:
+			getStatusFilter(leaf, inStatus); // blindly generates a thunk; never fails
+			returnStatus(verifyStatusFilter(leaf)); // return the status resulting from verifying the contents of this filter
+		case AST_OBJECT:
+			getStatusObject(leaf, inStatus); // blindly generates a thunk; never fails
+			returnStatus(verifyStatusObject(leaf)); // return the status resulting from verifying the contents of this object
+		case AST_LITERAL:
+			returnStatus(getStatusPrimLiteral(leaf, inStatus));
+		default: // can't happen; the above should cover all leaf kinds
+			break;
+	}
+	GET_STATUS_CODE;
+	returnCode(leaf->code());
+	GET_STATUS_FOOTER;
+}
+
+// reports errors
+TypeStatus getStatusAstDelatch(Ast *tree, const TypeStatus &inStatus) {
+	GET_STATUS_HEADER;
+	// first, derive the subtype
+	Tree *subSI = tree->left->tree; // NonArrayedIdentifier or ArrayedIdentifier
+	TypeStatus subStatus = getStatusAst(tree->left, inStatus);
+	if (*subStatus) { // if we successfully derived a subtype
+		if ((*subStatus).suffix == SUFFIX_LATCH || (*subStatus).suffix == SUFFIX_STREAM) { // if the derived type is a latch or a stream
+			// copy the Type so that our mutations don't propagate to the NonArrayedIdentifier or ArrayedIdentifier
+			TypeStatus mutableSubStatus = subStatus;
+			mutableSubStatus.type = mutableSubStatus.type->copy();
+			// next, make sure the subtype is compatible with the accessor
+			if (mutableSubStatus.type->delatch()) {
+				returnStatus(mutableSubStatus);
+			} else {
+				Token curToken = tree->op->t; // SLASH
+				semmerError(curToken.fileIndex,curToken.row,curToken.col,"delatch of incompatible type");
+				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (type is "<<subStatus<<")");
+				mutableSubStatus.type->erase();
+			}
+		} else { // else if the derived type isn't a latch or stream (and thus can't be delatched), error
+			Token curToken = tree->tree->t; // SingleAccessor
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"delatch of non-latch, non-stream '"<<subSI<<"'");
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (type is "<<inStatus<<")");
 		}
 	}
 	GET_STATUS_CODE;
-	if (*pbc == TOKEN_NonArrayedIdentifier || *pbc == TOKEN_ArrayedIdentifier ||
-			*pbc == TOKEN_Instantiation || *pbc == TOKEN_ExplicitFilter || *pbc == TOKEN_Object || *pbc == TOKEN_PrimLiteral || *pbc == TOKEN_BracketedExp) {
-		returnCode(pbc->code());
-	} else if (*pbc == TOKEN_SingleAccessor) { // if it's an accessed term
-		// first, derive the subtype
-		Tree *subSI = pbc->next; // NonArrayedIdentifier or ArrayedIdentifier
-		TypeStatus subStatus = getStatusIdentifier(subSI, inStatus); // NonArrayedIdentifier or ArrayedIdentifier
-		if (*subStatus) { // if we successfully derived a subtype
-			if ((*subStatus).suffix == SUFFIX_LATCH) { // if we're delatching from a latch
-				// LOL delatching-from-latch code
-			} else if ((*subStatus).suffix == SUFFIX_STREAM) { // else if we're delatching from a stream
-				// LOL delatching-from-stream code
-			}
-		}
-	} else if (*pbc == TOKEN_PrimaryBase) { // postfix operator application
-		Tree *op = pbc->next->child; // the actual operator token
-		if (*op == TOKEN_DPLUS) {
-			returnCode(new TempTree(new BinOpTree(BINOP_PLUS_INT, pbc->castCode(*stdIntType), new WordTree(1))));
-		} else /* if (*op == TOKEN_DMINUS) */ {
-			returnCode(new TempTree(new BinOpTree(BINOP_MINUS_INT, pbc->castCode(*stdIntType), new WordTree(1))));
+	if (tree->left->status->suffix == SUFFIX_LATCH) { // if we're delatching from a latch
+		// LOL delatching-from-latch code
+	} else if (tree->left->status->suffix == SUFFIX_STREAM) { // else if we're delatching from a stream
+		// LOL delatching-from-stream code
+	}
+	GET_STATUS_FOOTER;
+}
+
+// reports errors
+TypeStatus getStatusAstPostfix(Ast *tree, const TypeStatus &inStatus) {
+	GET_STATUS_HEADER;
+	TypeStatus baseStatus = getStatusAst(tree->left, inStatus); // derive the status of the base node
+	if (*baseStatus) { // if we managed to derive the status of the base node
+		if (*baseStatus >> *stdIntType()) { // if the base can be converted into an int, return int
+			returnType(internStdType(STD_INT, SUFFIX_LATCH));
+		} else { // else if we couldn't apply the operator to the type of the subnode, flag an error
+			Token curToken = tree->op->t; // the actual operator token
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"postfix operation '"<<curToken.s()<<"' on invalid type");
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (type is "<<baseStatus<<")");
 		}
 	}
+	GET_STATUS_CODE;
+	if (*(tree->op) == TOKEN_DPLUS) {
+		returnCode(new TempTree(new BinOpTree(BINOP_PLUS_INT, tree->left->status.castCode(*stdIntType()), new WordTree(1))));
+	} else /* if (*(tree->op) == TOKEN_DMINUS) */ {
+		returnCode(new TempTree(new BinOpTree(BINOP_MINUS_INT, tree->left->status.castCode(*stdIntType()), new WordTree(1))));
+	}
 	GET_STATUS_FOOTER;
 }
 
 // reports errors
-TypeStatus getStatusPrimary(Tree *tree, const TypeStatus &inStatus) {
+TypeStatus getStatusAstPrefix(Ast *tree, const TypeStatus &inStatus) {
 	GET_STATUS_HEADER;
-	Tree *primaryc = tree->child; // PrimaryBase or PrefixOrMultiOp
-	if (*primaryc == TOKEN_PrimaryBase) { // if it's a raw PrimaryBase
-		returnStatus(getStatusPrimaryBase(primaryc, inStatus));
-	} else if (*primaryc == TOKEN_PrefixOrMultiOp) { // else if it's a PrefixOrMultiOp'ed Primary node
-		TypeStatus subStatus = getStatusPrimary(primaryc->next, inStatus); // derive the status of the sub-node
-		if (*subStatus) { // if we managed to derive the status of the sub-node
-			Tree *pomocc = primaryc->child->child;
-			if (*pomocc == TOKEN_NOT) {
-				if (*subStatus >> *stdBoolType) {
-					returnType(new StdType(STD_BOOL, SUFFIX_LATCH));
-				}
-			} else if (*pomocc == TOKEN_COMPLEMENT) {
-				if (*subStatus >> *stdIntType) {
-					returnType(new StdType(STD_INT, SUFFIX_LATCH));
-				}
-			} else /* if (*pomocc == TOKEN_PLUS || *pomocc == TOKEN_MINUS) */ {
-				if (*subStatus >> *stdIntType) {
-					returnType(new StdType(STD_INT, SUFFIX_LATCH));
-				}
-				if (*subStatus >> *stdFloatType) {
-					returnType(new StdType(STD_FLOAT, SUFFIX_LATCH));
-				}
+	TypeStatus subStatus = getStatusAst(tree->left, inStatus); // derive the status of the sub-node
+	if (*subStatus) { // if we managed to derive the status of the sub-node
+		if (*(tree->op) == TOKEN_NOT) {
+			if (*subStatus >> *stdBoolType()) {
+				returnType(internStdType(STD_BOOL, SUFFIX_LATCH));
+			}
+		} else if (*(tree->op) == TOKEN_COMPLEMENT) {
+			if (*subStatus >> *stdIntType()) {
+				returnType(internStdType(STD_INT, SUFFIX_LATCH));
+			}
+		} else /* if (*(tree->op) == TOKEN_PLUS || *(tree->op) == TOKEN_MINUS) */ {
+			if (*subStatus >> *stdIntType()) {
+				returnType(internStdType(STD_INT, SUFFIX_LATCH));
+			}
+			if (*subStatus >> *stdFloatType()) {
+				returnType(internStdType(STD_FLOAT, SUFFIX_LATCH));
 			}
-			// we couldn't derive a valid type for this prefix operation, so flag an error
-			Token curToken = primaryc->child->child->t; // the actual operator token
-			semmerError(curToken.fileIndex,curToken.row,curToken.col,"prefix operation '"<<curToken.s<<"' on invalid type");
-			semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (type is "<<subStatus<<")");
 		}
+		// we couldn't derive a valid type for this prefix operation, so flag an error
+		Token curToken = tree->op->t; // the actual operator token
+		semmerError(curToken.fileIndex,curToken.row,curToken.col,"prefix operation '"<<curToken.s()<<"' on invalid type");
+		semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (type is "<<subStatus<<")");
 	}
 	GET_STATUS_CODE;
-	if (*primaryc == TOKEN_PrimaryBase) {
-		returnCode(primaryc->code());
-	} else if (*primaryc == TOKEN_PrefixOrMultiOp) {
-		Tree *primarycn = primaryc->next;
-		Tree *pomocc = primaryc->child->child;
-		if (*pomocc == TOKEN_NOT) {
-			returnCode(new TempTree(new UnOpTree(UNOP_NOT_BOOL, primarycn->castCode(*stdBoolType))));
-		} else if (*pomocc == TOKEN_COMPLEMENT) {
-			returnCode(new TempTree(new UnOpTree(UNOP_COMPLEMENT_INT, primarycn->castCode(*stdIntType))));
-		} else if (*pomocc == TOKEN_PLUS) {
-			if (*(primarycn->status) >> *stdIntType) {
-				returnCode(primarycn->castCode(*stdIntType));
-			} else /* if (*(primarycn->status) >> *stdFloatType) */ {
-				returnCode(primarycn->castCode(*stdFloatType));
-			}
-		} else if (*pomocc == TOKEN_MINUS) {
-			if (*(primarycn->status) >> *stdIntType) {
-				returnCode(new TempTree(new UnOpTree(UNOP_MINUS_INT, primarycn->castCode(*stdIntType))));
-			} else /* if (*(primarycn->status) >> *stdFloatType) */ {
-				returnCode(new TempTree(new UnOpTree(UNOP_MINUS_FLOAT, primarycn->castCode(*stdFloatType))));
-			}
+	const TypeStatus &sub = tree->left->status;
+	if (*(tree->op) == TOKEN_NOT) {
+		returnCode(new TempTree(new UnOpTree(UNOP_NOT_BOOL, sub.castCode(*stdBoolType()))));
+	} else if (*(tree->op) == TOKEN_COMPLEMENT) {
+		returnCode(new TempTree(new UnOpTree(UNOP_COMPLEMENT_INT, sub.castCode(*stdIntType()))));
+	} else if (*(tree->op) == TOKEN_PLUS) {
+		if (*sub >> *stdIntType()) {
+			returnCode(sub.castCode(*stdIntType()));
+		} else /* if (*sub >> *stdFloatType()) */ {
+			returnCode(sub.castCode(*stdFloatType()));
+		}
+	} else if (*(tree->op) == TOKEN_MINUS) {
+		if (*sub >> *stdIntType()) {
+			returnCode(new TempTree(new UnOpTree(UNOP_MINUS_INT, sub.castCode(*stdIntType()))));
+		} else /* if (*sub >> *stdFloatType()) */ {
+			returnCode(new TempTree(new UnOpTree(UNOP_MINUS_FLOAT, sub.castCode(*stdFloatType()))));
 		}
 	}
 	GET_STATUS_FOOTER;
 }
 
-TypeStatus getStatusBracketedExp(Tree *tree, const TypeStatus &inStatus) {
+// reports errors
+TypeStatus getStatusAstInfix(Ast *tree, const TypeStatus &inStatus) {
 	GET_STATUS_HEADER;
-	Tree *becn = tree->child->next; // RBRACKET or ExpList
-	if (*becn == TOKEN_RBRACKET) {
-		returnTypeRet(nullType, inStatus.retType);
-	} else /* if (*becn == TOKEN_ExpList) */ {
-		Tree *exp = becn->child;
-		if (exp->next == NULL) { // if it's just a single Exp
-			returnStatus(getStatusExp(exp, inStatus));
-		} else { // else if it's a true ExpList, we must derive the corresponding TypeList
-			bool failed = false;
-			vector<Type *> list;
-			for (; exp != NULL; exp = (exp->next != NULL) ? exp->next->next->child : NULL) {
-				Type *thisExpType = getStatusExp(exp, inStatus);
-				list.push_back(thisExpType);
-				if (!(*thisExpType)) {
-					failed = true;
-				}
-			}
-			if (!failed) {
-				returnTypeRet(new TypeList(list), inStatus.retType);
+	TypeStatus left = getStatusAst(tree->left, inStatus);
+	TypeStatus right = getStatusAst(tree->right, inStatus);
+	if (*left && *right) { // if we derived the types of both operands successfully
+		if (!(left->suffix == SUFFIX_CONSTANT || left->suffix == SUFFIX_LATCH)) {
+			Token curToken = tree->left->site->t; // Exp
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"left operand of expression is not a constant or latch");
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (operand type is "<<left<<")");
+		} else if (!(right->suffix == SUFFIX_CONSTANT || right->suffix == SUFFIX_LATCH)) {
+			Token curToken = tree->right->site->t; // Exp
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"right operand of expression is not a constant or latch");
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (operand type is "<<right<<")");
+		} else {
+			switch (tree->op->t.tokenType) {
+				case TOKEN_DOR:
+				case TOKEN_DAND:
+					if ((*left >> *stdBoolType()) && (*right >> *stdBoolType())) {
+						returnType(internStdType(STD_BOOL, SUFFIX_LATCH));
+					}
+					break;
+				case TOKEN_OR:
+				case TOKEN_XOR:
+				case TOKEN_AND:
+					if ((*left >> *stdIntType()) && (*right >> *stdIntType())) {
+						returnType(internStdType(STD_INT, SUFFIX_LATCH));
+					}
+					break;
+				case TOKEN_DEQUALS:
+				case TOKEN_NEQUALS:
+				case TOKEN_LT:
+				case TOKEN_GT:
+				case TOKEN_LE:
+				case TOKEN_GE:
+					if (left->isComparable(*right)) {
+						returnType(internStdType(STD_BOOL, SUFFIX_LATCH));
+					}
+					break;
+				case TOKEN_LS:
+				case TOKEN_RS:
+					if ((*left >> *stdIntType()) && (*right >> *stdIntType())) {
+						returnType(internStdType(STD_INT, SUFFIX_LATCH));
+					}
+					break;
+				case TOKEN_TIMES:
+				case TOKEN_DIVIDE:
+				case TOKEN_MOD:
+				case TOKEN_PLUS:
+				case TOKEN_MINUS:
+					if ((*left >> *stdIntType()) && (*right >> *stdIntType())) {
+						returnType(internStdType(STD_INT, SUFFIX_LATCH));
+					}
+					if ((*left >> *stdFloatType()) && (*right >> *stdFloatType())) {
+						returnType(internStdType(STD_FLOAT, SUFFIX_LATCH));
+					}
+					// if both terms are convertible to string, return string
+					if ((*left >> *stdStringType()) && (*right >> *stdStringType())) {
+						returnType(internStdType(STD_STRING, SUFFIX_LATCH));
+					}
+					break;
+				default: // can't happen; the above should cover all cases
+					break;
 			}
+			// if we couldn't resolve a type for this expression (or else we would have returned it above)
+			Token curToken = tree->op->t; // the actual operator token
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"infix operation '"<<curToken.s()<<"' on invalid operands");
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (left operand type is "<<left<<")");
+			semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (right operand type is "<<right<<")");
 		}
 	}
 	GET_STATUS_CODE;
-	if (*becn == TOKEN_RBRACKET) {
-		returnCode(nopCode);
-	} else /* if (*becn == TOKEN_ExpList) */ {
-		Tree *exp = becn->child;
-		if (exp->next == NULL) { // if it's just a single Exp
-			returnCode(exp->code());
-		} else { // else if it's a true ExpList
-			vector<DataTree *> dataList;
-			for (; exp != NULL; exp = (exp->next != NULL) ? exp->next->next->child : NULL) {
-				dataList.push_back((DataTree *)(exp->code()));
+	const TypeStatus &expLeft = tree->left->status;
+	const TypeStatus &expRight = tree->right->status;
+	switch (tree->op->t.tokenType) {
+		case TOKEN_DOR:
+			returnCode(new TempTree(new BinOpTree(BINOP_DOR_BOOL, expLeft.castCode(*stdBoolType()), expRight.castCode(*stdBoolType()))));
+		case TOKEN_DAND:
+			returnCode(new TempTree(new BinOpTree(BINOP_DAND_BOOL, expLeft.castCode(*stdBoolType()), expRight.castCode(*stdBoolType()))));
+		case TOKEN_OR:
+			returnCode(new TempTree(new BinOpTree(BINOP_OR_INT, expLeft.castCode(*stdIntType()), expRight.castCode(*stdIntType()))));
+		case TOKEN_XOR:
+			returnCode(new TempTree(new BinOpTree(BINOP_XOR_INT, expLeft.castCode(*stdIntType()), expRight.castCode(*stdIntType()))));
+		case TOKEN_AND:
+			returnCode(new TempTree(new BinOpTree(BINOP_AND_INT, expLeft.castCode(*stdIntType()), expRight.castCode(*stdIntType()))));
+		case TOKEN_DEQUALS:
+			returnCode(new TempTree(new BinOpTree(BINOP_DEQUALS, expLeft.castCommonCode(*(expRight.type)), expRight.castCommonCode(*(expLeft.type)))));
+		case TOKEN_NEQUALS:
+			returnCode(new TempTree(new BinOpTree(BINOP_NEQUALS, expLeft.castCommonCode(*(expRight.type)), expRight.castCommonCode(*(expLeft.type)))));
+		case TOKEN_LT:
+			returnCode(new TempTree(new BinOpTree(BINOP_LT, expLeft.castCommonCode(*(expRight.type)), expRight.castCommonCode(*(expLeft.type)))));
+		case TOKEN_GT:
+			returnCode(new TempTree(new BinOpTree(BINOP_GT, expLeft.castCommonCode(*(expRight.type)), expRight.castCommonCode(*(expLeft.type)))));
+		case TOKEN_LE:
+			returnCode(new TempTree(new BinOpTree(BINOP_LE, expLeft.castCommonCode(*(expRight.type)), expRight.castCommonCode(*(expLeft.type)))));
+		case TOKEN_GE:
+			returnCode(new TempTree(new BinOpTree(BINOP_GE, expLeft.castCommonCode(*(expRight.type)), expRight.castCommonCode(*(expLeft.type)))));
+		case TOKEN_LS:
+			returnCode(new TempTree(new BinOpTree(BINOP_LS_INT, expLeft.castCode(*stdIntType()), expRight.castCode(*stdIntType()))));
+		case TOKEN_RS:
+			returnCode(new TempTree(new BinOpTree(BINOP_RS_INT, expLeft.castCode(*stdIntType()), expRight.castCode(*stdIntType()))));
+		case TOKEN_TIMES:
+			if ((*expLeft >> *stdIntType()) && (*expRight >> *stdIntType())) {
+				returnCode(new TempTree(new BinOpTree(BINOP_TIMES_INT, expLeft.castCode(*stdIntType()), expRight.castCode(*stdIntType()))));
+			} else /* if ((*expLeft >> *stdFloatType()) && (*expRight >> *stdFloatType())) */ {
+				returnCode(new TempTree(new BinOpTree(BINOP_TIMES_FLOAT, expLeft.castCode(*stdFloatType()), expRight.castCode(*stdFloatType()))));
 			}
-			returnCode(new CompoundTree(dataList));
-		}
+		case TOKEN_DIVIDE:
+			if ((*expLeft >> *stdIntType()) && (*expRight >> *stdIntType())) {
+				returnCode(new TempTree(new BinOpTree(BINOP_DIVIDE_INT, expLeft.castCode(*stdIntType()), expRight.castCode(*stdIntType()))));
+			} else /* if ((*expLeft >> *stdFloatType()) && (*expRight >> *stdFloatType())) */ {
+				returnCode(new TempTree(new BinOpTree(BINOP_DIVIDE_FLOAT, expLeft.castCode(*stdFloatType()), expRight.castCode(*stdFloatType()))));
+			}
+		case TOKEN_MOD:
+			if ((*expLeft >> *stdIntType()) && (*expRight >> *stdIntType())) {
+				returnCode(new TempTree(new BinOpTree(BINOP_MOD_INT, expLeft.castCode(*stdIntType()), expRight.castCode(*stdIntType()))));
+			} else /* if ((*expLeft >> *stdFloatType()) && (*expRight >> *stdFloatType())) */ {
+				returnCode(new TempTree(new BinOpTree(BINOP_MOD_FLOAT, expLeft.castCode(*stdFloatType()), expRight.castCode(*stdFloatType()))));
+			}
+		case TOKEN_PLUS:
+			if ((*expLeft >> *stdIntType()) && (*expRight >> *stdIntType())) {
+				returnCode(new TempTree(new BinOpTree(BINOP_PLUS_INT, expLeft.castCode(*stdIntType()), expRight.castCode(*stdIntType()))));
+			} else if ((*expLeft >> *stdFloatType()) && (*expRight >> *stdFloatType())) {
+				returnCode(new TempTree(new BinOpTree(BINOP_PLUS_FLOAT, expLeft.castCode(*stdFloatType()), expRight.castCode(*stdFloatType()))));
+			} else /* if ((*expLeft >> *stdStringType()) && (*expRight >> *stdStringType())) */ {
+				returnCode(new TempTree(new BinOpTree(BINOP_PLUS_STRING, expLeft.castCode(*stdStringType()), expRight.castCode(*stdStringType()))));
+			}
+		case TOKEN_MINUS:
+			if ((*expLeft >> *stdIntType()) && (*expRight >> *stdIntType())) {
+				returnCode(new TempTree(new BinOpTree(BINOP_MINUS_INT, expLeft.castCode(*stdIntType()), expRight.castCode(*stdIntType()))));
+			} else /* if ((*expLeft >> *stdFloatType()) && (*expRight >> *stdFloatType())) */ {
+				returnCode(new TempTree(new BinOpTree(BINOP_MINUS_FLOAT, expLeft.castCode(*stdFloatType()), expRight.castCode(*stdFloatType()))));
+			}
+		default: // can't happen; the above should cover all cases
+			break;
 	}
 	GET_STATUS_FOOTER;
 }
 
-// reports errors
-TypeStatus getStatusExp(Tree *tree, const TypeStatus &inStatus) {
+TypeStatus getStatusAstBracketed(Ast *tree, const TypeStatus &inStatus) {
 	GET_STATUS_HEADER;
-	Tree *expc = tree->child;
-	if (*expc == TOKEN_Primary) {
-		returnStatus(getStatusPrimary(expc, inStatus));
-	} else if (*expc == TOKEN_Exp) {
-		Tree *expLeft = expc;
-		Tree *op = expLeft->next;
-		Tree *expRight = op->next;
-		TypeStatus left = getStatusExp(expLeft, inStatus);
-		TypeStatus right = getStatusExp(expRight, inStatus);
-		if (*left && *right) { // if we derived the types of both operands successfully
-			if (!(left->suffix == SUFFIX_CONSTANT || left->suffix == SUFFIX_LATCH)) {
-				Token curToken = expLeft->t; // Exp
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"left operand of expression is not a constant or latch");
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (operand type is "<<left<<")");
-			} else if (!(right->suffix == SUFFIX_CONSTANT || right->suffix == SUFFIX_LATCH)) {
-				Token curToken = expRight->t; // Exp
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"right operand of expression is not a constant or latch");
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (operand type is "<<right<<")");
-			} else {
-				switch (op->t.tokenType) {
-					case TOKEN_DOR:
-					case TOKEN_DAND:
-						if ((*left >> *stdBoolType) && (*right >> *stdBoolType)) {
-							returnType(new StdType(STD_BOOL, SUFFIX_LATCH));
-						}
-						break;
-					case TOKEN_OR:
-					case TOKEN_XOR:
-					case TOKEN_AND:
-						if ((*left >> *stdIntType) && (*right >> *stdIntType)) {
-							returnType(new StdType(STD_INT, SUFFIX_LATCH));
-						}
-						break;
-					case TOKEN_DEQUALS:
-					case TOKEN_NEQUALS:
-					case TOKEN_LT:
-					case TOKEN_GT:
-					case TOKEN_LE:
-					case TOKEN_GE:
-						if (left->isComparable(*right)) {
-							returnType(new StdType(STD_BOOL, SUFFIX_LATCH));
-						}
-						break;
-					case TOKEN_LS:
-					case TOKEN_RS:
-						if ((*left >> *stdIntType) && (*right >> *stdIntType)) {
-							returnType(new StdType(STD_INT, SUFFIX_LATCH));
-						}
-						break;
-					case TOKEN_TIMES:
-					case TOKEN_DIVIDE:
-					case TOKEN_MOD:
-					case TOKEN_PLUS:
-					case TOKEN_MINUS:
-						if ((*left >> *stdIntType) && (*right >> *stdIntType)) {
-							returnType(new StdType(STD_INT, SUFFIX_LATCH));
-						}
-						if ((*left >> *stdFloatType) && (*right >> *stdFloatType)) {
-							returnType(new StdType(STD_FLOAT, SUFFIX_LATCH));
-						}
-						// if both terms are convertible to string, return string
-						if ((*left >> *stdStringType) && (*right >> *stdStringType)) {
-							returnType(new StdType(STD_STRING, SUFFIX_LATCH));
-						}
-						break;
-					default: // can't happen; the above should cover all cases
-						break;
-				}
-				// if we couldn't resolve a type for this expression (or else we would have returned it above)
-				Token curToken = op->t; // the actual operator token
-				Token curTokenLeft = expLeft->t; // the left operand
-				Token curTokenRight = expRight->t; // the right operand
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"infix operation '"<<curToken.s<<"' on invalid operands");
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (left operand type is "<<left<<")");
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (right operand type is "<<right<<")");
+	if (tree->left == NULL) { // if the brackets are empty
+		returnTypeRet(nullType(), inStatus.retType);
+	} else if (tree->left->next == NULL) { // else if it's just a single Exp
+		returnStatus(getStatusAst(tree->left, inStatus));
+	} else { // else if it's a true ExpList, we must derive the corresponding TypeList
+		bool failed = false;
+		vector<Type *> list;
+		for (Ast *exp = tree->left; exp != NULL; exp = exp->next) {
+			Type *thisExpType = getStatusAst(exp, inStatus);
+			list.push_back(thisExpType);
+			if (!(*thisExpType)) {
+				failed = true;
 			}
 		}
+		if (!failed) {
+			returnTypeRet(new TypeList(list), inStatus.retType);
+		}
 	}
 	GET_STATUS_CODE;
-	if (*expc == TOKEN_Primary) {
-		returnCode(expc->code());
-	} else {
-		Tree *expLeft = expc;
-		Tree *op = expLeft->next;
-		Tree *expRight = op->next;
-		switch (op->t.tokenType) {
-			case TOKEN_DOR:
-				returnCode(new TempTree(new BinOpTree(BINOP_DOR_BOOL, expLeft->castCode(*stdBoolType), expRight->castCode(*stdBoolType))));
-			case TOKEN_DAND:
-				returnCode(new TempTree(new BinOpTree(BINOP_DAND_BOOL, expLeft->castCode(*stdBoolType), expRight->castCode(*stdBoolType))));
-			case TOKEN_OR:
-				returnCode(new TempTree(new BinOpTree(BINOP_OR_INT, expLeft->castCode(*stdIntType), expRight->castCode(*stdIntType))));
-			case TOKEN_XOR:
-				returnCode(new TempTree(new BinOpTree(BINOP_XOR_INT, expLeft->castCode(*stdIntType), expRight->castCode(*stdIntType))));
-			case TOKEN_AND:
-				returnCode(new TempTree(new BinOpTree(BINOP_AND_INT, expLeft->castCode(*stdIntType), expRight->castCode(*stdIntType))));
-			case TOKEN_DEQUALS:
-				returnCode(new TempTree(new BinOpTree(BINOP_DEQUALS, expLeft->castCommonCode(expRight->typeRef()), expRight->castCommonCode(expLeft->typeRef()))));
-			case TOKEN_NEQUALS:
-				returnCode(new TempTree(new BinOpTree(BINOP_NEQUALS, expLeft->castCommonCode(expRight->typeRef()), expRight->castCommonCode(expLeft->typeRef()))));
-			case TOKEN_LT:
-				returnCode(new TempTree(new BinOpTree(BINOP_LT, expLeft->castCommonCode(expRight->typeRef()), expRight->castCommonCode(expLeft->typeRef()))));
-			case TOKEN_GT:
-				returnCode(new TempTree(new BinOpTree(BINOP_GT, expLeft->castCommonCode(expRight->typeRef()), expRight->castCommonCode(expLeft->typeRef()))));
-			case TOKEN_LE:
-				returnCode(new TempTree(new BinOpTree(BINOP_LE, expLeft->castCommonCode(expRight->typeRef()), expRight->castCommonCode(expLeft->typeRef()))));
-			case TOKEN_GE:
-				returnCode(new TempTree(new BinOpTree(BINOP_GE, expLeft->castCommonCode(expRight->typeRef()), expRight->castCommonCode(expLeft->typeRef()))));
-			case TOKEN_LS:
-				returnCode(new TempTree(new BinOpTree(BINOP_LS_INT, expLeft->castCode(*stdIntType), expRight->castCode(*stdIntType))));
-			case TOKEN_RS:
-				returnCode(new TempTree(new BinOpTree(BINOP_RS_INT, expLeft->castCode(*stdIntType), expRight->castCode(*stdIntType))));
-			case TOKEN_TIMES:
-				if ((*(expLeft->status) >> *stdIntType) && (*(expRight->status) >> *stdIntType)) {
-					returnCode(new TempTree(new BinOpTree(BINOP_TIMES_INT, expLeft->castCode(*stdIntType), expRight->castCode(*stdIntType))));
-				} else /* if ((*(expLeft->status) >> *stdFloatType) && (*(expRight->status) >> *stdFloatType)) */ {
-					returnCode(new TempTree(new BinOpTree(BINOP_TIMES_FLOAT, expLeft->castCode(*stdFloatType), expRight->castCode(*stdFloatType))));
-				}
-			case TOKEN_DIVIDE:
-				if ((*(expLeft->status) >> *stdIntType) && (*(expRight->status) >> *stdIntType)) {
-					returnCode(new TempTree(new BinOpTree(BINOP_DIVIDE_INT, expLeft->castCode(*stdIntType), expRight->castCode(*stdIntType))));
-				} else /* if ((*(expLeft->status) >> *stdFloatType) && (*(expRight->status) >> *stdFloatType)) */ {
-					returnCode(new TempTree(new BinOpTree(BINOP_DIVIDE_FLOAT, expLeft->castCode(*stdFloatType), expRight->castCode(*stdFloatType))));
-				}
-			case TOKEN_MOD:
-				if ((*(expLeft->status) >> *stdIntType) && (*(expRight->status) >> *stdIntType)) {
-					returnCode(new TempTree(new BinOpTree(BINOP_MOD_INT, expLeft->castCode(*stdIntType), expRight->castCode(*stdIntType))));
-				} else /* if ((*(expLeft->status) >> *stdFloatType) && (*(expRight->status) >> *stdFloatType)) */ {
-					returnCode(new TempTree(new BinOpTree(BINOP_MOD_FLOAT, expLeft->castCode(*stdFloatType), expRight->castCode(*stdFloatType))));
-				}
-			case TOKEN_PLUS:
-				if ((*(expLeft->status) >> *stdIntType) && (*(expRight->status) >> *stdIntType)) {
-					returnCode(new TempTree(new BinOpTree(BINOP_PLUS_INT, expLeft->castCode(*stdIntType), expRight->castCode(*stdIntType))));
-				} else if ((*(expLeft->status) >> *stdFloatType) && (*(expRight->status) >> *stdFloatType)) {
-					returnCode(new TempTree(new BinOpTree(BINOP_PLUS_FLOAT, expLeft->castCode(*stdFloatType), expRight->castCode(*stdFloatType))));
-				} else /* if ((*(expLeft->status) >> *stdStringType) && (*(expRight->status) >> *stdStringType)) */ {
-					returnCode(new TempTree(new BinOpTree(BINOP_PLUS_STRING, expLeft->castCode(*stdStringType), expRight->castCode(*stdStringType))));
-				}
-			case TOKEN_MINUS:
-				if ((*(expLeft->status) >> *stdIntType) && (*(expRight->status) >> *stdIntType)) {
-					returnCode(new TempTree(new BinOpTree(BINOP_MINUS_INT, expLeft->castCode(*stdIntType), expRight->castCode(*stdIntType))));
-				} else /* if ((*(expLeft->status) >> *stdFloatType) && (*(expRight->status) >> *stdFloatType)) */ {
-					returnCode(new TempTree(new BinOpTree(BINOP_MINUS_FLOAT, expLeft->castCode(*stdFloatType), expRight->castCode(*stdFloatType))));
-				}
-			default: // can't happen; the above should cover all cases
-				break;
+	if (tree->left == NULL) {
+		returnCode(nopCode());
+	} else if (tree->left->next == NULL) { // if it's just a single Exp
+		returnCode(tree->left->status.code);
+	} else { // else if it's a true ExpList
+		vector<DataTree *> dataList;
+		for (Ast *exp = tree->left; exp != NULL; exp = exp->next) {
+			dataList.push_back((DataTree *)(exp->status.code));
 		}
+		returnCode(new CompoundTree(dataList));
 	}
 	GET_STATUS_FOOTER;
 }
 
+TypeStatus getStatusAst(Ast *tree, const TypeStatus &inStatus) {
+	switch (tree->kind) {
+		case AST_DELATCH:
+			return getStatusAstDelatch(tree, inStatus);
+		case AST_POSTFIX:
+			return getStatusAstPostfix(tree, inStatus);
+		case AST_PREFIX:
+			return getStatusAstPrefix(tree, inStatus);
+		case AST_INFIX:
+			return getStatusAstInfix(tree, inStatus);
+		case AST_BRACKETED:
+			return getStatusAstBracketed(tree, inStatus);
+		default:
+			return getStatusAstLeaf(tree, inStatus);
+	}
+}
+
+// Tree-level entry points into the Ast typing functions
+
+TypeStatus getStatusBracketedExp(Tree *tree, const TypeStatus &inStatus) {
+	GET_STATUS_HEADER;
+	returnStatus(getStatusAst(tree->ast, inStatus));
+	GET_STATUS_CODE;
+	GET_STATUS_FOOTER;
+}
+
+TypeStatus getStatusExp(Tree *tree, const TypeStatus &inStatus) {
+	GET_STATUS_HEADER;
+	returnStatus(getStatusAst(tree->ast, inStatus));
+	GET_STATUS_CODE;
+	GET_STATUS_FOOTER;
+}
+
 TypeStatus getStatusPrimOpNode(Tree *tree, const TypeStatus &inStatus) {
 	GET_STATUS_HEADER;
 	Tree *ponc = tree->child->child; // the operator token itself
 	switch (ponc->t.tokenType) {
 		case TOKEN_NOT:
-			returnType(new StdType(STD_NOT, SUFFIX_LATCH));
+			returnType(internStdType(STD_NOT, SUFFIX_LATCH));
 		case TOKEN_COMPLEMENT:
-			returnType(new StdType(STD_COMPLEMENT, SUFFIX_LATCH));
+			returnType(internStdType(STD_COMPLEMENT, SUFFIX_LATCH));
 		case TOKEN_DPLUS:
-			returnType(new StdType(STD_DPLUS, SUFFIX_LATCH));
+			returnType(internStdType(STD_DPLUS, SUFFIX_LATCH));
 		case TOKEN_DMINUS:
-			returnType(new StdType(STD_DMINUS, SUFFIX_LATCH));
+			returnType(internStdType(STD_DMINUS, SUFFIX_LATCH));
 		case TOKEN_DOR:
-			returnType(new StdType(STD_DOR, SUFFIX_LATCH));
+			returnType(internStdType(STD_DOR, SUFFIX_LATCH));
 		case TOKEN_DAND:
-			returnType(new StdType(STD_DAND, SUFFIX_LATCH));
+			returnType(internStdType(STD_DAND, SUFFIX_LATCH));
 		case TOKEN_OR:
-			returnType(new StdType(STD_OR, SUFFIX_LATCH));
+			returnType(internStdType(STD_OR, SUFFIX_LATCH));
 		case TOKEN_XOR:
-			returnType(new StdType(STD_XOR, SUFFIX_LATCH));
+			returnType(internStdType(STD_XOR, SUFFIX_LATCH));
 		case TOKEN_AND:
-			returnType(new StdType(STD_AND, SUFFIX_LATCH));
+			returnType(internStdType(STD_AND, SUFFIX_LATCH));
 		case TOKEN_DEQUALS:
-			returnType(new StdType(STD_DEQUALS, SUFFIX_LATCH));
+			returnType(internStdType(STD_DEQUALS, SUFFIX_LATCH));
 		case TOKEN_NEQUALS:
-			returnType(new StdType(STD_NEQUALS, SUFFIX_LATCH));
+			returnType(internStdType(STD_NEQUALS, SUFFIX_LATCH));
 		case TOKEN_LT:
-			returnType(new StdType(STD_LT, SUFFIX_LATCH));
+			returnType(internStdType(STD_LT, SUFFIX_LATCH));
 		case TOKEN_GT:
-			returnType(new StdType(STD_GT, SUFFIX_LATCH));
+			returnType(internStdType(STD_GT, SUFFIX_LATCH));
 		case TOKEN_LE:
-			returnType(new StdType(STD_LE, SUFFIX_LATCH));
+			returnType(internStdType(STD_LE, SUFFIX_LATCH));
 		case TOKEN_GE:
-			returnType(new StdType(STD_GE, SUFFIX_LATCH));
+			returnType(internStdType(STD_GE, SUFFIX_LATCH));
 		case TOKEN_LS:
-			returnType(new StdType(STD_LS, SUFFIX_LATCH));
+			returnType(internStdType(STD_LS, SUFFIX_LATCH));
 		case TOKEN_RS:
-			returnType(new StdType(STD_RS, SUFFIX_LATCH));
+			returnType(internStdType(STD_RS, SUFFIX_LATCH));
 		case TOKEN_TIMES:
-			returnType(new StdType(STD_TIMES, SUFFIX_LATCH));
+			returnType(internStdType(STD_TIMES, SUFFIX_LATCH));
 		case TOKEN_DIVIDE:
-			returnType(new StdType(STD_DIVIDE, SUFFIX_LATCH));
+			returnType(internStdType(STD_DIVIDE, SUFFIX_LATCH));
 		case TOKEN_MOD:
-			returnType(new StdType(STD_MOD, SUFFIX_LATCH));
+			returnType(internStdType(STD_MOD, SUFFIX_LATCH));
 		case TOKEN_PLUS:
-			returnType(new StdType(STD_PLUS, SUFFIX_LATCH));
+			returnType(internStdType(STD_PLUS, SUFFIX_LATCH));
 		case TOKEN_MINUS:
-			returnType(new StdType(STD_MINUS, SUFFIX_LATCH));
+			returnType(internStdType(STD_MINUS, SUFFIX_LATCH));
 	}
 	GET_STATUS_CODE;
 	GET_STATUS_FOOTER;
@@ -1308,13 +1902,13 @@ TypeStatus getStatusPrimLiteral(Tree *tree, const TypeStatus &inStatus) {
 	GET_STATUS_HEADER;
 	Tree *plc = tree->child;
 	if (*plc == TOKEN_INUM) {
-		returnType(new StdType(STD_INT, SUFFIX_LATCH));
+		returnType(internStdType(STD_INT, SUFFIX_LATCH));
 	} else if (*plc == TOKEN_FNUM) {
-		returnType(new StdType(STD_FLOAT, SUFFIX_LATCH));
+		returnType(internStdType(STD_FLOAT, SUFFIX_LATCH));
 	} else if (*plc == TOKEN_CQUOTE) {
-		returnType(new StdType(STD_CHAR, SUFFIX_LATCH));
+		returnType(internStdType(STD_CHAR, SUFFIX_LATCH));
 	} else if (*plc == TOKEN_SQUOTE) {
-		returnType(new StdType(STD_STRING, SUFFIX_LATCH));
+		returnType(internStdType(STD_STRING, SUFFIX_LATCH));
 	}
 	GET_STATUS_CODE;
 	GET_STATUS_FOOTER;
@@ -1343,7 +1937,7 @@ TypeStatus getStatusBlock(Tree *tree, const TypeStatus &inStatus) {
 	}
 	if (pipeTypesValid) { // if we managed to derive a type for all of the enclosed pipes, set the return status to be the appropriate filter type
 		if (curStatus.retType == NULL) { // if there were no returns in this block, set this block as returning the null type
-			curStatus.retType = nullType;
+			curStatus.retType = nullType();
 		}
 		returnType(new FilterType(inStatus, curStatus.retType, SUFFIX_LATCH));
 	}
@@ -1363,7 +1957,7 @@ TypeStatus getStatusFilterHeader(Tree *tree, const TypeStatus &inStatus) {
 		// advance to handle the possible RetList
 		treeCur = treeCur->next; // RetList or RSQUARE
 	} else {
-		from = TypeStatus(nullType, inStatus);
+		from = TypeStatus(nullType(), inStatus);
 	}
 	if (*treeCur == TOKEN_RetList) { // if this is a potentially implicity defined to-list
 		if (*(treeCur->child->next) != TOKEN_QUESTION) { // if this is an explicitly-defined to-list
@@ -1376,7 +1970,7 @@ TypeStatus getStatusFilterHeader(Tree *tree, const TypeStatus &inStatus) {
 		to = getStatusTypeList(treeCur->child->next, inStatus); // TypeList
 		failed = (failed || !(*to));
 	} else {
-		to = TypeStatus(nullType, inStatus);
+		to = TypeStatus(nullType(), inStatus);
 	}
 	if (!failed) { // if we succeeded in deriving both the from- and to- statuses
 		returnType(new FilterType(from.type, to.type, SUFFIX_LATCH));
@@ -1399,14 +1993,14 @@ TypeStatus verifyStatusFilter(Tree *tree) {
 		} else /* if (*(tree->child->next) == TOKEN_Block) */ { // else if this is an explicitly header-defined filter
 			block = tree->child->next; // Block
 			// nullify the type to feed into the block derivation, since we have an explicit parameter list
-			startStatus = nullType;
+			startStatus = nullType();
 		}
 		TypeStatus blockStatus = getStatusBlock(block, startStatus); // derive the definition Block's Type
 		if (*blockStatus) { // if we successfully verified the definition Block (meaning there were no internal return type inconsistencies)
 			if (headerType->to() == NULL) { // if the header's to-type was implicit, update it to be whatever the block returned
 				headerType->toInternal = ((FilterType *)(blockStatus.type))->to()->wrapTypeList();
 				returnTypeRet(headerType, NULL);
-			} else if ((*(((FilterType *)(blockStatus.type))->to()) == *nullType && *(headerType->to()) == *nullType) ||
+			} else if ((*(((FilterType *)(blockStatus.type))->to()) == *nullType() && *(headerType->to()) == *nullType()) ||
 					(*(((FilterType *)(blockStatus.type))->to()) >> *(headerType->to()))) { // if the header and Block return types are compatible
 				returnTypeRet(headerType, NULL);
 			} else { // else if the header and Block don't match
@@ -1426,7 +2020,7 @@ TypeStatus getStatusFilter(Tree *tree, const TypeStatus &inStatus) {
 	// derive the declared type of the filter
 	Tree *filterc = tree->child; // Block or FilterHeader
 	if (*filterc == TOKEN_Block) { // if it's an implicit block-defined filter, return its type as a consumer of the input type
-		returnTypeRet(new FilterType(inStatus.type, nullType, SUFFIX_LATCH), NULL);
+		returnTypeRet(new FilterType(inStatus.type, nullType(), SUFFIX_LATCH), NULL);
 	} else /* if (*filterc == TOKEN_FilterHeader) */ { // else if it's an explicit header-defined filter, return the filter header's definition site in the FilterType thunk
 		returnTypeRet(new FilterType(filterc, inStatus.type, SUFFIX_LATCH), NULL);
 	}
@@ -1440,9 +2034,9 @@ TypeStatus getStatusInstructor(Tree *tree, const TypeStatus &inStatus) {
 	GET_STATUS_HEADER;
 	Tree *icn = tree->child->next; // NULL, SEMICOLON, Block, or NonRetFilterHeader
 	if (icn == NULL || *icn == TOKEN_SEMICOLON || *icn == TOKEN_Block) {
-		returnTypeRet(new FilterType(nullType, nullType, SUFFIX_LATCH), NULL);
+		returnTypeRet(new FilterType(nullType(), nullType(), SUFFIX_LATCH), NULL);
 	} else /* if (*icn == TOKEN_NonRetFilterHeader) */ {
-		returnTypeRet(new FilterType(icn, nullType, SUFFIX_LATCH), NULL);
+		returnTypeRet(new FilterType(icn, nullType(), SUFFIX_LATCH), NULL);
 	}
 	GET_STATUS_CODE;
 	GET_STATUS_FOOTER;
@@ -1463,7 +2057,7 @@ TypeStatus verifyStatusInstructor(Tree *tree) {
 			block = NULL;
 		}
 		if (block != NULL) { // if there's actually an explicit definition block to verify
-			TypeStatus startStatus(nullType, errType); // set retType = errType to make sure that the instructor doesn't return anything
+			TypeStatus startStatus(nullType(), errType()); // set retType = errType to make sure that the instructor doesn't return anything
 			TypeStatus verifiedStatus = getStatusBlock(block, startStatus);
 			if (*verifiedStatus) { // if we successfully verified this instructor (meaning there were no internal return type inconsistencies)
 				returnTypeRet(headerType, NULL);
@@ -1479,7 +2073,7 @@ TypeStatus verifyStatusInstructor(Tree *tree) {
 // generates a thunk; does not actually generate any code
 TypeStatus getStatusOutstructor(Tree *tree, const TypeStatus &inStatus) {
 	GET_STATUS_HEADER;
-	returnTypeRet(new FilterType(tree->child->next, nullType, SUFFIX_LATCH), NULL); // RetFilterHeader
+	returnTypeRet(new FilterType(tree->child->next, nullType(), SUFFIX_LATCH), NULL); // RetFilterHeader
 	GET_STATUS_CODE;
 	GET_STATUS_FOOTER;
 }
@@ -1490,7 +2084,7 @@ TypeStatus verifyStatusOutstructor(Tree *tree) {
 	if (*(headerType->from())) { // if the header from-type evaluates to a valid type
 		Tree *block = tree->child->next->next; // NULL, RSQUARE, or Block
 		if (block != NULL && *block == TOKEN_Block) { // if there's an explicit block to verify for this Outstructor
-			TypeStatus startStatus(nullType, NULL); // set retType = NULL to allow the oustructor to return any type (for now) 
+			TypeStatus startStatus(nullType(), NULL); // set retType = NULL to allow the oustructor to return any type (for now) 
 			TypeStatus verifiedStatus = getStatusBlock(block, startStatus);
 			if (*verifiedStatus) { // if we successfully verified this outstructor (meaning there were no internal return type inconsistencies)
 				if (headerType->to() == NULL) { // if the header's to-type was implicit, update it to be whatever the block returned
@@ -1520,15 +2114,16 @@ TypeStatus getStatusObject(Tree *tree, const TypeStatus &inStatus) {
 	StructorList outstructorList;
 	MemberList memberList;
 	SymbolTree *objectSt = tree->env;
-	for (map<string, SymbolTree *>::const_iterator memberIter = objectSt->children.begin(); memberIter != objectSt->children.end(); memberIter++) {
-		if ((*memberIter).second->kind == KIND_INSTRUCTOR) { // if it's an instructor-style node
-			instructorList.add((*memberIter).second->defSite); // Instructor
-		} else if ((*memberIter).second->kind == KIND_OUTSTRUCTOR) { // else if it's an outstructor-style node
-			outstructorList.add((*memberIter).second->defSite); // Outstructor
-		} else if ((*memberIter).second->kind == KIND_DECLARATION) { // else if it's a declaration-style node
-			memberList.add((*memberIter).second->id, (*memberIter).second->defSite);
-		} else if ((*memberIter).second->kind == KIND_STD) { // else if it's an imported standard node
-			memberList.add((*memberIter).second->id, (*memberIter).second->defSite->status.type);
+	const vector<SymbolTree *> &memberSts = objectSt->children.sorted();
+	for (vector<SymbolTree *>::const_iterator memberIter = memberSts.begin(); memberIter != memberSts.end(); memberIter++) {
+		if ((*memberIter)->kind == KIND_INSTRUCTOR) { // if it's an instructor-style node
+			instructorList.add((*memberIter)->defSite); // Instructor
+		} else if ((*memberIter)->kind == KIND_OUTSTRUCTOR) { // else if it's an outstructor-style node
+			outstructorList.add((*memberIter)->defSite); // Outstructor
+		} else if ((*memberIter)->kind == KIND_DECLARATION) { // else if it's a declaration-style node
+			memberList.add((*memberIter)->id, (*memberIter)->defSite);
+		} else if ((*memberIter)->kind == KIND_STD) { // else if it's an imported standard node
+			memberList.add((*memberIter)->id, (*memberIter)->defSite->status.type);
 		}
 	}
 	// return a thunk representing this ObjectType
@@ -1546,6 +2141,15 @@ TypeStatus verifyStatusObject(Tree *tree) {
 	// making sure that there are no type conflicts in instructors and outstructors
 	// derive types for and verify all members
 	// verify all remaining raw pipes in this Object definition
+	if (semmerMode() == SEMMER_THREADED) { // copy-imported structors are verified by each Object that has them, so they might be verified concurrently; leave such Objects to the sequential semmer
+		const vector<SymbolTree *> &memberSts = tree->env->children.sorted();
+		for (vector<SymbolTree *>::const_iterator memberIter = memberSts.begin(); memberIter != memberSts.end(); memberIter++) {
+			if (((*memberIter)->kind == KIND_INSTRUCTOR || (*memberIter)->kind == KIND_OUTSTRUCTOR) && (*memberIter)->copyImportSite != NULL) {
+				__sync_lock_test_and_set(&compilerContext->semmerOutOfOrder, 1);
+				return TypeStatus(errType(), NULL);
+			}
+		}
+	}
 	ObjectType *objectType = (ObjectType *)(tree->status.type);
 	// derive types for all instructors and outstructors from their headers and validate that there were no errors in doing so
 	bool failed = !(objectType->instructorList.reify() && objectType->outstructorList.reify());
@@ -1658,7 +2262,7 @@ TypeStatus getStatusType(Tree *tree, const TypeStatus &inStatus) {
 			depthVal++;
 			// validate that this suffix expression is valid
 			TypeStatus expStatus = getStatusExp(exp, inStatus); // Exp
-			if (!(*expStatus >> *stdIntType)) { // if the expression is incompatible with an integer, flag a bad expression error
+			if (!(*expStatus >> *stdIntType())) { // if the expression is incompatible with an integer, flag a bad expression error
 				Token curToken = exp->t; // Exp
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"array subscript is invalid");
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (subscript type is "<<expStatus<<")");
@@ -1672,7 +2276,7 @@ TypeStatus getStatusType(Tree *tree, const TypeStatus &inStatus) {
 			depthVal++;
 			// validate that this suffix expression is valid
 			TypeStatus expStatus = getStatusExp(exp, inStatus); // Exp
-			if (!(*expStatus >> *stdIntType)) { // if the expression is incompatible with an integer, flag a bad expression error
+			if (!(*expStatus >> *stdIntType())) { // if the expression is incompatible with an integer, flag a bad expression error
 				Token curToken = exp->t; // Exp
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"pool subscript is invalid");
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (subscript type is "<<expStatus<<")");
@@ -1685,7 +2289,7 @@ TypeStatus getStatusType(Tree *tree, const TypeStatus &inStatus) {
 		if (*typec == TOKEN_NonArrayedIdentifier || *typec == TOKEN_ArrayedIdentifier) { // if it's an identifier-defined type
 			TypeStatus idStatus = getStatusIdentifier(typec, inStatus); // NonArrayedIdentifier
 			if (*idStatus) { // if we managed to derive a type for the instantiation identifier
-				if (idStatus.type != stdBoolLitType) { // if the type isn't defined by a standard literal
+				if (idStatus.type != stdBoolLitType()) { // if the type isn't defined by a standard literal
 					idStatus.type = idStatus.type->copy(); // make a copy of the identifier's type, so that the below mutation doesn't propagate to it
 					idStatus->suffix = suffixVal;
 					idStatus->depth = depthVal;
@@ -1697,8 +2301,8 @@ TypeStatus getStatusType(Tree *tree, const TypeStatus &inStatus) {
 				}
 			}
 		} else if (*typec == TOKEN_FilterType) { // else if it's an in-place-defined filter type
-			TypeStatus from = nullType;
-			TypeStatus to = nullType;
+			TypeStatus from = nullType();
+			TypeStatus to = nullType();
 			Tree *sub = typec->child->next; // TypeList or RetList
 			if (*sub == TOKEN_TypeList) { // if there is a from-list
 				from = getStatusTypeList(sub, inStatus); // TypeList
@@ -1777,7 +2381,7 @@ TypeStatus getStatusType(Tree *tree, const TypeStatus &inStatus) {
 						}
 					} else if (*cur == TOKEN_MemberType) { // else if it's a member type
 						// check for naming conflicts with this member
-						string &stringToAdd = cur->child->t.s; // ID
+						string stringToAdd = cur->child->t.s(); // ID
 						MemberList::iterator iter1;
 						vector<Token>::const_iterator iter2;
 						for (iter1 = memberList.begin(), iter2 = memberTokens.begin(); iter1 != memberList.end(); iter1++, iter2++) {
@@ -1852,7 +2456,7 @@ TypeStatus getStatusParamList(Tree *tree, const TypeStatus &inStatus) {
 					Token curToken = cur->t; // Param
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"parameterized non-instantiable node '"<<cur->child->child<<"'"); // NonArrayedIdentifier
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (parameter type is "<<paramStatus<<")");
-					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (parameter identifier is '"<<cur->child->next->t.s<<"')");
+					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (parameter identifier is '"<<cur->child->next->t.s()<<"')");
 					failed = true;
 				}
 			} else { // else if we failed to derive a type for this node
@@ -1863,30 +2467,30 @@ TypeStatus getStatusParamList(Tree *tree, const TypeStatus &inStatus) {
 				if (((TypeList *)(inStatus.type))->list.size() > list.size()) { // if the incoming type list is long enough to contain a type for this parameter, allow the derivation
 					list.push_back((((TypeList *)(inStatus.type))->list[list.size()])->copy());
 				} else { // else if the incoming type list is too short, flag an error
-					list.push_back(errType);
+					list.push_back(errType());
 					Token curToken = cur->t; // Param
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"auto-typed parameter in list with not enough incoming values"); // NonArrayedIdentifier
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (incoming type is "<<inStatus<<")");
-					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (parameter identifier is '"<<cur->child->next->t.s<<"')");
+					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (parameter identifier is '"<<cur->child->next->t.s()<<"')");
 					failed = true;
 				}
-			} else if (*inStatus != *nullType) { // else if there is a valid single non-null incoming type
+			} else if (*inStatus != *nullType()) { // else if there is a valid single non-null incoming type
 				if (list.size() == 0) { // if this is the first parameter in the list, allow the derivation
 					list.push_back(inStatus.type->copy());
 				} else { // else if this a subsequent parameter in the list, there are too many parameters
-					list.push_back(errType);
+					list.push_back(errType());
 					Token curToken = cur->t; // Param
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"auto-typed parameter in list with single incoming value"); // NonArrayedIdentifier
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (incoming type is "<<inStatus<<")");
-					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (parameter identifier is '"<<cur->child->next->t.s<<"')");
+					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (parameter identifier is '"<<cur->child->next->t.s()<<"')");
 					failed = true;
 				}
 			} else { // else if the incoming type is null, flag an error
-				list.push_back(errType);
+				list.push_back(errType());
 				Token curToken = cur->t; // Param
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"auto-typed parameter with no incoming value"); // NonArrayedIdentifier
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (incoming type is "<<inStatus<<")");
-				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (parameter identifier is '"<<cur->child->next->t.s<<"')");
+				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (parameter identifier is '"<<cur->child->next->t.s()<<"')");
 				failed = true;
 				failed = true;
 			}
@@ -2026,7 +2630,7 @@ TypeStatus getStatusInstantiation(Tree *tree, const TypeStatus &inStatus) {
 			Tree *identifier = (*(is->child) == TOKEN_NonArrayedIdentifier) ? is->child: is->child->next;// NonArrayedIdentifier or ArrayedIdentifier
 			semmerError(curToken.fileIndex,curToken.row,curToken.col,"instantiation of non-instantiable node '"<<identifier<<"'"); 
 			semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (node type is "<<instantiationStatus<<")");
-			returnTypeRet(errType, NULL);
+			returnTypeRet(errType(), NULL);
 		}
 		if ((is->next->next == NULL || *(is->next->next->child->next) == TOKEN_RBRACKET) && *(is->child) != TOKEN_RARROW) { // if we're doing default initialization
 			if (*is != TOKEN_BlankInstantiationSource && instantiationStatus.type->category == CATEGORY_OBJECTTYPE) { // if we're default-instantiating an object, ensure it's null-instantiable
@@ -2037,7 +2641,7 @@ TypeStatus getStatusInstantiation(Tree *tree, const TypeStatus &inStatus) {
 					Tree *identifier = (*(is->child) == TOKEN_NonArrayedIdentifier) ? is->child: is->child->next;// NonArrayedIdentifier or ArrayedIdentifier
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"null instantiation of non-null-instantiable node '"<<identifier<<"'"); 
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (node type is "<<instantiationStatus<<")");
-					returnTypeRet(errType, NULL);
+					returnTypeRet(errType(), NULL);
 				}
 			} else { // else if we're default instantiating a non-object, just return the type of the instantiation
 				returnStatus(instantiationStatus);
@@ -2155,7 +2759,7 @@ TypeStatus getStatusTypedStaticTerm(Tree *tree, const TypeStatus &inStatus) {
 			if (nodeStatus->referensible) { // if the node is referensible on its own
 				Tree *tstcc = tstc->child;
 				if ((*tstcc == TOKEN_NonArrayedIdentifier || *tstcc == TOKEN_ArrayedIdentifier) &&
-						!(nodeStatus->category == CATEGORY_FILTERTYPE && nodeStatus->suffix == SUFFIX_LATCH) && nodeStatus.type != stdBoolLitType) { // if the Node needs to be constantized
+						!(nodeStatus->category == CATEGORY_FILTERTYPE && nodeStatus->suffix == SUFFIX_LATCH) && nodeStatus.type != stdBoolLitType()) { // if the Node needs to be constantized
 					// first, copy the Type so that our mutations don't propagate to the StaticTerm
 					TypeStatus mutableNodeStatus = nodeStatus;
 					mutableNodeStatus.type = mutableNodeStatus.type->copy();
@@ -2195,7 +2799,7 @@ TypeStatus getStatusAccess(Tree *tree, const TypeStatus &inStatus) {
 			Token curToken = tree->child->child->t; // SLASH, SSLASH, ASLASH, DSLASH, DSSLASH, or DASLASH
 			semmerError(curToken.fileIndex,curToken.row,curToken.col,"access of immutable node '"<<tree->child->next->child<<"'"); // NonArrayedIdentifier or ArrayedIdentifier
 			semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (node type is "<<nodeStatus<<")");
-		} else if (nodeStatus.type == stdBoolLitType) { // else if it's an access of a standard literal, flag an error
+		} else if (nodeStatus.type == stdBoolLitType()) { // else if it's an access of a standard literal, flag an error
 			Token curToken = tree->child->child->t; // SLASH, SSLASH, ASLASH, DSLASH, DSSLASH, or DASLASH
 			semmerError(curToken.fileIndex,curToken.row,curToken.col,"access of immutable literal '"<<tree->child->next->child<<"'"); // NonArrayedIdentifier or ArrayedIdentifier
 		} else if (nodeStatus.type->category == CATEGORY_STDTYPE && !(((StdType *)(nodeStatus.type))->isComparable())) { // else if it's an access of an incomparable StdType, flag an error
@@ -2313,7 +2917,7 @@ TypeStatus getStatusDynamicTerm(Tree *tree, const TypeStatus &inStatus) {
 			SymbolTree *enclosingParent = enclosingEnv->parent;
 			if (enclosingParent->kind == KIND_FILTER) {
 				FilterType *enclosingType = (FilterType *)(enclosingParent->defSite->status.type);
-				if ((*inStatus == *nullType && *(enclosingType->from()) == *nullType) || (*inStatus >> *(enclosingType->from()))) {
+				if ((*inStatus == *nullType() && *(enclosingType->from()) == *nullType()) || (*inStatus >> *(enclosingType->from()))) {
 					if (enclosingType->to() == NULL) {
 						Token curToken = dtc->child->t; // LARROW
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"irresolvable implicit loopback return type");
@@ -2331,7 +2935,7 @@ TypeStatus getStatusDynamicTerm(Tree *tree, const TypeStatus &inStatus) {
 			} else if (enclosingParent->kind == KIND_INSTRUCTOR) {
 				TypeList *enclosingType = (TypeList *)(enclosingParent->defSite->status.type);
 				if (*inStatus >> *enclosingType) {
-					returnTypeRet(nullType, inStatus.retType);
+					returnTypeRet(nullType(), inStatus.retType);
 				} else {
 					Token curToken = dtc->child->t; // LARROW
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"loopback of unexpected type "<<inStatus);
@@ -2339,7 +2943,7 @@ TypeStatus getStatusDynamicTerm(Tree *tree, const TypeStatus &inStatus) {
 				}
 			} else if (enclosingParent->kind == KIND_OUTSTRUCTOR) {
 				TypeList *enclosingType = (TypeList *)(enclosingParent->defSite->status.type);
-				if (*inStatus == *nullType) {
+				if (*inStatus == *nullType()) {
 					if (enclosingType->list.size() == 1) {
 						returnTypeRet(enclosingType->list[0], inStatus.retType);
 					} else {
@@ -2358,10 +2962,10 @@ TypeStatus getStatusDynamicTerm(Tree *tree, const TypeStatus &inStatus) {
 	} else if (*dtc == TOKEN_Send) {
 		TypeStatus nodeStatus = getStatusNode(dtc->child->next, inStatus);
 		if (*nodeStatus) { // if we managed to derive a type for the send destination
-			if ((nodeStatus->referensible || nodeStatus.type == stringerType) &&
-					(nodeStatus.type != stdBoolLitType)) { // if the destination allows sends
+			if ((nodeStatus->referensible || nodeStatus.type == stringerType()) &&
+					(nodeStatus.type != stdBoolLitType())) { // if the destination allows sends
 				if (*inStatus >> *nodeStatus) { // if the Send is valid, proceed normally
-					returnType(nullType);
+					returnType(nullType());
 				} else { // else if the Send is invalid, flag an error
 					Token curToken = dtc->child->t; // RARROW
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"send to incompatible type");
@@ -2372,7 +2976,7 @@ TypeStatus getStatusDynamicTerm(Tree *tree, const TypeStatus &inStatus) {
 				Token curToken = dtc->child->t; // RARROW
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"send to immutable node '"<<dtc->child->next->child<<"'"); // NonArrayedIdentifier or ArrayedIdentifier
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (node type is "<<nodeStatus<<")");
-			} else /* if (nodeStatus.type == stdBoolLitType) */ { // else if it's an access of a standard literal, flag an error
+			} else /* if (nodeStatus.type == stdBoolLitType()) */ { // else if it's an access of a standard literal, flag an error
 				Token curToken = dtc->child->t; // RARROW
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"send to immutable literal '"<<dtc->child->next->child<<"'"); // NonArrayedIdentifier or ArrayedIdentifier
 			}
@@ -2380,8 +2984,8 @@ TypeStatus getStatusDynamicTerm(Tree *tree, const TypeStatus &inStatus) {
 	} else if (*dtc == TOKEN_Swap) {
 		TypeStatus nodeStatus = getStatusNode(dtc->child->next, inStatus);
 		if (*nodeStatus) { // if we managed to derive a type for the swap destination
-			if ((nodeStatus->referensible || nodeStatus.type == stringerType) &&
-					(nodeStatus.type != stdBoolLitType)) { // if the destination allows swaps
+			if ((nodeStatus->referensible || nodeStatus.type == stringerType()) &&
+					(nodeStatus.type != stdBoolLitType())) { // if the destination allows swaps
 				if (*inStatus >> *nodeStatus) { // if the Swap is valid, proceed normally
 					returnType(nodeStatus.type);
 				} else { // else if the Send is invalid, flag an error
@@ -2394,7 +2998,7 @@ TypeStatus getStatusDynamicTerm(Tree *tree, const TypeStatus &inStatus) {
 				Token curToken = dtc->child->t; // LRARROW
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"swap with immutable node '"<<dtc->child->next->child<<"'"); // NonArrayedIdentifier or ArrayedIdentifier
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (node type is "<<nodeStatus<<")");
-			} else /* if (nodeStatus.type == stdBoolLitType) */ { // else if it's an access of a standard literal, flag an error
+			} else /* if (nodeStatus.type == stdBoolLitType()) */ { // else if it's an access of a standard literal, flag an error
 				Token curToken = dtc->child->t; // LRARROW
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"swap with immutable literal '"<<dtc->child->next->child<<"'"); // NonArrayedIdentifier or ArrayedIdentifier
 			}
@@ -2405,22 +3009,22 @@ TypeStatus getStatusDynamicTerm(Tree *tree, const TypeStatus &inStatus) {
 		if (knownRetType != NULL) { // if there's already a return type logged, make sure it's compatible with this one
 			// try a back-cast from the current return type to the known one
 			if (*thisRetType >> *knownRetType) { // if the cast succeeded, use the known return type
-				returnTypeRet(nullType, knownRetType);
+				returnTypeRet(nullType(), knownRetType);
 			}
 			// try a forward-cast from the known return type to the current one
 			if (*thisRetType >> *knownRetType) { // if the cast succeeded, use the new return type
-				returnTypeRet(nullType, thisRetType);
+				returnTypeRet(nullType(), thisRetType);
 			} else { // else if this return type conflicts with the known one, flag an error
 				Token curToken = dtc->child->t; // DRARROW
 				semmerError(curToken.fileIndex,curToken.row,curToken.col,"return of unexpected type "<<thisRetType);
-				if (*knownRetType == *errType) {
+				if (*knownRetType == *errType()) {
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (not expecting a return here)");
 				} else {
 					semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (expected type is "<<knownRetType<<")");
 				}
 			}
 		} else { // else if there is no return type logged, log this one and proceed normally
-			returnTypeRet(nullType, thisRetType);
+			returnTypeRet(nullType(), thisRetType);
 		}
 	}
 	GET_STATUS_CODE;
@@ -2491,7 +3095,7 @@ TypeStatus getStatusSimpleTerm(Tree *tree, const TypeStatus &inStatus) {
 TypeStatus getStatusSimpleCondTerm(Tree *tree, const TypeStatus &inStatus) {
 	GET_STATUS_HEADER;
 	if (*inStatus == STD_BOOL) { // if what's coming in is a boolean
-		returnStatus(getStatusTerm(tree->child->next, TypeStatus(nullType, NULL)));
+		returnStatus(getStatusTerm(tree->child->next, TypeStatus(nullType(), NULL)));
 	} else { // else if what's coming in isn't a boolean
 		Token curToken = tree->child->t; // QUESTION
 		semmerError(curToken.fileIndex,curToken.row,curToken.col,"non-boolean input to conditional");
@@ -2509,17 +3113,17 @@ TypeStatus getStatusOpenOrClosedCondTerm(Tree *tree, const TypeStatus &inStatus)
 		Tree *falseBranchc = tree->child->next->next->next->child; // SimpleTerm, ClosedCondTerm, SimpleCondTerm, or ClosedCondTerm
 		TypeStatus trueStatus;
 		if (*trueBranchc == TOKEN_SimpleTerm) {
-			trueStatus = getStatusSimpleTerm(trueBranchc, TypeStatus(nullType, NULL));
+			trueStatus = getStatusSimpleTerm(trueBranchc, TypeStatus(nullType(), NULL));
 		} else /* if (*trueBranchc == TOKEN_ClosedCondTerm) */ {
-			trueStatus = getStatusOpenOrClosedCondTerm(trueBranchc, TypeStatus(nullType, NULL));
+			trueStatus = getStatusOpenOrClosedCondTerm(trueBranchc, TypeStatus(nullType(), NULL));
 		}
 		TypeStatus falseStatus;
 		if (*falseBranchc == TOKEN_SimpleTerm) {
-			falseStatus = getStatusSimpleTerm(falseBranchc, TypeStatus(nullType, NULL));
+			falseStatus = getStatusSimpleTerm(falseBranchc, TypeStatus(nullType(), NULL));
 		} else if (*falseBranchc == TOKEN_SimpleCondTerm) {
-			falseStatus = getStatusSimpleCondTerm(falseBranchc, TypeStatus(nullType, NULL));
+			falseStatus = getStatusSimpleCondTerm(falseBranchc, TypeStatus(nullType(), NULL));
 		} else /* if (*falseBranchc == TOKEN_ClosedCondTerm || *falseBranchc == TOKEN_OpenCondTerm) */ {
-			falseStatus = getStatusOpenOrClosedCondTerm(falseBranchc, TypeStatus(nullType, NULL));
+			falseStatus = getStatusOpenOrClosedCondTerm(falseBranchc, TypeStatus(nullType(), NULL));
 		}
 		if (*trueStatus && *falseStatus) { // if we managed to derive types for both branches
 			if (*trueStatus == *falseStatus) { // if the two branches match in type
@@ -2576,7 +3180,7 @@ TypeStatus getStatusNonEmptyTerms(Tree *tree, const TypeStatus &inStatus) {
 					*(curTerm->child->child->child) == TOKEN_StaticTerm &&
 					*(curTerm->child->child->child->child->child) == TOKEN_Node &&
 					*(curTerm->child->child->child->child->child->child) != TOKEN_Instantiation) { // if it's a flow-through Term
-				pair<Type *, bool> stdFlowResult(errType, false);
+				pair<Type *, bool> stdFlowResult(errType(), false);
 				if (nextTermStatus->category == CATEGORY_STDTYPE) { // if this Term's type is a STDTYPE, try to derive a three-term exceptional type for it
 					stdFlowResult = ((StdType *)(nextTermStatus.type))->stdFlowDerivation(curStatus, curTerm->next->child);
 				}
@@ -2585,8 +3189,8 @@ TypeStatus getStatusNonEmptyTerms(Tree *tree, const TypeStatus &inStatus) {
 					if (stdFlowResult.second) { // if we used a third term for the derivation, advance curTerm past it
 						curTerm = curTerm->next->child;
 					}
-				} else if (*curStatus == *nullType &&
-						nextTermStatus.type->category == CATEGORY_FILTERTYPE && *(((FilterType *)(nextTermStatus.type))->from()) == *nullType) { // else if this is a generator invocation
+				} else if (*curStatus == *nullType() &&
+						nextTermStatus.type->category == CATEGORY_FILTERTYPE && *(((FilterType *)(nextTermStatus.type))->from()) == *nullType()) { // else if this is a generator invocation
 					// use the generator's result type as the current status
 					curStatus = TypeStatus(((FilterType *)(nextTermStatus.type))->to(), nextTermStatus);
 				} else { // else if this is not a recognized exceptional case
@@ -2599,11 +3203,11 @@ TypeStatus getStatusNonEmptyTerms(Tree *tree, const TypeStatus &inStatus) {
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (term's type is "<<nextTermStatus<<")");
 						semmerError(prevToken.fileIndex,prevToken.row,prevToken.col,"-- (incoming type is "<<curStatus<<")");
 						// short-circuit the derivation of this NonEmptyTerms
-						curStatus = errType;
+						curStatus = errType();
 						break;
 					} else if (*flowResult) { // else if the type flow is valid, log it as the current status
 						curStatus = TypeStatus(flowResult, nextTermStatus);
-					} else if (*curStatus == *nullType) { // else if the flow is not valid, but the incoming type is null, treat it as a value injection
+					} else if (*curStatus == *nullType()) { // else if the flow is not valid, but the incoming type is null, treat it as a value injection
 						curStatus = nextTermStatus;
 					} else { // else if the type flow is not valid and the incoming type is not null, flag an error
 						Token curToken = curTerm->t; // Term
@@ -2612,7 +3216,7 @@ TypeStatus getStatusNonEmptyTerms(Tree *tree, const TypeStatus &inStatus) {
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (term's type is "<<nextTermStatus<<")");
 						semmerError(prevToken.fileIndex,prevToken.row,prevToken.col,"-- (incoming type is "<<curStatus<<")");
 						// short-circuit the derivation of this NonEmptyTerms
-						curStatus = errType;
+						curStatus = errType();
 						break;
 					}
 				}
@@ -2624,7 +3228,7 @@ TypeStatus getStatusNonEmptyTerms(Tree *tree, const TypeStatus &inStatus) {
 			semmerError(curToken.fileIndex,curToken.row,curToken.col,"cannot resolve term's output type");
 			semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (input type is "<<curStatus<<")");
 			// short-circuit the derivation for this NonEmptyTerms
-			curStatus = errType;
+			curStatus = errType();
 			break;
 		}
 	}
@@ -2638,15 +3242,16 @@ TypeStatus getStatusNonEmptyTerms(Tree *tree, const TypeStatus &inStatus) {
 
 // reports errors
 TypeStatus getStatusDeclaration(Tree *tree) {
-	GET_STATUS_HEADER;
+	checkDeclarationReentry(tree);
+	GET_STATUS_CONTEXT_HEADER(false);
 	// check if this is a recursive invocation
 	Type *&fakeRetType = tree->status.retType;
 	if (fakeRetType != NULL) { // if we previously logged a recursion alert here (and we don't have a memoized type to return), flag an ill-formed recursion error
 		Token curToken = tree->child->t;
-		semmerError(curToken.fileIndex,curToken.row,curToken.col,"irresolvable recursive definition of '"<<curToken.s<<"'");
+		semmerError(curToken.fileIndex,curToken.row,curToken.col,"irresolvable recursive definition of '"<<curToken.s()<<"'");
 	} else { // else if there is no recursion alert for this Declaration
 		// flag a recursion alert for this Declaration and proceed normally
-		fakeRetType = errType;
+		fakeRetType = errType();
 		// check if this is a Filter or Object derivation special case
 		Tree *declarationSub = tree->child->next->next; // TypedStaticTerm, NonEmptyTerms, or NULL
 		if (declarationSub != NULL && *declarationSub == TOKEN_TypedStaticTerm && *(declarationSub->child) == TOKEN_Node) {
@@ -2660,7 +3265,7 @@ TypeStatus getStatusDeclaration(Tree *tree) {
 				if (*verifiedStatus) { // if the verification was successful, return the derived status
 					returnTypeRet(verifiedStatus, NULL);
 				} else { // else if the verification failed
-					returnTypeRet(errType, NULL);
+					returnTypeRet(errType(), NULL);
 				}
 			} else if (*(declarationSub->child->child) == TOKEN_Object) {
 				TypeStatus derivedStatus = getStatusObject(declarationSub->child->child); // blindly generates a thunk; never fails
@@ -2672,7 +3277,7 @@ TypeStatus getStatusDeclaration(Tree *tree) {
 				if (*verifiedStatus) { // if the verification was successful, return the derived status
 					returnTypeRet(verifiedStatus, NULL);
 				} else { // else if the verification failed
-					returnTypeRet(errType, NULL);
+					returnTypeRet(errType(), NULL);
 				}
 			}
 		}
@@ -2686,7 +3291,7 @@ TypeStatus getStatusDeclaration(Tree *tree) {
 						returnTypeRet(derivedStatus, NULL);
 					} else { // else if the derived type is a TypeList, flag an error
 						Token curToken = tree->t; // Declaration
-						semmerError(curToken.fileIndex,curToken.row,curToken.col,"declaration of compound-typed identifier '"<<tree->child->t.s<<"'");
+						semmerError(curToken.fileIndex,curToken.row,curToken.col,"declaration of compound-typed identifier '"<<tree->child->t.s()<<"'");
 						semmerError(curToken.fileIndex,curToken.row,curToken.col,"-- (identifier type is "<<derivedStatus<<")");
 					}
 				}
@@ -2694,13 +3299,32 @@ TypeStatus getStatusDeclaration(Tree *tree) {
 				returnTypeRet(getStatusInstantiation(declarationSub), NULL);
 			}
 		} else { // otherwise, if it's an import declaration, do nothing; typing of the import will be handled at the definition site
-			returnTypeRet(nullType, NULL);
+			returnTypeRet(nullType(), NULL);
 		}
 	}
 	GET_STATUS_CODE;
 	GET_STATUS_FOOTER;
 }
 
+// derives the body of a Declaration whose status was seeded from an interface summary, the way that getStatusDeclaration() would have, so that its intermediate code gets generated
+void lowerSeededDeclaration(Tree *tree) {
+	Tree *declarationSub = tree->child->next->next; // TypedStaticTerm, NonEmptyTerms, or NULL
+	if (*(tree->child) == TOKEN_AT || declarationSub == NULL) { // import declarations are lowered at their definition sites
+		return;
+	}
+	if (*declarationSub == TOKEN_TypedStaticTerm && *(declarationSub->child) == TOKEN_Node && *(declarationSub->child->child) == TOKEN_Filter) {
+		getStatusFilter(declarationSub->child->child);
+		verifyStatusFilter(declarationSub->child->child);
+	} else if (*declarationSub == TOKEN_TypedStaticTerm && *(declarationSub->child) == TOKEN_Node && *(declarationSub->child->child) == TOKEN_Object) {
+		getStatusObject(declarationSub->child->child);
+		verifyStatusObject(declarationSub->child->child);
+	} else if (*declarationSub == TOKEN_TypedStaticTerm) {
+		getStatusTypedStaticTerm(declarationSub);
+	} else if (*declarationSub == TOKEN_BlankInstantiation) {
+		getStatusInstantiation(declarationSub);
+	}
+}
+
 TypeStatus getStatusPipe(Tree *tree, const TypeStatus &inStatus) {
 	GET_STATUS_HEADER;
 	Tree *pipec = tree->child; // Declaration or NonEmptyTerms
@@ -2719,7 +3343,7 @@ TypeStatus getStatusPipe(Tree *tree, const TypeStatus &inStatus) {
 }
 
 void semPipes(Tree *treeRoot) {
-	TypeStatus rootStatus(nullType, stdIntType);
+	TypeStatus rootStatus(nullType(), stdIntType());
 	for (Tree *programCur = treeRoot; programCur != NULL; programCur = programCur->next) {
 		for (Tree *pipeCur = programCur->child->child; pipeCur != NULL; pipeCur = (pipeCur->next != NULL) ? pipeCur->next->child : NULL) {
 			getStatusPipe(pipeCur, rootStatus);
@@ -2727,6 +3351,174 @@ void semPipes(Tree *treeRoot) {
 	}
 }
 
+// parallel semantic analysis
+
+void *runSemmerWorker(void *arg) {
+	SemmerPool *pool = (SemmerPool *)arg;
+	compilerContext = pool->context;
+	semmerWorkerId = __sync_add_and_fetch(&(pool->nextWorkerId), 1);
+	BindingCache localBindingCache;
+	workerBindingCache = &localBindingCache;
+	TypeRelationCache localTypeRelationCache;
+	workerTypeRelationCache = &localTypeRelationCache;
+	unsigned int numQueues = pool->queues.size();
+	while (!__sync_fetch_and_or(&compilerContext->semmerOutOfOrder, 0)) { // run our own tasks, then steal the other workers' until there are none left (or the phase has to be redone anyway)
+		unsigned int task;
+		bool found = pool->queues[(semmerWorkerId-1) % numQueues]->pop(task);
+		for (unsigned int i=1; i < numQueues && !found; i++) {
+			found = pool->queues[(semmerWorkerId-1+i) % numQueues]->steal(task);
+		}
+		if (!found) {
+			break;
+		}
+		semmerTask = compilerContext->semmerTaskBase + task + 1;
+		pthread_mutex_lock(&compilerContext->statusClaimLock);
+		compilerContext->semmerWorkerTasks[semmerWorkerId] = semmerTask;
+		pthread_mutex_unlock(&compilerContext->statusClaimLock);
+		pool->work(task);
+	}
+	workerBindingCache = NULL;
+	workerTypeRelationCache = NULL;
+	semmerTask = 0;
+	semmerWorkerId = 0;
+	return NULL;
+}
+
+// runs work on all of the tasks using numWorkers threads (including the calling one), with the typing functions in threaded mode
+void runSemmerPool(unsigned int numTasks, void (*work)(unsigned int task), unsigned int numWorkers) {
+	SemmerPool pool(numTasks, numWorkers, work);
+	compilerContext->statusClaimWaits.assign(numWorkers+1, NULL);
+	compilerContext->semmerWorkerTasks.assign(numWorkers+1, 0);
+	semmerMode() = SEMMER_THREADED;
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, SEMMER_WORKER_STACK_SIZE); // typing recurses deeply
+	vector<pthread_t> workers;
+	for (unsigned int i=1; i<numWorkers; i++) {
+		pthread_t worker;
+		if (pthread_create(&worker, &attr, runSemmerWorker, &pool) == 0) { // if we managed to spawn the worker, log it (otherwise, the remaining workers steal its tasks)
+			workers.push_back(worker);
+		}
+	}
+	pthread_attr_destroy(&attr);
+	runSemmerWorker(&pool);
+	for (unsigned int i=0; i<workers.size(); i++) {
+		pthread_join(workers[i], NULL);
+	}
+	semmerMode() = SEMMER_SEQUENTIAL;
+	compilerContext->semmerTaskBase += numTasks;
+	// now that there are no more readers, free the scope arrays that were replaced while the workers were running
+	for (unsigned int i=0; i<compilerContext->retiredScopeKeys.size(); i++) {
+		delete[] compilerContext->retiredScopeKeys[i];
+		delete[] compilerContext->retiredScopeValues[i];
+	}
+	compilerContext->retiredScopeKeys.clear();
+	compilerContext->retiredScopeValues.clear();
+}
+
+// logs the distinct non-inlined nodes of the SymbolTree as tasks, in semSt() order
+// note: instructors and outstructors are left to the derivation of their Object, which verifies them in place (rewriting their statuses), so no other task may be reading them meanwhile
+void getSemStTasks(SymbolTree *root, SymbolTree *parent, set<SymbolTree *> &visited) {
+	if (!(visited.insert(root).second)) { // if we've already been here, there's nothing new below
+		return;
+	}
+	if (root->kind == KIND_DECLARATION) {
+		compilerContext->semStTasks.push_back(make_pair(root, parent));
+	}
+	const vector<SymbolTree *> &childList = root->children.sorted();
+	for (unsigned int i=0; i < childList.size(); i++) {
+		getSemStTasks(childList[i], root, visited);
+	}
+}
+
+void semStTask(unsigned int task) {
+	getStatusSymbolTree(compilerContext->semStTasks[task].first, compilerContext->semStTasks[task].second);
+}
+
+void semPipesTask(unsigned int task) {
+	TypeStatus rootStatus(nullType(), stdIntType());
+	getStatusPipe(compilerContext->semPipesTasks[task], rootStatus);
+}
+
+// forgets all of the statuses that the threaded semmer derived below the given tree (and the fake nodes attached while deriving them), so that typing can be redone sequentially
+// note: nodes that were derived before typing went parallel (while resolving imports, or from interface summaries) were published under task 0, so they keep their statuses and errors
+void resetStatus(Tree *treeRoot) {
+	vector<Tree *> stack; // explicit stack, as in lower()
+	if (treeRoot != NULL) {
+		stack.push_back(treeRoot);
+	}
+	while (!stack.empty()) {
+		Tree *cur = stack.back();
+		stack.pop_back();
+		if (cur->claim & CLAIM_TASK) {
+			cur->status = TypeStatus();
+			cur->log = NULL; // the compilation still owns the log (see statusLogs)
+		}
+		cur->claim = CLAIM_FREE;
+		for (Ast *ast = cur->ast; ast != NULL; ast = (ast->kind == AST_DELATCH) ? ast->left : NULL) { // the identifier under a DELATCH is the only Ast node that no Tree node owns
+			if (ast->claim & CLAIM_TASK) {
+				ast->status = TypeStatus();
+				ast->log = NULL;
+			}
+			ast->claim = CLAIM_FREE;
+		}
+		if (cur->next != NULL) {
+			stack.push_back(cur->next);
+		}
+		if (cur->child != NULL) {
+			stack.push_back(cur->child);
+		}
+	}
+	for (unsigned int i=0; i<compilerContext->parallelFakeNodes.size(); i++) {
+		compilerContext->parallelFakeNodes[i].first->children.erase(compilerContext->parallelFakeNodes[i].second->atom);
+	}
+	compilerContext->parallelFakeNodes.clear();
+}
+
+// derives the same statuses as semSt() and then semPipes(), but on numWorkers threads; any errors are then reported in the order that they would have reported them
+// returns false (having undone all of the typing) if a derivation might have come out differently than it would have sequentially, in which case typing has to be redone sequentially
+// (this happens when a recursive definition, or a node whose status depends on its caller, is first reached by a later task than it would have been sequentially)
+bool semParallel(Tree *treeRoot, SymbolTree *stRoot, unsigned int numWorkers) {
+	compilerContext->semmerTaskBase = 0;
+	compilerContext->semmerOutOfOrder = 0;
+	compilerContext->semmerErrorsLogged = 0;
+	// derive the SymbolTree's statuses, one task per node that semSt() would derive
+	startPhase(PHASE_SEM_ST);
+	set<SymbolTree *> visited;
+	getSemStTasks(stRoot, NULL, visited);
+	runSemmerPool(compilerContext->semStTasks.size(), semStTask, numWorkers);
+	compilerContext->semStTasks.clear();
+	endPhase(PHASE_SEM_ST);
+	// derive the pipes' statuses, one task per pipe
+	startPhase(PHASE_SEM_PIPES);
+	if (!compilerContext->semmerOutOfOrder) {
+		for (Tree *programCur = treeRoot; programCur != NULL; programCur = programCur->next) {
+			for (Tree *pipeCur = programCur->child->child; pipeCur != NULL; pipeCur = (pipeCur->next != NULL) ? pipeCur->next->child : NULL) {
+				compilerContext->semPipesTasks.push_back(pipeCur);
+			}
+		}
+		runSemmerPool(compilerContext->semPipesTasks.size(), semPipesTask, numWorkers);
+		compilerContext->semPipesTasks.clear();
+	}
+	endPhase(PHASE_SEM_PIPES);
+	if (compilerContext->semmerOutOfOrder) { // if the results can't be trusted, undo them
+		resetStatus(treeRoot);
+		return false;
+	}
+	compilerContext->parallelFakeNodes.clear();
+	if (compilerContext->semmerErrorsLogged) { // if there were errors, re-walk the SymbolTree and pipes, replaying each node's errors where semSt() and semPipes() would have derived it
+		semmerMode() = SEMMER_REPLAY;
+		startPhase(PHASE_SEM_ST);
+		semSt(stRoot);
+		endPhase(PHASE_SEM_ST);
+		startPhase(PHASE_SEM_PIPES);
+		semPipes(treeRoot);
+		endPhase(PHASE_SEM_PIPES);
+		semmerMode() = SEMMER_SEQUENTIAL;
+	}
+	return true;
+}
+
 // creates the top-level SchedTree containing all of the LabelTrees that should be initially scheduled
 SchedTree *genCodeRoot(Tree *treeRoot) {
 	// build the list of labels that should be initially scheduled
@@ -2744,36 +3536,74 @@ SchedTree *genCodeRoot(Tree *treeRoot) {
 int sem(Tree *treeRoot, SymbolTree *&stRoot, SchedTree *&codeRoot) {
 
 	// initialize local error code
-	semmerErrorCode = 0;
+	semmerErrorCode() = 0;
 
 	VERBOSE( printNotice("building symbol tree..."); )
 
-	// initialize the standard types and nodes
-	initSemmerGlobals();
+	startPhase(PHASE_BUILD_ST);
+
+	// initialize the standard types and nodes, unless they were built ahead of time
+	SymbolTree *defaultDefs = compilerContext->warmDefaultDefs;
+	compilerContext->warmDefaultDefs = NULL;
+	if (defaultDefs == NULL) {
+		initSemmerGlobals();
+	}
+	compilerContext->bindingCache->clear();
+	resetTypeCaches();
 	
 	// build the symbol tree
-	stRoot = genDefaultDefs(); // initialize the symbol tree root with the default definitions
+	stRoot = (defaultDefs != NULL) ? defaultDefs : genDefaultDefs(); // initialize the symbol tree root with the default definitions
 	vector<SymbolTree *> importList; // list of import Declaration nodes; will be populated in the next step
 	buildSt(treeRoot, stRoot, importList); // get user definitions and populate the import list
+	endPhase(PHASE_BUILD_ST);
+	startPhase(PHASE_SUB_IMPORT_DECLS);
 	subImportDecls(importList); // resolve and substitute import declarations into the symbol tree
+	// seed the statuses of the files whose interface summaries still apply, so that they're bound against instead of being re-derived
+	// (verbose mode traces every derivation, so it doesn't use them)
+	vector<pair<Tree *, TypeStatus> > interfaceSeeds;
+	vector<bool> interfaceLoaded;
+	if (cacheDir() != NULL && !verboseOutput()) {
+		loadInterfaces(treeRoot, stRoot, interfaceSeeds, interfaceLoaded);
+	}
+	endPhase(PHASE_SUB_IMPORT_DECLS);
 
 	VERBOSE( printNotice("tracing data flow..."); )
 
-	// perform semantic analysis (derivation of Type trees and offsets) on the entire SymbolTree
-	semSt(stRoot);
-	// perform semantic analysis (derivation of Type and IR trees) on the remaining pipes
-	semPipes(treeRoot);
+	// verbose mode traces the derivations as they happen, so it always types on a single thread
+	unsigned int numWorkers = verboseOutput() ? 1 : (unsigned int)numJobs();
+
+	compilerContext->declarationReentered = false;
+	if (numWorkers <= 1 || !semParallel(treeRoot, stRoot, numWorkers)) { // if we're typing sequentially (or parallel typing has to be redone that way)
+		// perform semantic analysis (derivation of Type trees and offsets) on the entire SymbolTree
+		startPhase(PHASE_SEM_ST);
+		semSt(stRoot);
+		endPhase(PHASE_SEM_ST);
+		// perform semantic analysis (derivation of Type and IR trees) on the remaining pipes
+		startPhase(PHASE_SEM_PIPES);
+		semPipes(treeRoot);
+		endPhase(PHASE_SEM_PIPES);
+	}
+	// the summaries only stand in for the seeded declarations' types, so lower their bodies to intermediate code as well
+	startPhase(PHASE_SEM_ST);
+	for (unsigned int i=0; i<interfaceSeeds.size(); i++) {
+		if (*(interfaceSeeds[i].first) == TOKEN_Declaration) {
+			lowerSeededDeclaration(interfaceSeeds[i].first);
+		}
+	}
+	endPhase(PHASE_SEM_ST);
 	
 	// build the root-level IRTree node at which assembly dumping will start
+	startPhase(PHASE_GEN_CODE_ROOT);
 	codeRoot = genCodeRoot(treeRoot);
-	
-	VERBOSE( cout << stRoot; )
+	endPhase(PHASE_GEN_CODE_ROOT);
 
-	// if there were no errors, delete the error type node
-	if (!semmerErrorCode) {
-		delete errType;
+	// summarize the files that didn't have interface summaries yet, as long as their derivations can be trusted to come out the same in other compilations
+	if (cacheDir() != NULL && !semmerErrorCode() && !compilerContext->declarationReentered) {
+		storeInterfaces(treeRoot, stRoot, interfaceLoaded);
 	}
+	
+	VERBOSE( outStream() << stRoot; )
 
 	// finally, return to the caller
-	return semmerErrorCode ? 1 : 0;
+	return semmerErrorCode() ? 1 : 0;
 }
@@ -3,10 +3,13 @@
 
 #include "globalDefs.h"
 #include "constantDefs.h"
+#include "context.h"
 #include "driver.h"
 
+#include "atoms.h"
 #include "lexer.h"
 #include "parser.h"
+#include "ast.h"
 #include "types.h"
 #include "genner.h"
 
@@ -24,15 +27,48 @@
 #define KIND_INSTANTIATION 11
 #define KIND_FAKE 12
 
+// a SymbolTree node's children, keyed by id atom; an open-addressing hash table with linear probing
+// note: keys are never NULL_ATOM (node ids are never empty), so NULL_ATOM marks an empty slot
+// note: during parallel typing, lookups are lock-free and writes (of fake nodes only) go through attachFakeNode()
+class SymbolScope {
+	public:
+		// data members
+		Atom *keys;
+		SymbolTree **values;
+		unsigned int capacity; // the number of slots; always zero or a power of two
+		unsigned int count; // the number of occupied slots
+		mutable vector<SymbolTree *> order; // cached values in key text order; rebuilt in place when stale
+		mutable bool orderValid;
+		// allocators/deallocators
+		SymbolScope();
+		SymbolScope(const SymbolScope &other);
+		~SymbolScope();
+		// accessors
+		unsigned int size() const;
+		SymbolTree *find(Atom key) const; // returns NULL if there's no such key
+		const vector<SymbolTree *> &sorted() const; // the values in the order of their keys' text, for deterministic traversal
+		// core methods
+		bool insert(Atom key, SymbolTree *value); // does nothing (and returns false) if the key is already present
+		void erase(Atom key);
+		// operators
+		SymbolScope &operator=(const SymbolScope &other);
+	private:
+		static unsigned int slot(Atom key, unsigned int capacity);
+		OPTIMISTIC_READER SymbolTree *probe(Atom key) const;
+		void sortInternal() const;
+		void grow();
+};
+
 class SymbolTree {
 	public:
 		// data members
 		int kind; // node kind
 		string id; // string representation of this node used for binding
+		Atom atom; // the interned id; the key of this node in its parent's children
 		Tree *defSite; // where the symbol is defined in the Tree (Declaration or Param)
 		SymbolTree *copyImportSite; // if this node is a copy-import, the node from which we're importing; NULL otherwise
 		SymbolTree *parent; // pointer ot the parent of this node; populated during SymbolTree status derivation
-		map<string, SymbolTree *> children; // list of this node's children
+		SymbolScope children; // list of this node's children
 		int offsetKindInternal; // the kind of child this node apprears as to its lexical parent
 		unsigned int offsetIndexInternal; // the offset of this child in the lexical parent's offset kind
 		unsigned int numRaws; // the number of raw-represented children for this node
@@ -42,10 +78,14 @@ class SymbolTree {
 		// allocators/deallocators
 		SymbolTree(int kind, const string &id, Tree *defSite = NULL, SymbolTree *copyImportSite = NULL);
 		SymbolTree(int kind, const char *id, Tree *defSite = NULL, SymbolTree *copyImportSite = NULL);
+		SymbolTree(int kind, Atom id, Tree *defSite = NULL, SymbolTree *copyImportSite = NULL);
 		SymbolTree(int kind, const string &id, Type *defType, SymbolTree *copyImportSite = NULL);
 		SymbolTree(int kind, const char *id, Type *defType, SymbolTree *copyImportSite = NULL);
+		SymbolTree(int kind, Atom id, Type *defType, SymbolTree *copyImportSite = NULL);
 		SymbolTree(const SymbolTree &st, SymbolTree *parent, SymbolTree *copyImportSite = NULL);
 		~SymbolTree();
+		static void *operator new(size_t size); // SymbolTrees belong to the compilation that allocated them (see allocNode())
+		static void operator delete(void *ptr);
 		// core methods
 		unsigned int addRaw();
 		unsigned int addBlock();
@@ -62,59 +102,206 @@ class SymbolTree {
 		operator string();
 };
 
+// a memoized successful bindId() result
+class BindingCacheEntry {
+	public:
+		// data members
+		unsigned int hash;
+		SymbolTree *env; // the scope the identifier was bound from
+		Type *recallType; // the recall binding's type (recall identifiers only; NULL otherwise)
+		unsigned int pathOffset; // the position of the identifier's atom path in the cache's path pool
+		unsigned int pathLength;
+		SymbolTree *st; // the binding
+		bool needsConstantization;
+};
+
+// bindId() results keyed by (scope, atom path, recall type); only valid while the scopes are unchanged, so it's cleared whenever imports are substituted
+class BindingCache {
+	public:
+		// data members
+		vector<BindingCacheEntry> entries;
+		vector<Atom> pathPool; // the atom paths of all of the entries, back to back
+		unsigned int *slots; // open-addressing hash index into entries (offset by one, so that 0 marks an empty slot)
+		unsigned int capacity; // the number of slots; always a power of two
+		// allocators/deallocators
+		BindingCache();
+		~BindingCache();
+		// core methods
+		const BindingCacheEntry *find(SymbolTree *env, const vector<Atom> &path, Type *recallType) const;
+		void insert(SymbolTree *env, const vector<Atom> &path, Type *recallType, SymbolTree *st, bool needsConstantization);
+		void clear();
+	private:
+		static unsigned int hashKey(SymbolTree *env, const vector<Atom> &path, Type *recallType);
+		bool matches(const BindingCacheEntry &entry, SymbolTree *env, const vector<Atom> &path, Type *recallType) const;
+		void grow();
+};
+
+// StatusClaim acquisition results
+#define CLAIM_COMPUTE 0 // the status must be derived by this call
+#define CLAIM_MEMOIZED 1 // the status is memoized (or is being derived further up this thread's stack)
+#define CLAIM_SETTLED 2 // the status was derived elsewhere, and any side effects of deriving it have been accounted for
+#define CLAIM_ABANDONED 3 // the status is being derived by a thread that is (indirectly) waiting on this one; the phase has been flagged to be redone, so the node mustn't be touched
+
+// claim word layout; while a node is being derived, the claim word holds the number of the task deriving it,
+// and once the node is published, the number of the task that derived it with CLAIM_DONE set (task 0 for statuses derived before typing went parallel)
+// note: the claim word is only ever accessed atomically while typing is parallel, so that publishing it also publishes the node's status
+#define CLAIM_FREE 0
+#define CLAIM_TASK 0x1FFFFFFFu // mask for the task number (tasks are numbered from 1, in sequential semming order)
+#define CLAIM_CONTEXTUAL 0x20000000u // set on published nodes whose status depended on the caller's context (a non-default incoming status, or the partial status of a node further up the stack)
+#define CLAIM_DONE 0x40000000u
+#define CLAIM_WAITERS 0x80000000u // set when some thread is blocked waiting for the claim to be published
+
+// whether a typing function's result depends on the incoming status that it was called with
+#define IS_STATUS_CONTEXT(inStatus) (inStatus.type != nullType() || inStatus.retType != errType())
+
+// something that happened while deriving a node's status in parallel; either an error or a call to another memoized node
+class StatusEvent {
+	public:
+		// data members
+		StatusLog **callee; // the called node's log field (calls only; NULL for errors)
+		SymbolTree *root; // the SymbolTree node that the call was made through, if any
+		string text; // the error's text (errors only; empty if the error was only counted)
+		// allocators/deallocators
+		StatusEvent(StatusLog **callee, SymbolTree *root, const string &text);
+		~StatusEvent();
+};
+
+class StatusLog {
+	public:
+		// data members
+		vector<StatusEvent> events;
+		bool replayed;
+		StatusLog *nextLog; // the next of the compilation's logs (see CompilerContext::statusLogs)
+		// allocators/deallocators
+		StatusLog();
+		~StatusLog();
+		// core methods
+		void replay();
+};
+
+// a typing function's hold on its node's memoized status; in the threaded semmer, makes sure that each node's status is derived only once,
+// with other threads that need it waiting until it's published when the deriving call returns
+class StatusClaim {
+	public:
+		// data members
+		volatile unsigned int &claim;
+		StatusLog *&log;
+		SymbolTree *root; // the SymbolTree node that the claim was acquired through, if any
+		bool owned; // whether this call claimed the node (and so has to publish it)
+		StatusClaim *prev; // the claim that was being derived when this one was acquired
+		bool contextual; // whether the status being derived depends on the caller's context
+		// allocators/deallocators
+		StatusClaim(volatile unsigned int &claim, StatusLog *&log);
+		~StatusClaim();
+		// core methods
+		int acquire(const TypeStatus &status, SymbolTree *root = NULL, bool contextual = false);
+		void record(const StatusEvent &event);
+	private:
+		void recordCall(SymbolTree *root);
+		void checkOrder(unsigned int cur);
+		bool wait();
+};
+
+// a worker's share of the parallel semmer's tasks; the owner takes tasks from the front, and idle workers steal them from the back
+class SemmerTaskQueue {
+	public:
+		// data members
+		pthread_mutex_t lock;
+		unsigned int head; // the next task to run
+		unsigned int tail; // one past the last task to run
+		// allocators/deallocators
+		SemmerTaskQueue(unsigned int head, unsigned int tail);
+		~SemmerTaskQueue();
+		// core methods
+		bool pop(unsigned int &task);
+		bool steal(unsigned int &task);
+};
+
+class SemmerPool {
+	public:
+		// data members
+		vector<SemmerTaskQueue *> queues; // one per worker
+		void (*work)(unsigned int task);
+		unsigned int nextWorkerId;
+		CompilerContext *context; // the compilation that the workers are working on
+		// allocators/deallocators
+		SemmerPool(unsigned int numTasks, unsigned int numWorkers, void (*work)(unsigned int task));
+		~SemmerPool();
+};
+
 // forward declarations of mutually recursive typing functions
 
-TypeStatus getStatusSymbolTree(SymbolTree *root, SymbolTree *parent, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusIdentifier(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusPrimaryBase(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusPrimary(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusBracketedExp(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusExp(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusPrimOpNode(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusPrimLiteral(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusBlock(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusFilterHeader(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
+TypeStatus getStatusSymbolTree(SymbolTree *root, SymbolTree *parent, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusIdentifier(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusAstLeaf(Ast *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusAstDelatch(Ast *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusAstPostfix(Ast *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusAstPrefix(Ast *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusAstInfix(Ast *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusAstBracketed(Ast *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusAst(Ast *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusBracketedExp(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusExp(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusPrimOpNode(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusPrimLiteral(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusBlock(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusFilterHeader(Tree *tree, const TypeStatus &inStatus = defaultStatus());
 TypeStatus verifyStatusFilter(Tree *tree);
-TypeStatus getStatusFilter(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusInstructor(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
+TypeStatus getStatusFilter(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusInstructor(Tree *tree, const TypeStatus &inStatus = defaultStatus());
 TypeStatus verifyStatusInstructor(Tree *tree);
-TypeStatus getStatusOutstructor(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
+TypeStatus getStatusOutstructor(Tree *tree, const TypeStatus &inStatus = defaultStatus());
 TypeStatus verifyStatusOutstructor(Tree *tree);
-TypeStatus getStatusObject(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
+TypeStatus getStatusObject(Tree *tree, const TypeStatus &inStatus = defaultStatus());
 TypeStatus verifyStatusObject(Tree *tree);
-TypeStatus getStatusType(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusTypeList(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusParamList(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusInstantiationSource(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusInstantiation(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusNode(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusTypedStaticTerm(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusAccess(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusStaticTerm(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusDynamicTerm(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusSwitchTerm(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusSimpleTerm(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusSimpleCondTerm(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusOpenOrClosedCondTerm(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusTerm(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
-TypeStatus getStatusNonEmptyTerms(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
+TypeStatus getStatusType(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusTypeList(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusParamList(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusInstantiationSource(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusInstantiation(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusNode(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusTypedStaticTerm(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusAccess(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusStaticTerm(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusDynamicTerm(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusSwitchTerm(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusSimpleTerm(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusSimpleCondTerm(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusOpenOrClosedCondTerm(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusTerm(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+TypeStatus getStatusNonEmptyTerms(Tree *tree, const TypeStatus &inStatus = defaultStatus());
 TypeStatus getStatusDeclaration(Tree *tree);
-TypeStatus getStatusPipe(Tree *tree, const TypeStatus &inStatus = TypeStatus(nullType, errType));
+void lowerSeededDeclaration(Tree *tree);
+TypeStatus getStatusPipe(Tree *tree, const TypeStatus &inStatus = defaultStatus());
+void verifyCopyImport(SymbolTree *root);
 
 // semantic analysis helper blocks
 
-#define GET_STATUS_HEADER \
-	/* if the type is memoized, short-circuit evaluate */\
-	if (tree->status.type != NULL) {\
+#define GET_STATUS_CONTEXT_HEADER(contextual) \
+	/* if the type is memoized (or another thread is deriving it, in which case wait for that), short-circuit evaluate */\
+	StatusClaim statusClaim(tree->claim, tree->log);\
+	int claimResult = statusClaim.acquire(tree->status, NULL, (contextual));\
+	if (claimResult == CLAIM_ABANDONED) {\
+		return TypeStatus(errType(), NULL);\
+	} else if (claimResult != CLAIM_COMPUTE) {\
 		return (tree->status);\
 	}\
 	/* otherwise, compute the type normally */
 
+#define GET_STATUS_HEADER GET_STATUS_CONTEXT_HEADER(IS_STATUS_CONTEXT(inStatus))
+
 #define GET_STATUS_SYMBOL_TREE_HEADER \
-	/* if the type is memoized, skip over type derivation */\
+	/* if the type is memoized, only redo the per-lookup check (or nothing, if the lookup's side effects have already been accounted for); the code is left to whoever derived the node */\
 	Tree *tree = root->defSite;\
-	if (tree->status.type != NULL) {\
-		goto endTypeDerivation;\
+	StatusClaim statusClaim(tree->claim, tree->log);\
+	int claimResult = statusClaim.acquire(tree->status, root, root->kind != KIND_DECLARATION && IS_STATUS_CONTEXT(inStatus));\
+	if (claimResult == CLAIM_ABANDONED) {\
+		return TypeStatus(errType(), NULL);\
+	} else if (claimResult == CLAIM_MEMOIZED && tree->status.type->category != CATEGORY_ERRORTYPE) {\
+		verifyCopyImport(root);\
+	}\
+	if (claimResult != CLAIM_COMPUTE) {\
+		return (tree->status);\
 	}\
 	/* otherwise, compute the type normally */
 
@@ -135,7 +322,7 @@ TypeStatus getStatusPipe(Tree *tree, const TypeStatus &inStatus = TypeStatus(nul
 
 #define GET_STATUS_CODE \
 	/* if we failed to do a returnType, returnTypeRet, or returnStatus, memoize the error type and return from this function */\
-	tree->status = TypeStatus(errType, NULL);\
+	tree->status = TypeStatus(errType(), NULL);\
 	return (tree->status);\
 	/* label the exit point of type derivation (i.e. the entry point for code generation) */\
 	endTypeDerivation:\
@@ -155,7 +342,7 @@ TypeStatus getStatusPipe(Tree *tree, const TypeStatus &inStatus = TypeStatus(nul
 
 #define GET_STATUS_NO_CODE_FOOTER \
 	/* if we failed to do a returnType, returnTypeRet, or returnStatus, memoize the error type and return from this function */\
-	tree->status = TypeStatus(errType, NULL);\
+	tree->status = TypeStatus(errType(), NULL);\
 	/* label the exit point for type derivation */\
 	endTypeDerivation:\
 	/* return from this function */\
@@ -163,6 +350,7 @@ TypeStatus getStatusPipe(Tree *tree, const TypeStatus &inStatus = TypeStatus(nul
 	
 // main semantic analysis function
 
+void warmSemmer(); // builds the standard types and nodes ahead of the next sem()
 int sem(Tree *treeRoot, SymbolTree *&stRoot, SchedTree *&codeRoot);
 
 #endif
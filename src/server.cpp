@@ -0,0 +1,344 @@
+#include "server.h"
+
+#include "semmer.h"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <errno.h>
+
+// socket helpers
+
+// reads or writes the whole buffer, retrying on short transfers; returns false if the connection failed
+bool readAll(int fd, void *buf, size_t size) {
+	char *cur = (char *)buf;
+	while (size > 0) {
+		ssize_t n = read(fd, cur, size);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n <= 0) {
+			return false;
+		}
+		cur += n;
+		size -= n;
+	}
+	return true;
+}
+bool writeAll(int fd, const void *buf, size_t size) {
+	const char *cur = (const char *)buf;
+	while (size > 0) {
+		ssize_t n = write(fd, cur, size);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n <= 0) {
+			return false;
+		}
+		cur += n;
+		size -= n;
+	}
+	return true;
+}
+
+bool readString(int fd, string &s) {
+	uint32_t length;
+	if (!readAll(fd, &length, sizeof(length)) || length > SERVER_MAX_STRING_LENGTH) {
+		return false;
+	}
+	s.resize(length);
+	return (length == 0 || readAll(fd, &(s[0]), length));
+}
+bool writeString(int fd, const string &s) {
+	uint32_t length = s.size();
+	return (writeAll(fd, &length, sizeof(length)) && writeAll(fd, s.data(), length));
+}
+
+void initServerRequest(ServerRequest &request, uint32_t numArgs) {
+	memset(&request, 0, sizeof(request));
+	memcpy(request.magic, SERVER_MAGIC, SERVER_MAGIC_LENGTH);
+	string version = string(VERSION_STRING) + "." + VERSION_STAMP;
+	strncpy(request.version, version.c_str(), PARSE_CACHE_VERSION_LENGTH-1);
+	request.numArgs = numArgs;
+}
+
+bool initServerAddress(struct sockaddr_un &address, const char *socketPath) {
+	if (strlen(socketPath) >= sizeof(address.sun_path)) {
+		return false;
+	}
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, socketPath);
+	return true;
+}
+
+// server functions
+
+void closeFds(int *fds, int numFds) {
+	for (int i=0; i<numFds; i++) {
+		close(fds[i]);
+	}
+}
+
+// returns true if the peer on the given connection is running as the same user as the server
+bool isPeerTrusted(int conn) {
+	struct ucred cred;
+	socklen_t credLength = sizeof(cred);
+	return (getsockopt(conn, SOL_SOCKET, SO_PEERCRED, &cred, &credLength) == 0 && credLength == sizeof(cred) && cred.uid == getuid());
+}
+
+// ends a forked compilation with the given exit status; only the compilation's own output is flushed, and the exit handlers inherited from the server are skipped
+void endCompilation(int status) {
+	outStream() << flush;
+	errStream() << flush;
+	fflush(stdout);
+	fflush(stderr);
+	_exit(status);
+}
+
+// receives a request on the given connection, and runs it in a fresh copy of the (warm) server process that inherits the client's
+// standard descriptors and working directory; replies with the compilation's wait status
+void serveRequest(int conn) {
+	// only compile for our own user, since the compilation runs with our privileges; anyone else gets sent back to compile on their own
+	if (!isPeerTrusted(conn)) {
+		int32_t status = SERVER_STATUS_REJECTED;
+		writeAll(conn, &status, sizeof(status));
+		return;
+	}
+	// receive the request header, along with the client's standard descriptors
+	ServerRequest request;
+	int fds[3];
+	int numFds = 0;
+	char control[CMSG_SPACE(sizeof(fds))];
+	struct iovec iov;
+	iov.iov_base = &request;
+	iov.iov_len = sizeof(request);
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	ssize_t n;
+	do {
+		n = recvmsg(conn, &msg, 0);
+	} while (n < 0 && errno == EINTR);
+	struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+	if (n > 0 && cmsg != NULL && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS && cmsg->cmsg_len >= CMSG_LEN(0)) { // take whatever descriptors came, so that they get closed if the request is bad
+		numFds = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+		if (numFds > 3) {
+			numFds = 3;
+		}
+		memcpy(fds, CMSG_DATA(cmsg), numFds * sizeof(int));
+	}
+	if (n <= 0 || numFds != 3) {
+		closeFds(fds, numFds);
+		return;
+	}
+	// the rest of the header may not have arrived with the descriptors
+	if ((size_t)n < sizeof(request) && !readAll(conn, ((char *)&request) + n, sizeof(request) - n)) {
+		closeFds(fds, 3);
+		return;
+	}
+	ServerRequest expected;
+	initServerRequest(expected, request.numArgs);
+	if (memcmp(request.magic, expected.magic, SERVER_MAGIC_LENGTH) != 0 || memcmp(request.version, expected.version, PARSE_CACHE_VERSION_LENGTH) != 0 ||
+			request.numArgs == 0 || request.numArgs > SERVER_MAX_ARGS) { // if the client is from another version of the compiler, send it back to compile on its own
+		closeFds(fds, 3);
+		int32_t status = SERVER_STATUS_REJECTED;
+		writeAll(conn, &status, sizeof(status));
+		return;
+	}
+	// receive the arguments and the working directory
+	vector<string> args(request.numArgs);
+	for (unsigned int i=0; i<args.size(); i++) {
+		if (!readString(conn, args[i])) {
+			closeFds(fds, 3);
+			return;
+		}
+	}
+	string workingDir;
+	if (!readString(conn, workingDir)) {
+		closeFds(fds, 3);
+		return;
+	}
+	// run the compilation
+	pid_t pid = fork();
+	if (pid == 0) { // if we're the compiling process, step into the client's shoes and compile
+		for (int i=0; i<3; i++) {
+			dup2(fds[i], i);
+			close(fds[i]);
+		}
+		close(conn);
+		signal(SIGPIPE, SIG_DFL);
+		if (chdir(workingDir.c_str()) != 0) {
+			printError("cannot enter working directory '" << workingDir << "'");
+			endCompilation(die(1));
+		}
+		vector<char *> argv;
+		for (unsigned int i=0; i<args.size(); i++) {
+			argv.push_back(&(args[i][0]));
+		}
+		argv.push_back(NULL);
+		endCompilation(compile(args.size(), &(argv[0])));
+	}
+	closeFds(fds, 3);
+	int32_t status = SERVER_STATUS_REJECTED;
+	if (pid > 0) {
+		int waitStatus;
+		while (waitpid(pid, &waitStatus, 0) < 0 && errno == EINTR);
+		status = waitStatus;
+	}
+	writeAll(conn, &status, sizeof(status));
+}
+
+// waits for a connection on the server socket, then lets the server know (so that it can get the next handler ready) and serves the request on it
+void runHandler(int sock, int readyFd) {
+	int conn;
+	do {
+		conn = accept(sock, NULL, NULL);
+	} while (conn < 0 && (errno == EINTR || errno == ECONNABORTED));
+	char ready = (conn >= 0) ? SERVER_HANDLER_READY : SERVER_HANDLER_FAILED;
+	writeAll(readyFd, &ready, sizeof(ready));
+	close(readyFd);
+	close(sock);
+	if (conn >= 0) {
+		serveRequest(conn);
+		close(conn);
+	}
+}
+
+int runServer(const char *socketPath) {
+	struct sockaddr_un address;
+	if (!initServerAddress(address, socketPath)) {
+		printError("socket path '" << socketPath << "' is too long");
+		return 1;
+	}
+	int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (sock < 0) {
+		printError("cannot create server socket");
+		return 1;
+	}
+	struct stat pathStat;
+	if (lstat(socketPath, &pathStat) == 0) { // clear out the socket of a previous server, but never anything else
+		if (!S_ISSOCK(pathStat.st_mode)) {
+			printError("'" << socketPath << "' exists and is not a socket");
+			close(sock);
+			return 1;
+		}
+		unlink(socketPath);
+	} else if (errno != ENOENT) {
+		printError("cannot stat socket path '" << socketPath << "'");
+		close(sock);
+		return 1;
+	}
+	int readyPipe[2];
+	mode_t oldMask = umask(SERVER_SOCKET_UMASK); // only our own user can connect to the socket
+	bool bound = (bind(sock, (struct sockaddr *)&address, sizeof(address)) == 0);
+	umask(oldMask);
+	if (!bound || listen(sock, SERVER_BACKLOG) != 0 || pipe(readyPipe) != 0) {
+		printError("cannot listen on socket '" << socketPath << "'");
+		close(sock);
+		return 1;
+	}
+	// build the standard types and nodes up front, so that the compilations inherit them instead of building them again
+	warmSemmer();
+	printNotice("serving compile requests on '" << socketPath << "'");
+	outStream() << flush;
+	signal(SIGCHLD, SIG_IGN); // request handlers reap themselves
+	signal(SIGPIPE, SIG_IGN); // clients can go away at any time
+	for(;;) { // keep a request handler waiting on the socket, forking off the next one as soon as the previous one gets a connection
+		pid_t pid = fork();
+		if (pid == 0) { // if we're the request handler, serve a request and get out of the way
+			close(readyPipe[0]);
+			signal(SIGCHLD, SIG_DFL); // the handler waits on its compilation
+			runHandler(sock, readyPipe[1]);
+			_exit(0);
+		} else if (pid < 0) {
+			printError("cannot fork request handler");
+			break;
+		}
+		char ready;
+		if (!readAll(readyPipe[0], &ready, sizeof(ready)) || ready != SERVER_HANDLER_READY) {
+			printError("cannot accept connections on socket '" << socketPath << "'");
+			break;
+		}
+	}
+	close(readyPipe[0]);
+	close(readyPipe[1]);
+	close(sock);
+	return 1;
+}
+
+// client functions
+
+bool forwardToServer(int argc, char **argv, int &exitCode) {
+	const char *socketPath = getenv(SERVER_ENV_VAR);
+	struct sockaddr_un address;
+	if (socketPath == NULL || socketPath[0] == '\0' || !initServerAddress(address, socketPath)) {
+		return false;
+	}
+	int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (sock < 0) {
+		return false;
+	}
+	if (connect(sock, (struct sockaddr *)&address, sizeof(address)) != 0) { // if there's no server running, compile locally
+		close(sock);
+		return false;
+	}
+	char workingDirBuf[PATH_MAX];
+	if (getcwd(workingDirBuf, sizeof(workingDirBuf)) == NULL) {
+		close(sock);
+		return false;
+	}
+	signal(SIGPIPE, SIG_IGN); // a dying server shows up as a write error instead
+	// send the request header along with our standard descriptors
+	ServerRequest request;
+	initServerRequest(request, argc);
+	int fds[3] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+	char control[CMSG_SPACE(sizeof(fds))];
+	memset(control, 0, sizeof(control));
+	struct iovec iov;
+	iov.iov_base = &request;
+	iov.iov_len = sizeof(request);
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+	memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+	ssize_t n;
+	do {
+		n = sendmsg(sock, &msg, 0);
+	} while (n < 0 && errno == EINTR);
+	bool sent = (n > 0 && ((size_t)n == sizeof(request) || writeAll(sock, ((char *)&request) + n, sizeof(request) - n)));
+	// send the arguments and the working directory
+	for (int i=0; i<argc && sent; i++) {
+		sent = writeString(sock, argv[i]);
+	}
+	sent = sent && writeString(sock, workingDirBuf);
+	// wait for the compilation to finish
+	int32_t status;
+	bool received = sent && readAll(sock, &status, sizeof(status));
+	close(sock);
+	if (!sent) { // if the server hung up before taking the whole request, nothing has been compiled yet, so compile locally
+		return false;
+	} else if (!received) {
+		printError("lost connection to compile server on '" << socketPath << "'");
+		exitCode = 1;
+		return true;
+	} else if (status == SERVER_STATUS_REJECTED) { // if the server won't take the request, compile locally
+		return false;
+	}
+	if (WIFSIGNALED(status)) { // if the compilation died on a signal, die on the same one
+		signal(WTERMSIG(status), SIG_DFL);
+		raise(WTERMSIG(status));
+	}
+	exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+	return true;
+}
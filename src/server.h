@@ -0,0 +1,23 @@
+#ifndef _SERVER_H_
+#define _SERVER_H_
+
+#include "globalDefs.h"
+#include "constantDefs.h"
+#include "driver.h"
+
+// compile server protocol: the client sends a ServerRequest (along with its standard input, output, and error descriptors), then the
+// request's numArgs arguments and working directory, each as a uint32_t length followed by that many bytes; the server replies with a
+// single int32_t wait status once the compilation is done
+
+class ServerRequest {
+	public:
+		// data members
+		char magic[SERVER_MAGIC_LENGTH];
+		char version[PARSE_CACHE_VERSION_LENGTH]; // the version string and stamp of the client; servers only serve clients of their own version
+		uint32_t numArgs; // the length of the argument vector, including the program name
+};
+
+int runServer(const char *socketPath); // only returns (with an error code) if the server couldn't be started
+bool forwardToServer(int argc, char **argv, int &exitCode); // returns false if there's no server to forward to
+
+#endif
@@ -0,0 +1,220 @@
+#include "stats.h"
+
+#include "context.h"
+
+#include "driver.h"
+#include "lexer.h"
+
+#include <new>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+// stats-global variables
+
+const char *phaseNames[NUM_PHASES] = {"lex", "parse", "lexParse", "buildSt", "subImportDecls", "semSt", "semPipes", "genCodeRoot", "gen"};
+const char *statNames[NUM_STATS] = {"tokens", "treeNodes", "symbolTreeNodes", "types", "irTreeNodes", "astNodes"};
+
+// allocation counting
+
+// operator new only counts while at least one phase is being measured somewhere in the process, so that without -T/-J an allocation costs a single extra test
+volatile int allocationCounting = 0; // the number of phases currently being measured
+volatile unsigned long heapAllocations = 0; // process-wide, so concurrent library compilations count each other's allocations
+
+#if __cplusplus >= 201103L
+#define NEW_THROW_SPEC
+#define DELETE_THROW_SPEC noexcept
+#else
+#define NEW_THROW_SPEC throw(std::bad_alloc)
+#define DELETE_THROW_SPEC throw()
+#endif
+
+void *operator new(size_t size) NEW_THROW_SPEC {
+	if (allocationCounting) {
+		__sync_fetch_and_add(&heapAllocations, 1);
+	}
+	void *retVal = malloc(size ? size : 1);
+	if (retVal == NULL) {
+		throw std::bad_alloc();
+	}
+	return retVal;
+}
+void *operator new[](size_t size) NEW_THROW_SPEC {
+	return operator new(size);
+}
+void operator delete(void *ptr) DELETE_THROW_SPEC {
+	free(ptr);
+}
+void operator delete[](void *ptr) DELETE_THROW_SPEC {
+	free(ptr);
+}
+
+// PhaseStats functions
+
+PhaseStats::PhaseStats() : ran(false), wallTime(0.0), cpuTime(0.0), endRss(0), allocations(0), startWallTime(0.0), startCpuTime(0.0), startAllocations(0), counting(false) {
+	for (unsigned int i=0; i<NUM_STATS; i++) {
+		counts[i] = 0;
+		startCounts[i] = 0;
+	}
+}
+PhaseStats::~PhaseStats() {
+	if (counting) { // a phase that never ended (e.g. its compilation was abandoned) mustn't leave counting on
+		__sync_fetch_and_sub(&allocationCounting, 1);
+	}
+}
+
+// clock helpers (both in milliseconds)
+
+double getWallTime() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0);
+}
+double getCpuTime(const struct rusage &usage) {
+	return (usage.ru_utime.tv_sec * 1000.0 + usage.ru_utime.tv_usec / 1000.0 + usage.ru_stime.tv_sec * 1000.0 + usage.ru_stime.tv_usec / 1000.0);
+}
+
+// memory helpers
+
+// returns the current resident set size, in kilobytes (0 if it can't be determined)
+long getRss() {
+	long retVal = 0;
+	FILE *statm = fopen("/proc/self/statm", "r");
+	if (statm != NULL) {
+		long size;
+		long resident;
+		if (fscanf(statm, "%ld %ld", &size, &resident) == 2) {
+			retVal = resident * (sysconf(_SC_PAGESIZE) / 1024);
+		}
+		fclose(statm);
+	}
+	return retVal;
+}
+
+// phase logging functions
+
+void startPhase(int phase) {
+	if (!phaseStats()) {
+		return;
+	}
+	PhaseStats &ps = phaseStatsTable()[phase];
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	ps.startCpuTime = getCpuTime(usage);
+	for (unsigned int i=0; i<NUM_STATS; i++) {
+		ps.startCounts[i] = statCounters()[i];
+	}
+	if (!ps.counting) {
+		__sync_fetch_and_add(&allocationCounting, 1);
+		ps.counting = true;
+	}
+	ps.startAllocations = heapAllocations;
+	ps.startWallTime = getWallTime();
+}
+
+void endPhase(int phase) {
+	if (!phaseStats()) {
+		return;
+	}
+	PhaseStats &ps = phaseStatsTable()[phase];
+	unsigned long endAllocations = heapAllocations;
+	if (ps.counting) {
+		__sync_fetch_and_sub(&allocationCounting, 1);
+		ps.counting = false;
+	}
+	double endWallTime = getWallTime();
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	// phases can be entered more than once, so accumulate
+	ps.wallTime += endWallTime - ps.startWallTime;
+	ps.cpuTime += getCpuTime(usage) - ps.startCpuTime;
+	ps.allocations += endAllocations - ps.startAllocations;
+	ps.endRss = getRss();
+	for (unsigned int i=0; i<NUM_STATS; i++) {
+		ps.counts[i] += statCounters()[i] - ps.startCounts[i];
+	}
+	ps.ran = true;
+}
+
+// statistics printing
+
+void printStats() {
+	if (!phaseStats()) {
+		return;
+	}
+	// total up the source size
+	unsigned long sourceBytes = 0;
+	unsigned long sourceLines = 0;
+	for (unsigned int i=0; i<inFiles().size(); i++) {
+		sourceBytes += inFiles()[i]->size;
+		for (const char *cur = inFiles()[i]->data, *end = inFiles()[i]->data + inFiles()[i]->size; (cur = (const char *)memchr(cur, '\n', end - cur)) != NULL; cur++) {
+			sourceLines++;
+		}
+	}
+	// total up the phases
+	PhaseStats total;
+	for (unsigned int phase=0; phase<NUM_PHASES; phase++) {
+		const PhaseStats &ps = phaseStatsTable()[phase];
+		if (ps.ran) {
+			total.wallTime += ps.wallTime;
+			total.cpuTime += ps.cpuTime;
+			total.allocations += ps.allocations;
+			total.endRss = ps.endRss; // the last phase's
+			for (unsigned int i=0; i<NUM_STATS; i++) {
+				total.counts[i] += ps.counts[i];
+			}
+			total.ran = true;
+		}
+	}
+	// the peak is only tracked for the process as a whole (which, when compiling through the library, can include other compilations)
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	long peakRss = usage.ru_maxrss;
+	char lineBuf[MAX_STRING_LENGTH];
+	if (jsonStats()) { // if we're printing JSON, print a single object
+		errStream() << "{\"version\": \"" << VERSION_STRING << "." << VERSION_STAMP << "\", \"files\": " << inFiles().size() <<
+			", \"sourceBytes\": " << sourceBytes << ", \"sourceLines\": " << sourceLines << ", \"processPeakRssKb\": " << peakRss << ", \"phases\": [";
+		bool first = true;
+		for (unsigned int phase=0; phase<=NUM_PHASES; phase++) {
+			const PhaseStats &ps = (phase < NUM_PHASES) ? phaseStatsTable()[phase] : total;
+			if (!ps.ran) {
+				continue;
+			}
+			if (phase == NUM_PHASES) {
+				errStream() << "], \"total\": ";
+			} else if (!first) {
+				errStream() << ", ";
+			}
+			first = false;
+			errStream() << "{";
+			if (phase < NUM_PHASES) {
+				errStream() << "\"name\": \"" << phaseNames[phase] << "\", ";
+			}
+			sprintf(lineBuf, "\"wallMs\": %.3f, \"cpuMs\": %.3f, \"endRssKb\": %ld, \"allocations\": %lu", ps.wallTime, ps.cpuTime, ps.endRss, ps.allocations);
+			errStream() << lineBuf;
+			for (unsigned int i=0; i<NUM_STATS; i++) {
+				errStream() << ", \"" << statNames[i] << "\": " << ps.counts[i];
+			}
+			errStream() << "}";
+		}
+		if (!total.ran) {
+			errStream() << "]";
+		}
+		errStream() << "}\n";
+	} else { // else if we're printing plain text, print a table
+		errStream() << PROGRAM_STRING << ": phase statistics (" << inFiles().size() << " files, " << sourceBytes << " bytes, " << sourceLines << " lines; process peak RSS " << peakRss << " KB):\n";
+		sprintf(lineBuf, "%-16s %10s %10s %10s %12s %10s %10s %10s %10s %10s %10s\n",
+			"phase", "wall(ms)", "cpu(ms)", "endRss(KB)", "allocs", "tokens", "trees", "asts", "symbols", "types", "irTrees");
+		errStream() << lineBuf;
+		for (unsigned int phase=0; phase<=NUM_PHASES; phase++) {
+			const PhaseStats &ps = (phase < NUM_PHASES) ? phaseStatsTable()[phase] : total;
+			if (!ps.ran) {
+				continue;
+			}
+			sprintf(lineBuf, "%-16s %10.3f %10.3f %10ld %12lu %10lu %10lu %10lu %10lu %10lu %10lu\n",
+				(phase < NUM_PHASES) ? phaseNames[phase] : "total", ps.wallTime, ps.cpuTime, ps.endRss,
+				ps.allocations, ps.counts[STAT_TOKENS], ps.counts[STAT_TREE_NODES], ps.counts[STAT_AST_NODES],
+				ps.counts[STAT_SYMBOL_TREE_NODES], ps.counts[STAT_TYPES], ps.counts[STAT_IR_TREE_NODES]);
+			errStream() << lineBuf;
+		}
+	}
+}
@@ -0,0 +1,59 @@
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include "globalDefs.h"
+#include "constantDefs.h"
+
+// compiler phases
+
+#define PHASE_LEX 0
+#define PHASE_PARSE 1
+#define PHASE_LEX_PARSE 2 // lexing and parsing when they're streamed into each other (i.e. not run as separate phases)
+#define PHASE_BUILD_ST 3
+#define PHASE_SUB_IMPORT_DECLS 4
+#define PHASE_SEM_ST 5
+#define PHASE_SEM_PIPES 6
+#define PHASE_GEN_CODE_ROOT 7
+#define PHASE_GEN 8
+
+#define NUM_PHASES 9
+
+// statistics counters
+
+#define STAT_TOKENS 0
+#define STAT_TREE_NODES 1
+#define STAT_SYMBOL_TREE_NODES 2
+#define STAT_TYPES 3
+#define STAT_IR_TREE_NODES 4
+#define STAT_AST_NODES 5
+
+#define NUM_STATS 6
+
+// note: counting is thread-safe, and a no-op unless statistics were requested (or outside of a compilation, e.g. during static initialization)
+#define STAT_COUNT(stat) do { if (compilerContext != NULL && phaseStats()) { __sync_fetch_and_add(&(statCounters()[stat]), 1); } } while (0)
+
+class PhaseStats {
+	public:
+		// data members
+		bool ran; // whether the phase ran at all
+		double wallTime; // in milliseconds
+		double cpuTime; // in milliseconds (user plus system, across all threads)
+		long endRss; // resident set size in kilobytes, as of the end of the phase (not the peak during it)
+		unsigned long allocations; // the number of heap allocations (operator new calls) made during the phase
+		unsigned long counts[NUM_STATS]; // the change in each of the statistics counters over the phase
+		// internal snapshot of the phase start
+		double startWallTime;
+		double startCpuTime;
+		unsigned long startAllocations;
+		bool counting; // whether the phase is currently holding allocation counting on
+		unsigned long startCounts[NUM_STATS];
+		// allocators/deallocators
+		PhaseStats();
+		~PhaseStats();
+};
+
+void startPhase(int phase);
+void endPhase(int phase);
+void printStats();
+
+#endif
@@ -1,10 +1,61 @@
 #include "types.h"
 
 #include "outputOperators.h"
+#include "stats.h"
+
+// types-global variables
+
+__thread TypeStringFrame *typeStringFrames = NULL;
+
+StdType *volatile internedStdTypes[NUM_STD_KINDS][NUM_SUFFIXES][STD_TYPE_INTERN_DEPTH]; // by kind, suffix, and depth; filled in lazily
+
+volatile unsigned int typeIdCounter = 0;
+__thread TypeRelationCache *workerTypeRelationCache = NULL; // the parallel semmer's workers each keep their own
+__thread TypeRelationFrame *typeRelationFrames = NULL;
+#define promotionTypes(promotion, suffix, depth) (compilerContext->promotionTypes[((promotion)*NUM_SUFFIXES + (suffix))*STD_TYPE_INTERN_DEPTH + (depth)])
 
 // Type functions
 Type::Type(int category, int suffix, int depth, Tree *offsetExp) : category(category), suffix(suffix), depth(depth), offsetExp(offsetExp),
-	referensible(true), instantiable(true), toStringHandled(false) {}
+	referensible(true), instantiable(true), id(__sync_add_and_fetch(&typeIdCounter, 1)) {
+	STAT_COUNT(STAT_TYPES);
+}
+Type::Type(const Type &otherType) : category(otherType.category), suffix(otherType.suffix), depth(otherType.depth), offsetExp(otherType.offsetExp),
+	referensible(otherType.referensible), instantiable(otherType.instantiable), id(__sync_add_and_fetch(&typeIdCounter, 1)) {}
+bool Type::computeRelation(Type &otherType, int relation) {return false;}
+// memoized version of computeRelation(); only valid for FilterTypes and ObjectTypes, whose comparisons can be arbitrarily deep
+bool Type::relate(Type &otherType, int relation) {
+	// if we're already in the middle of this comparison (the types are recursive), assume that it holds;
+	// whatever is derived from that assumption up to the original comparison is only known once that comparison completes
+	for (TypeRelationFrame *frame = typeRelationFrames; frame != NULL; frame = frame->prev) {
+		if (frame->type == this && frame->otherType == &otherType && frame->relation == relation) {
+			for (TypeRelationFrame *cur = typeRelationFrames; cur != frame; cur = cur->prev) {
+				cur->provisional = true;
+			}
+			return true;
+		}
+	}
+	// otherwise, check if we've already done this comparison
+	TypeRelationCache &cache = (workerTypeRelationCache != NULL) ? *workerTypeRelationCache : *(compilerContext->typeRelationCache);
+	const TypeRelationEntry *entry = cache.find(*this, otherType, relation);
+	if (entry != NULL) {
+		return entry->result;
+	}
+	// otherwise, do the comparison
+	TypeRelationFrame frame;
+	frame.type = this;
+	frame.otherType = &otherType;
+	frame.relation = relation;
+	frame.provisional = false;
+	frame.prev = typeRelationFrames;
+	typeRelationFrames = &frame;
+	bool result = computeRelation(otherType, relation);
+	typeRelationFrames = frame.prev;
+	// failures never depend on assumptions (assuming that a comparison holds can only make others hold), so only provisional successes aren't memoized
+	if (!result || !frame.provisional) {
+		cache.insert(*this, otherType, relation, result);
+	}
+	return result;
+}
 bool Type::baseEquals(const Type &otherType) const {return (suffix == otherType.suffix && depth == otherType.depth);}
 bool Type::baseSendable(const Type &otherType) const {
 	return (
@@ -79,6 +130,12 @@ string Type::suffixString() const {
 	return acc;
 }
 Type::~Type() {}
+void *Type::operator new(size_t size) {
+	return allocNode(OWNED_TYPES, size);
+}
+void Type::operator delete(void *ptr) {
+	freeNode(ptr);
+}
 void Type::constantize() {
 	if (suffix == SUFFIX_LATCH) {
 		suffix = SUFFIX_CONSTANT;
@@ -262,7 +319,7 @@ Type *Type::link(Type &otherType) {
 		} else if (otherType >> *this) {
 			return (Type *)this;
 		} else {
-			return errType;
+			return errType();
 		}
 	} else if (suffix == SUFFIX_STREAM && otherType.suffix == SUFFIX_STREAM && depth == otherType.depth) {
 		if (*this >> otherType) {
@@ -270,10 +327,10 @@ Type *Type::link(Type &otherType) {
 		} else if (otherType >> *this) {
 			return (Type *)this;
 		} else {
-			return errType;
+			return errType();
 		}
 	} else {
-		return errType;
+		return errType();
 	}
 }
 TypeList *Type::wrapTypeList() const {
@@ -298,6 +355,25 @@ bool Type::operator!=(int kind) const {return (!(operator==(kind)));}
 // StdType functions
 StdType::StdType(int kind, int suffix, int depth, Tree *offsetExp) : Type(CATEGORY_STDTYPE, suffix, depth, offsetExp), kind(kind) {}
 StdType::~StdType() {}
+StdType *internStdType(int kind, int suffix, int depth) {
+	if (depth >= STD_TYPE_INTERN_DEPTH) { // deep types are rare, so just allocate those
+		return (new StdType(kind, suffix, depth));
+	}
+	StdType *volatile &slot = internedStdTypes[kind][suffix][depth];
+	StdType *retVal = __atomic_load_n(&slot, __ATOMIC_ACQUIRE);
+	if (retVal == NULL) { // if this is the first request for this type, create it, unless another thread beats us to it
+		allocatingSharedNodes = true; // interned types outlive the compilation that happens to create them
+		StdType *newType = new StdType(kind, suffix, depth);
+		allocatingSharedNodes = false;
+		retVal = __sync_val_compare_and_swap(&slot, (StdType *)NULL, newType);
+		if (retVal == NULL) {
+			retVal = newType;
+		} else {
+			delete newType;
+		}
+	}
+	return retVal;
+}
 bool StdType::isComparable() const {
 	return (kind >= STD_MIN_COMPARABLE && kind <= STD_MAX_COMPARABLE);
 }
@@ -321,7 +397,7 @@ int StdType::kindCast(const StdType &otherType) const {
 }
 pair<Type *, bool> StdType::stdFlowDerivation(const TypeStatus &prevTermStatus, Tree *nextTerm) const {
 	// derive the nextTermStatus if we'll subsequently need it
-	TypeStatus nextTermStatus = errType;
+	TypeStatus nextTermStatus = errType();
 	switch(kind) {
 		case STD_DEQUALS:
 		case STD_NEQUALS:
@@ -360,14 +436,14 @@ pair<Type *, bool> StdType::stdFlowDerivation(const TypeStatus &prevTermStatus,
 				if (prevTermStatus.type->category == CATEGORY_STDTYPE && (prevTermStatus.type->suffix == SUFFIX_CONSTANT || prevTermStatus.type->suffix == SUFFIX_LATCH) &&
 						nextTermStatus.type->category == CATEGORY_STDTYPE && (nextTermStatus.type->suffix == SUFFIX_CONSTANT || nextTermStatus.type->suffix == SUFFIX_LATCH) &&
 						((StdType *)(prevTermStatus.type))->kindCast(*((StdType *)(nextTermStatus.type)))) { // if the terms are comparable, return bool
-					return make_pair(new StdType(STD_BOOL, SUFFIX_LATCH), true); // return true, since we're consuming the nextTerm
+					return make_pair(internStdType(STD_BOOL, SUFFIX_LATCH), true); // return true, since we're consuming the nextTerm
 				}
 			}
 			break;
 		case STD_LS:
 		case STD_RS:
-			if ((*prevTermStatus >> *stdIntType) && (*nextTermStatus >> *stdIntType)) { // if both terms can be converted to int, return int
-				return make_pair(new StdType(STD_INT, SUFFIX_LATCH), true); // return true, since we're consuming the nextTerm
+			if ((*prevTermStatus >> *stdIntType()) && (*nextTermStatus >> *stdIntType())) { // if both terms can be converted to int, return int
+				return make_pair(internStdType(STD_INT, SUFFIX_LATCH), true); // return true, since we're consuming the nextTerm
 			}
 			break;
 		case STD_TIMES:
@@ -376,118 +452,99 @@ pair<Type *, bool> StdType::stdFlowDerivation(const TypeStatus &prevTermStatus,
 		case STD_PLUS:
 		case STD_MINUS:
 			if (*nextTermStatus) {
-				if ((*prevTermStatus >> *stdIntType) && (*nextTermStatus >> *stdIntType)) { // if both terms can be converted to int, return int
-					return make_pair(new StdType(STD_INT, SUFFIX_LATCH), true); // return true, since we're consuming the nextTerm
+				if ((*prevTermStatus >> *stdIntType()) && (*nextTermStatus >> *stdIntType())) { // if both terms can be converted to int, return int
+					return make_pair(internStdType(STD_INT, SUFFIX_LATCH), true); // return true, since we're consuming the nextTerm
 				}
-				if ((*prevTermStatus >> *stdFloatType) && (*nextTermStatus >> *stdFloatType)) { // if both terms can be converted to float, return float
-					return make_pair(new StdType(STD_FLOAT, SUFFIX_LATCH), true); // return true, since we're consuming the nextTerm
+				if ((*prevTermStatus >> *stdFloatType()) && (*nextTermStatus >> *stdFloatType())) { // if both terms can be converted to float, return float
+					return make_pair(internStdType(STD_FLOAT, SUFFIX_LATCH), true); // return true, since we're consuming the nextTerm
 				}
 				// if this is the + operator and both terms are convertible to string, return string
 				if (kind == STD_PLUS &&
-						((*prevTermStatus >> *stdStringType) && (*nextTermStatus >> *stdStringType))) {
-					return make_pair(new StdType(STD_STRING, SUFFIX_LATCH), true); // return true, since were consuming the nextTerm
+						((*prevTermStatus >> *stdStringType()) && (*nextTermStatus >> *stdStringType()))) {
+					return make_pair(internStdType(STD_STRING, SUFFIX_LATCH), true); // return true, since were consuming the nextTerm
 				}
 			}
 			// if we got here, we failed to derive a three-term type, so now we try using STD_PLUS and STD_MINUS in their unary form
 			if (kind == STD_PLUS || kind == STD_MINUS) { // if it's an operator with a unary form that accepts both ints an floats
-				if (*prevTermStatus >> *stdIntType) { // if both terms can be converted to int, return int
-					return make_pair(new StdType(STD_INT, SUFFIX_LATCH), false); // return false, since we're not consuming the nextTerm
+				if (*prevTermStatus >> *stdIntType()) { // if both terms can be converted to int, return int
+					return make_pair(internStdType(STD_INT, SUFFIX_LATCH), false); // return false, since we're not consuming the nextTerm
 				}
-				if (*prevTermStatus >> *stdFloatType) { // if both terms can be converted to float, return float
-					return make_pair(new StdType(STD_FLOAT, SUFFIX_LATCH), false); // return false, since we're not consuming the nextTerm
+				if (*prevTermStatus >> *stdFloatType()) { // if both terms can be converted to float, return float
+					return make_pair(internStdType(STD_FLOAT, SUFFIX_LATCH), false); // return false, since we're not consuming the nextTerm
 				}
 			}
 			break;
 		case STD_DPLUS:
 		case STD_DMINUS:
-			if (*prevTermStatus >> *stdIntType) { // if both terms can be converted to int, return int
-				return make_pair(new StdType(STD_INT, SUFFIX_LATCH), false); // return false, since we're not consuming the nextTerm
+			if (*prevTermStatus >> *stdIntType()) { // if both terms can be converted to int, return int
+				return make_pair(internStdType(STD_INT, SUFFIX_LATCH), false); // return false, since we're not consuming the nextTerm
 			}
 			break;
 		default:
 			break;
 	}
-	return make_pair(errType, false); // return false, since we're not consuming the nextTerm (though this doesn't really matter -- it's an error anyway)
+	return make_pair(errType(), false); // return false, since we're not consuming the nextTerm (though this doesn't really matter -- it's an error anyway)
+}
+// returns whether the given standard operator ObjectType, taking on the given suffix and depth, can be sent to otherType;
+// the retyped copies are built once per combination, so that their comparisons can be memoized
+bool promotionSendable(int promotion, ObjectType *base, int suffix, int depth, Type &otherType) {
+	if (depth >= STD_TYPE_INTERN_DEPTH) { // deep types are rare, so just use a temporary copy for those
+		ObjectType tempObjectType(*base); tempObjectType.suffix = suffix; tempObjectType.depth = depth;
+		bool result = (tempObjectType >> otherType);
+		tempObjectType.clear();
+		return result;
+	}
+	ObjectType *volatile &slot = promotionTypes(promotion, suffix, depth);
+	ObjectType *promotionType = __atomic_load_n(&slot, __ATOMIC_ACQUIRE);
+	if (promotionType == NULL) { // if this is the first use of this combination, create it, unless another thread beats us to it
+		ObjectType *newType = new ObjectType(*base); newType->suffix = suffix; newType->depth = depth;
+		promotionType = __sync_val_compare_and_swap(&slot, (ObjectType *)NULL, newType);
+		if (promotionType == NULL) {
+			promotionType = newType;
+		} else {
+			newType->erase();
+		}
+	}
+	return (*promotionType >> otherType);
 }
 bool StdType::objectTypePromotion(Type &otherType) const {
 	if (kind >= STD_MIN_COMPARABLE && kind <= STD_MAX_COMPARABLE &&
 			otherType.category == CATEGORY_OBJECTTYPE) {
-		ObjectType tempObjectType(*stringerType); tempObjectType.suffix = suffix; tempObjectType.depth = depth;
-		bool result = (tempObjectType >> otherType);
-		tempObjectType.clear();
-		if (result) {
+		if (promotionSendable(PROMOTION_STRINGER, stringerType(), suffix, depth, otherType)) {
 			return true;
 		}
 	}
 	if (kind == STD_NOT) {
-		ObjectType tempObjectType(*boolUnOpType); tempObjectType.suffix = suffix; tempObjectType.depth = depth;
-		bool result = (tempObjectType >> otherType);
-		tempObjectType.clear();
-		if (result) {
+		if (promotionSendable(PROMOTION_BOOL_UN_OP, boolUnOpType(), suffix, depth, otherType)) {
 			return true;
 		}
 	}
 	if (kind == STD_COMPLEMENT || kind == STD_DPLUS || kind == STD_DMINUS || kind == STD_PLUS || kind == STD_MINUS) {
-		ObjectType tempObjectType(*intUnOpType); tempObjectType.suffix = suffix; tempObjectType.depth = depth;
-		bool result = (tempObjectType >> otherType);
-		tempObjectType.clear();
-		if (result) {
+		if (promotionSendable(PROMOTION_INT_UN_OP, intUnOpType(), suffix, depth, otherType)) {
 			return true;
 		}
 	}
 	if (kind == STD_DOR || kind == STD_DAND) {
-		ObjectType tempObjectType(*boolBinOpType); tempObjectType.suffix = suffix; tempObjectType.depth = depth;
-		bool result = (tempObjectType >> otherType);
-		tempObjectType.clear();
-		if (result) {
+		if (promotionSendable(PROMOTION_BOOL_BIN_OP, boolBinOpType(), suffix, depth, otherType)) {
 			return true;
 		}
 	}
 	if (kind == STD_OR || kind == STD_AND || kind == STD_XOR || kind == STD_PLUS || kind == STD_MINUS || kind == STD_TIMES || kind == STD_DIVIDE || kind == STD_MOD || kind == STD_LS || kind == STD_RS) {
-		ObjectType tempObjectType(*intBinOpType); tempObjectType.suffix = suffix; tempObjectType.depth = depth;
-		bool result = (tempObjectType >> otherType);
-		tempObjectType.clear();
-		if (result) {
+		if (promotionSendable(PROMOTION_INT_BIN_OP, intBinOpType(), suffix, depth, otherType)) {
 			return true;
 		}
 	}
 	if (kind == STD_PLUS || kind == STD_MINUS || kind == STD_TIMES || kind == STD_DIVIDE || kind == STD_MOD) {
-		ObjectType tempObjectType(*floatBinOpType); tempObjectType.suffix = suffix; tempObjectType.depth = depth;
-		bool result = (tempObjectType >> otherType);
-		tempObjectType.clear();
-		if (result) {
+		if (promotionSendable(PROMOTION_FLOAT_BIN_OP, floatBinOpType(), suffix, depth, otherType)) {
 			return true;
 		}
 	}
 	if (kind == STD_DEQUALS || kind == STD_NEQUALS || kind == STD_LT || kind == STD_GT || kind == STD_LE || kind == STD_GE) {
-		ObjectType tempObjectType1(*boolCompOpType); tempObjectType1.suffix = suffix; tempObjectType1.depth = depth;
-		bool result = (tempObjectType1 >> otherType);
-		tempObjectType1.clear();
-		if (result) {
-			return true;
-		}
-		ObjectType tempObjectType2(*intCompOpType); tempObjectType2.suffix = suffix; tempObjectType2.depth = depth;
-		result = (tempObjectType2 >> otherType);
-		tempObjectType2.clear();
-		if (result) {
-			return true;
-		}
-		ObjectType tempObjectType3(*floatCompOpType); tempObjectType3.suffix = suffix; tempObjectType3.depth = depth;
-		result = (tempObjectType3 >> otherType);
-		tempObjectType3.clear();
-		if (result) {
-			return true;
-		}
-		ObjectType tempObjectType4(*charCompOpType); tempObjectType4.suffix = suffix; tempObjectType4.depth = depth;
-		result = (tempObjectType4 >> otherType);
-		tempObjectType4.clear();
-		if (result) {
-			return true;
-		}
-		ObjectType tempObjectType5(*stringCompOpType); tempObjectType5.suffix = suffix; tempObjectType5.depth = depth;
-		result = (tempObjectType5 >> otherType);
-		tempObjectType5.clear();
-		return result;
+		return (promotionSendable(PROMOTION_BOOL_COMP_OP, boolCompOpType(), suffix, depth, otherType) ||
+			promotionSendable(PROMOTION_INT_COMP_OP, intCompOpType(), suffix, depth, otherType) ||
+			promotionSendable(PROMOTION_FLOAT_COMP_OP, floatCompOpType(), suffix, depth, otherType) ||
+			promotionSendable(PROMOTION_CHAR_COMP_OP, charCompOpType(), suffix, depth, otherType) ||
+			promotionSendable(PROMOTION_STRING_COMP_OP, stringCompOpType(), suffix, depth, otherType));
 	}
 	// none of the above cases succeeded, so return false
 	return false;
@@ -496,7 +553,9 @@ Type *StdType::copy() const {Type *retVal = new StdType(*this); retVal->referens
 void StdType::erase() {delete this;}
 void StdType::clear() {}
 bool StdType::operator==(Type &otherType) {
-	if (otherType.category == CATEGORY_STDTYPE) {
+	if (this == &otherType) { // if the types are actually the same object instance (as interned types are), return true
+		return true;
+	} else if (otherType.category == CATEGORY_STDTYPE) {
 		StdType *otherTypeCast = (StdType *)(&otherType);
 		return (kind == otherTypeCast->kind && baseEquals(otherType));
 	} else {
@@ -506,13 +565,13 @@ bool StdType::operator==(Type &otherType) {
 bool StdType::operator==(int kind) const {return (this->kind == kind);}
 Type *StdType::operator,(Type &otherType) {
 	if (otherType.category == CATEGORY_STDTYPE) {
-		return errType;
+		return errType();
 	} else if (otherType.category == CATEGORY_TYPELIST) {
 		TypeList *otherTypeCast = (TypeList *)(&otherType);
 		if (otherTypeCast->list.size() == 1) {
 			return (*this , *(otherTypeCast->list[0]));
 		} else {
-			return errType;
+			return errType();
 		}
 	} else if (otherType.category == CATEGORY_FILTERTYPE) {
 		FilterType *otherTypeCast = (FilterType *)(&otherType);
@@ -520,10 +579,10 @@ Type *StdType::operator,(Type &otherType) {
 			return (otherTypeCast->to() != NULL) ? otherTypeCast->to()->foldTypeList() : NULL;
 		}
 	} else if (otherType.category == CATEGORY_OBJECTTYPE) {
-		return errType;
+		return errType();
 	}
 	// otherType.category == CATEGORY_ERRORTYPE
-	return errType;
+	return errType();
 }
 bool StdType::operator>>(Type &otherType) {
 	if (otherType.category == CATEGORY_STDTYPE) {
@@ -645,15 +704,9 @@ TypeList::TypeList(Type *type) : Type(CATEGORY_TYPELIST) {
 	list.push_back(type);
 }
 TypeList::TypeList() : Type(CATEGORY_TYPELIST) {
-	list.push_back(nullType);
-}
-TypeList::~TypeList() {
-	for (vector<Type *>::iterator iter = list.begin(); iter != list.end(); iter++) {
-		if (**iter != *nullType && **iter != *errType && !((*iter)->referensible)) {
-			delete (*iter);
-		}
-	}
+	list.push_back(nullType());
 }
+TypeList::~TypeList() {} // the compilation frees the member types (see allocNode())
 bool TypeList::isComparable(const Type &otherType) const {return (list.size() == 1 && list[0]->isComparable(otherType));}
 Type *TypeList::copy() const {Type *retVal = new TypeList(*this); retVal->referensible = true; retVal->instantiable = true; return retVal;}
 void TypeList::erase() {clear(); delete this;}
@@ -686,22 +739,22 @@ Type *TypeList::operator,(Type &otherType) {
 		StdType *otherTypeCast = (StdType *)(&otherType);
 		if (list.size() == 1 && (list[0])->category == CATEGORY_STDTYPE && ((list[0])->suffix == SUFFIX_CONSTANT || (list[0])->suffix == SUFFIX_LATCH)) {
 			StdType *thisTypeCast = (StdType *)(list[0]);
-			if (otherTypeCast->kind == STD_NOT && (*thisTypeCast >> *stdBoolType)) {
-				return (new StdType(STD_BOOL, SUFFIX_LATCH));
-			} else if (otherTypeCast->kind == STD_COMPLEMENT && (*thisTypeCast >> *stdIntType)) {
-				return (new StdType(STD_INT, SUFFIX_LATCH));
-			} else if ((otherTypeCast->kind == STD_DPLUS || otherTypeCast->kind == STD_DMINUS) && (*thisTypeCast >> *stdIntType)) {
-				return (new StdType(STD_INT, SUFFIX_LATCH));
+			if (otherTypeCast->kind == STD_NOT && (*thisTypeCast >> *stdBoolType())) {
+				return (internStdType(STD_BOOL, SUFFIX_LATCH));
+			} else if (otherTypeCast->kind == STD_COMPLEMENT && (*thisTypeCast >> *stdIntType())) {
+				return (internStdType(STD_INT, SUFFIX_LATCH));
+			} else if ((otherTypeCast->kind == STD_DPLUS || otherTypeCast->kind == STD_DMINUS) && (*thisTypeCast >> *stdIntType())) {
+				return (internStdType(STD_INT, SUFFIX_LATCH));
 			} else if (otherTypeCast->kind == STD_PLUS || otherTypeCast->kind == STD_MINUS) {
-				if (*thisTypeCast >> *stdIntType) {
-					return (new StdType(STD_INT, SUFFIX_LATCH));
-				} else if (*thisTypeCast >> *stdFloatType){
-					return (new StdType(STD_FLOAT, SUFFIX_LATCH));
+				if (*thisTypeCast >> *stdIntType()) {
+					return (internStdType(STD_INT, SUFFIX_LATCH));
+				} else if (*thisTypeCast >> *stdFloatType()){
+					return (internStdType(STD_FLOAT, SUFFIX_LATCH));
 				} else {
-					return errType;
+					return errType();
 				}
 			} else {
-				return errType;
+				return errType();
 			}
 		} else if (list.size() == 2 &&
 				((list[0])->category == CATEGORY_STDTYPE && ((list[0])->suffix == SUFFIX_CONSTANT || (list[0])->suffix == SUFFIX_LATCH)) &&
@@ -709,46 +762,46 @@ Type *TypeList::operator,(Type &otherType) {
 			StdType *thisTypeCast1 = (StdType *)(list[0]);
 			StdType *thisTypeCast2 = (StdType *)(list[1]);
 			if ((otherTypeCast->kind == STD_DOR || otherTypeCast->kind == STD_DAND) &&
-					((*thisTypeCast1 >> *stdBoolType) && (*thisTypeCast2 >> *stdBoolType))) {
-				return (new StdType(STD_BOOL, SUFFIX_LATCH));
+					((*thisTypeCast1 >> *stdBoolType()) && (*thisTypeCast2 >> *stdBoolType()))) {
+				return (internStdType(STD_BOOL, SUFFIX_LATCH));
 			} else if ((otherTypeCast->kind == STD_OR || otherTypeCast->kind == STD_XOR || otherTypeCast->kind == STD_AND) &&
-					((*thisTypeCast1 >> *stdIntType) && (*thisTypeCast2 >> *stdIntType))) {
-				return (new StdType(STD_INT, SUFFIX_LATCH));
+					((*thisTypeCast1 >> *stdIntType()) && (*thisTypeCast2 >> *stdIntType()))) {
+				return (internStdType(STD_INT, SUFFIX_LATCH));
 			} else if (otherTypeCast->kind == STD_DEQUALS || otherTypeCast->kind == STD_NEQUALS ||
 					otherTypeCast->kind == STD_LT || otherTypeCast->kind == STD_GT ||
 					otherTypeCast->kind == STD_LE || otherTypeCast->kind == STD_GE) {
 				if (thisTypeCast1->kindCast(*thisTypeCast2)) {
-					return (new StdType(STD_BOOL, SUFFIX_LATCH));
+					return (internStdType(STD_BOOL, SUFFIX_LATCH));
 				} else {
-					return errType;
+					return errType();
 				}
 			} else if (otherTypeCast->kind == STD_TIMES || otherTypeCast->kind == STD_DIVIDE || otherTypeCast->kind == STD_MOD ||
 					otherTypeCast->kind == STD_PLUS || otherTypeCast->kind == STD_MINUS) {
-				if ((*thisTypeCast1 >> *stdIntType) && (*thisTypeCast2 >> *stdIntType)) {
-					return (new StdType(STD_INT, SUFFIX_LATCH));
-				} else if ((*thisTypeCast1 >> *stdFloatType) && (*thisTypeCast2 >> *stdFloatType)) {
-					return (new StdType(STD_FLOAT, SUFFIX_LATCH));
+				if ((*thisTypeCast1 >> *stdIntType()) && (*thisTypeCast2 >> *stdIntType())) {
+					return (internStdType(STD_INT, SUFFIX_LATCH));
+				} else if ((*thisTypeCast1 >> *stdFloatType()) && (*thisTypeCast2 >> *stdFloatType())) {
+					return (internStdType(STD_FLOAT, SUFFIX_LATCH));
 				} else {
-					return errType;
+					return errType();
 				}
 			}
 		} else {
-			return errType;
+			return errType();
 		}
 	} else if (otherType.category == CATEGORY_TYPELIST) {
-		return errType;
+		return errType();
 	} else if (otherType.category == CATEGORY_FILTERTYPE) {
 		FilterType *otherTypeCast = (FilterType *)(&otherType);
 		if (otherTypeCast->suffix == SUFFIX_LATCH && (*this >> *(otherTypeCast->from()))) {
 			return (otherTypeCast->to() != NULL) ? otherTypeCast->to()->foldTypeList() : NULL;
 		} else {
-			return errType;
+			return errType();
 		}
 	} else if (otherType.category == CATEGORY_OBJECTTYPE) {
-		return errType;
+		return errType();
 	}
 	// otherType.category == CATEGORY_ERRORTYPE
-	return errType;
+	return errType();
 }
 bool TypeList::operator>>(Type &otherType) {
 	if (this == &otherType) { // if the lists are actually the same object instance
@@ -833,14 +886,7 @@ FilterType::FilterType(Type *from, Type *to, int suffix, int depth, Tree *offset
 }
 FilterType::FilterType(Tree *defSite, Type *inType, int suffix, int depth, Tree *offsetExp) : Type(CATEGORY_FILTERTYPE, suffix, depth, offsetExp),
 	fromInternal(NULL), toInternal(NULL), defSite(defSite), inType(inType) {}
-FilterType::~FilterType() {
-	if (fromInternal != NULL && *fromInternal != *nullType && *fromInternal != *errType) {
-		delete fromInternal;
-	}
-	if (toInternal != NULL && *toInternal != *nullType && *toInternal != *errType) {
-		delete toInternal;
-	}
-}
+FilterType::~FilterType() {} // the compilation frees the internal type lists (see allocNode())
 TypeList *FilterType::from() { // either TypeList or errType
 	if (fromInternal == NULL && defSite != NULL) {
 		TypeStatus derivedStatus = getStatusFilterHeader(defSite, inType);
@@ -848,8 +894,8 @@ TypeList *FilterType::from() { // either TypeList or errType
 			fromInternal = ((FilterType *)(derivedStatus.type))->fromInternal;
 			toInternal = ((FilterType *)(derivedStatus.type))->toInternal;
 		} else { // else if we failed to derive a type for the filter header, log both the from- and to- types as erroneous
-			fromInternal = (TypeList *)errType;
-			toInternal = (TypeList *)errType;
+			fromInternal = (TypeList *)errType();
+			toInternal = (TypeList *)errType();
 		}
 	}
 	return fromInternal;
@@ -861,8 +907,8 @@ TypeList *FilterType::to() { // either TypeList or errType
 			fromInternal = ((FilterType *)(derivedStatus.type))->fromInternal;
 			toInternal = ((FilterType *)(derivedStatus.type))->toInternal;
 		} else { // else if we failed to derive a type for the filter header, log both the from- and to- types as erroneous
-			fromInternal = (TypeList *)errType;
-			toInternal = (TypeList *)errType;
+			fromInternal = (TypeList *)errType();
+			toInternal = (TypeList *)errType();
 		}
 	}
 	return toInternal;
@@ -871,12 +917,16 @@ bool FilterType::isComparable(const Type &otherType) const {return false;}
 Type *FilterType::copy() const {Type *retVal = new FilterType(*this); retVal->referensible = true; retVal->instantiable = true; return retVal;}
 void FilterType::erase() {clear(); delete this;}
 void FilterType::clear() {fromInternal = NULL; toInternal = NULL; defSite = NULL;}
+bool FilterType::computeRelation(Type &otherType, int relation) {
+	// relation == RELATION_EQUALS
+	FilterType *otherTypeCast = (FilterType *)(&otherType);
+	return (*(from()) == *(otherTypeCast->from()) && *(to()) == *(otherTypeCast->to()));
+}
 bool FilterType::operator==(Type &otherType) {
 	if (this == &otherType) { // if the filters are actually the same object instance, return true
 		return true;
 	} else if (otherType.category == CATEGORY_FILTERTYPE) {
-		FilterType *otherTypeCast = (FilterType *)(&otherType);
-		return (baseEquals(otherType) && *(from()) == *(otherTypeCast->from()) && *(to()) == *(otherTypeCast->to()));
+		return (baseEquals(otherType) && relate(otherType, RELATION_EQUALS));
 	} else {
 		return false;
 	}
@@ -884,26 +934,26 @@ bool FilterType::operator==(Type &otherType) {
 bool FilterType::operator==(int kind) const {return false;}
 Type *FilterType::operator,(Type &otherType) {
 	if (otherType.category == CATEGORY_STDTYPE) {
-		return errType;
+		return errType();
 	} else if (otherType.category == CATEGORY_TYPELIST) {
 		TypeList *otherTypeCast = (TypeList *)(&otherType);
 		if (otherTypeCast->list.size() == 1) {
 			return (*this , *(otherTypeCast->list[0]));
 		} else {
-			return errType;
+			return errType();
 		}
 	} else if (otherType.category == CATEGORY_FILTERTYPE) {
 		FilterType *otherTypeCast = (FilterType *)(&otherType);
 		if (otherTypeCast->suffix == SUFFIX_LATCH && (*this >> *(otherTypeCast->from()))) {
 			return (otherTypeCast->to() != NULL) ? otherTypeCast->to()->foldTypeList() : NULL;
 		} else {
-			return errType;
+			return errType();
 		}
 	} else if (otherType.category == CATEGORY_OBJECTTYPE) {
-		return errType;
+		return errType();
 	}
 	// otherType.category == CATEGORY_ERRORTYPE
-	return errType;
+	return errType();
 }
 bool FilterType::operator>>(Type &otherType) {
 	if (this == &otherType) { // if the filters are actually the same object instance
@@ -1009,7 +1059,7 @@ bool StructorList::reify() {
 				if (*derivedStatus) {
 					target.first = ((FilterType *)(derivedStatus.type))->from();
 				} else {
-					target.first = errType;
+					target.first = errType();
 					failed = true;
 				}
 			} else /* if (*(target.second) == TOKEN_Outstructor) */ {
@@ -1017,7 +1067,7 @@ bool StructorList::reify() {
 				if (*derivedStatus) {
 					target.first = ((FilterType *)(derivedStatus.type))->to();
 				} else {
-					target.first = errType;
+					target.first = errType();
 					failed = true;
 				}
 			}
@@ -1042,14 +1092,14 @@ StructorListResult StructorList::iterator::operator*() {
 			if (*derivedStatus) {
 				target.first = ((FilterType *)(derivedStatus.type))->from();
 			} else {
-				target.first = errType;
+				target.first = errType();
 			}
 		} else /* if (*(target.second) == TOKEN_Outstructor) */ {
 			TypeStatus derivedStatus = getStatusOutstructor(target.second);
 			if (*derivedStatus) {
 				target.first = ((FilterType *)(derivedStatus.type))->to();
 			} else {
-				target.first = errType;
+				target.first = errType();
 			}
 		}
 	}
@@ -1059,7 +1109,7 @@ StructorList::iterator StructorList::begin() {return iterator(structors.begin())
 StructorList::iterator StructorList::end() {return iterator(structors.end());}
 
 // MemberListResult functions
-MemberListResult::MemberListResult(const pair<string, pair<Type *, Tree *> > &internalPair) : internalPair(internalPair) {}
+MemberListResult::MemberListResult(const pair<const string, pair<Type *, Tree *> > &internalPair) : internalPair(internalPair) {}
 MemberListResult::~MemberListResult() {}
 MemberListResult::operator string() const {return internalPair.first;}
 MemberListResult::operator Type *() const {return internalPair.second.first;}
@@ -1103,26 +1153,10 @@ ObjectType::ObjectType(const StructorList &instructorList, const StructorList &o
 	Type(CATEGORY_OBJECTTYPE, suffix, depth, offsetExp), instructorList(instructorList), outstructorList(outstructorList) {}
 ObjectType::ObjectType(const StructorList &instructorList, const StructorList &outstructorList, const MemberList &memberList, int suffix, int depth, Tree *offsetExp) : 
 	Type(CATEGORY_OBJECTTYPE, suffix, depth, offsetExp), instructorList(instructorList), outstructorList(outstructorList), memberList(memberList) {}
-ObjectType::~ObjectType() {
-	for (StructorList::iterator iter = instructorList.begin(); iter != instructorList.end(); iter++) {
-		if (**iter != *nullType && **iter != *errType && !((*iter)->referensible)) {
-			delete (Type *)(*iter);
-		}
-	}
-	for (StructorList::iterator iter = outstructorList.begin(); iter != outstructorList.end(); iter++) {
-		if (**iter != *nullType && **iter != *errType && !((*iter)->referensible)) {
-			delete (Type *)(*iter);
-		}
-	}
-	for (MemberList::iterator iter = memberList.begin(); iter != memberList.end(); iter++) {
-		if (**iter != *nullType && **iter != *errType && !((*iter)->referensible)) {
-			delete (Type *)(*iter);
-		}
-	}
-}
+ObjectType::~ObjectType() {} // the compilation frees the member types (see allocNode())
 bool ObjectType::isNullInstantiable() {
 	for (StructorList::iterator iter = instructorList.begin(); iter != instructorList.end(); iter++) {
-		if (**iter == *nullType) {
+		if (**iter == *nullType()) {
 			return true;
 		}
 	}
@@ -1132,11 +1166,9 @@ bool ObjectType::isComparable(const Type &otherType) const {return false;}
 Type *ObjectType::copy() const {ObjectType *retVal = new ObjectType(*this); retVal->referensible = true; retVal->instantiable = true; return retVal;}
 void ObjectType::erase() {clear(); delete this;}
 void ObjectType::clear() {instructorList.clear(); outstructorList.clear(); memberList.clear();}
-bool ObjectType::operator==(Type &otherType) {
-	if (this == &otherType) { // if the objects are actually the same object instance, return true
-		return true;
-	} else if (otherType.category == CATEGORY_OBJECTTYPE) {
-		ObjectType *otherTypeCast = (ObjectType *)(&otherType);
+bool ObjectType::computeRelation(Type &otherType, int relation) {
+	ObjectType *otherTypeCast = (ObjectType *)(&otherType);
+	if (relation == RELATION_EQUALS) {
 		if ((instructorList.size() == otherTypeCast->instructorList.size()) && (outstructorList.size() == otherTypeCast->outstructorList.size()) && (memberList.size() == otherTypeCast->memberList.size())) {
 			// verify that the instructors match
 			StructorList::iterator insIter1 = instructorList.begin();
@@ -1175,6 +1207,77 @@ bool ObjectType::operator==(Type &otherType) {
 		} else {
 			return false;
 		}
+	} else /* if (relation == RELATION_SENDABLE) */ {
+		if (baseSendable(otherType)) {
+			// try to find a direct downcastability from the left object to the right one
+			// verify instructor downcastability
+			StructorList::iterator insIter;
+			for (insIter = otherTypeCast->instructorList.begin(); insIter != otherTypeCast->instructorList.end(); insIter++) {
+				StructorList::iterator insIter2;
+				for (insIter2 = instructorList.begin(); insIter2 != instructorList.end(); insIter2++) {
+					if (**insIter2 == **insIter) {
+						break;
+					}
+				}
+				if (insIter2 == instructorList.end()) { // if we failed to find a match for this instructor, break early
+					break;
+				}
+			}
+			if (insIter == otherTypeCast->instructorList.end()) { // if we matched all instructor types (we didn't break early), continue
+				// verify outstructor downcastability
+				StructorList::iterator outsIter;
+				for (outsIter = otherTypeCast->outstructorList.begin(); outsIter != otherTypeCast->outstructorList.end(); outsIter++) {
+					StructorList::iterator outsIter2;
+					for (outsIter2 = outstructorList.begin(); outsIter2 != outstructorList.end(); outsIter2++) {
+						if (**outsIter2 == **outsIter) {
+							break;
+						}
+					}
+					if (outsIter2 == outstructorList.end()) { // if we failed to find a match for this outstructor, break early
+						break;
+					}
+				}
+				if (outsIter == otherTypeCast->outstructorList.end()) { // if we matched all outstructor types (we didn't break early), continue
+					// verify member downcastability
+					MemberList::iterator memberListIter;
+					for (memberListIter = otherTypeCast->memberList.begin(); memberListIter != otherTypeCast->memberList.end(); memberListIter++) {
+						MemberList::iterator memberListIter2;
+						for (memberListIter2 = memberList.begin(); memberListIter2 != memberList.end(); memberListIter2++) {
+							if ((*memberListIter2)->baseEquals(**memberListIter) && (*memberListIter2 == *memberListIter)) {
+								break;
+							}
+						}
+						if (memberListIter2 == memberList.end()) { // if we failed to find a match for this member, break early
+							break;
+						}
+					}
+					if (memberListIter == otherTypeCast->memberList.end()) { // if we matched all mambers (we didn't break early), return success
+						return true;
+					}
+				}
+			}
+			// try to connect the left object into an instructor on the right object
+			for (StructorList::iterator insIter = otherTypeCast->instructorList.begin(); insIter != otherTypeCast->instructorList.end(); insIter++) {
+				if (*this >> **insIter) {
+					return true;
+				}
+			}
+			// otherwise, try an outstructed downcastability from the left object to the right object
+			for (StructorList::iterator outsIter = outstructorList.begin(); outsIter != outstructorList.end(); outsIter++) {
+				if (**outsIter >> *otherTypeCast) { // if there is a type match, return true
+					return true;
+				}
+			}
+		}
+		// if we had no matches to any of the above cases, conclude that the objects are not downcastable and return false
+		return false;
+	}
+}
+bool ObjectType::operator==(Type &otherType) {
+	if (this == &otherType) { // if the objects are actually the same object instance, return true
+		return true;
+	} else if (otherType.category == CATEGORY_OBJECTTYPE) {
+		return relate(otherType, RELATION_EQUALS);
 	} else {
 		return false;
 	}
@@ -1189,9 +1292,9 @@ Type *ObjectType::operator,(Type &otherType) {
 					return outstructorFlowType;
 				}
 			}
-			return errType;
+			return errType();
 		} else {
-			return errType;
+			return errType();
 		}
 	} else if (otherType.category == CATEGORY_TYPELIST) {
 		TypeList *otherTypeCast = (TypeList *)(&otherType);
@@ -1204,9 +1307,9 @@ Type *ObjectType::operator,(Type &otherType) {
 					return outstructorFlowType;
 				}
 			}
-			return errType;
+			return errType();
 		} else {
-			return errType;
+			return errType();
 		}
 	} else if (otherType.category == CATEGORY_FILTERTYPE) {
 		FilterType *otherTypeCast = (FilterType *)(&otherType);
@@ -1218,15 +1321,15 @@ Type *ObjectType::operator,(Type &otherType) {
 					return (otherTypeCast->to() != NULL) ? otherTypeCast->to()->foldTypeList() : NULL;
 				}
 			}
-			return errType;
+			return errType();
 		} else {
-			return errType;
+			return errType();
 		}
 	} else if (otherType.category == CATEGORY_OBJECTTYPE) {
-		return errType;
+		return errType();
 	}
 	// otherType.category == CATEGORY_ERRORTYPE
-	return errType;
+	return errType();
 }
 
 bool ObjectType::operator>>(Type &otherType) {
@@ -1265,70 +1368,7 @@ bool ObjectType::operator>>(Type &otherType) {
 		// else if we didn't find a type match, return false
 		return false;
 	} else if (otherType.category == CATEGORY_OBJECTTYPE) {
-		ObjectType *otherTypeCast = (ObjectType *)(&otherType);
-		if (baseSendable(otherType)) {
-			// try to find a direct downcastability from the left object to the right one
-			// verify instructor downcastability
-			StructorList::iterator insIter;
-			for (insIter = otherTypeCast->instructorList.begin(); insIter != otherTypeCast->instructorList.end(); insIter++) {
-				StructorList::iterator insIter2;
-				for (insIter2 = instructorList.begin(); insIter2 != instructorList.end(); insIter2++) {
-					if (**insIter2 == **insIter) {
-						break;
-					}
-				}
-				if (insIter2 == instructorList.end()) { // if we failed to find a match for this instructor, break early
-					break;
-				}
-			}
-			if (insIter == otherTypeCast->instructorList.end()) { // if we matched all instructor types (we didn't break early), continue
-				// verify outstructor downcastability
-				StructorList::iterator outsIter;
-				for (outsIter = otherTypeCast->outstructorList.begin(); outsIter != otherTypeCast->outstructorList.end(); outsIter++) {
-					StructorList::iterator outsIter2;
-					for (outsIter2 = outstructorList.begin(); outsIter2 != outstructorList.end(); outsIter2++) {
-						if (**outsIter2 == **outsIter) {
-							break;
-						}
-					}
-					if (outsIter2 == outstructorList.end()) { // if we failed to find a match for this outstructor, break early
-						break;
-					}
-				}
-				if (outsIter == otherTypeCast->outstructorList.end()) { // if we matched all outstructor types (we didn't break early), continue
-					// verify member downcastability
-					MemberList::iterator memberListIter;
-					for (memberListIter = otherTypeCast->memberList.begin(); memberListIter != otherTypeCast->memberList.end(); memberListIter++) {
-						MemberList::iterator memberListIter2;
-						for (memberListIter2 = memberList.begin(); memberListIter2 != memberList.end(); memberListIter2++) {
-							if ((*memberListIter2)->baseEquals(**memberListIter) && (*memberListIter2 == *memberListIter)) {
-								break;
-							}
-						}
-						if (memberListIter2 == memberList.end()) { // if we failed to find a match for this member, break early
-							break;
-						}
-					}
-					if (memberListIter == otherTypeCast->memberList.end()) { // if we matched all mambers (we didn't break early), return success
-						return true;
-					}
-				}
-			}
-			// try to connect the left object into an instructor on the right object
-			for (StructorList::iterator insIter = otherTypeCast->instructorList.begin(); insIter != otherTypeCast->instructorList.end(); insIter++) {
-				if (*this >> **insIter) {
-					return true;
-				}
-			}
-			// otherwise, try an outstructed downcastability from the left object to the right object
-			for (StructorList::iterator outsIter = outstructorList.begin(); outsIter != outstructorList.end(); outsIter++) {
-				if (**outsIter >> *otherTypeCast) { // if there is a type match, return true
-					return true;
-				}
-			}
-		}
-		// if we had no matches to any of the above cases, conclude that the objects are not downcastable and return false
-		return false;
+		return relate(otherType, RELATION_SENDABLE);
 	}
 	// otherType.category == CATEGORY_ERRORTYPE
 	return false;
@@ -1495,7 +1535,7 @@ bool ErrorType::operator==(Type &otherType) {
 	}
 }
 bool ErrorType::operator==(int kind) const {return false;}
-Type *ErrorType::operator,(Type &otherType) {return errType;}
+Type *ErrorType::operator,(Type &otherType) {return errType();}
 bool ErrorType::operator>>(Type &otherType) {return false;}
 string ErrorType::toString(unsigned int tabDepth) {
 	TYPE_TO_STRING_HEADER;
@@ -1506,12 +1546,97 @@ string ErrorType::toString(unsigned int tabDepth) {
 }
 ErrorType::operator string() {return toString(1);}
 
+// TypeRelationCache functions
+TypeRelationCache::TypeRelationCache() : capacity(TYPE_RELATION_CACHE_INITIAL_SIZE) {
+	slots = new unsigned int[capacity];
+	for (unsigned int i=0; i<capacity; i++) {
+		slots[i] = 0;
+	}
+}
+TypeRelationCache::~TypeRelationCache() {
+	delete[] slots;
+}
+unsigned int TypeRelationCache::shapeKey(const Type &type, const Type &otherType, int relation) {
+	// the relations depend on the suffixes and depths as well as the structures, so the key includes those too
+	return (((unsigned int)relation * NUM_SUFFIXES + type.suffix) * NUM_SUFFIXES + otherType.suffix);
+}
+unsigned int TypeRelationCache::hashKey(const Type &type, const Type &otherType, unsigned int shape) {
+	// FNV-1a over the key components
+	unsigned int hash = 2166136261u;
+	hash = (hash ^ type.id) * 16777619u;
+	hash = (hash ^ otherType.id) * 16777619u;
+	hash = (hash ^ shape) * 16777619u;
+	hash = (hash ^ (unsigned int)type.depth) * 16777619u;
+	hash = (hash ^ (unsigned int)otherType.depth) * 16777619u;
+	return hash;
+}
+const TypeRelationEntry *TypeRelationCache::find(const Type &type, const Type &otherType, int relation) const {
+	unsigned int shape = shapeKey(type, otherType, relation);
+	unsigned int hash = hashKey(type, otherType, shape);
+	for (unsigned int pos = hash & (capacity-1); slots[pos] != 0; pos = (pos+1) & (capacity-1)) {
+		const TypeRelationEntry &entry = entries[slots[pos]-1];
+		if (entry.hash == hash && entry.id == type.id && entry.otherId == otherType.id && entry.shape == shape &&
+				entry.depth == type.depth && entry.otherDepth == otherType.depth) {
+			return &entry;
+		}
+	}
+	return NULL;
+}
+void TypeRelationCache::grow() {
+	delete[] slots;
+	capacity *= 2;
+	slots = new unsigned int[capacity];
+	for (unsigned int i=0; i<capacity; i++) {
+		slots[i] = 0;
+	}
+	for (unsigned int i=0; i<entries.size(); i++) {
+		unsigned int pos = entries[i].hash & (capacity-1);
+		while (slots[pos] != 0) {
+			pos = (pos+1) & (capacity-1);
+		}
+		slots[pos] = i+1;
+	}
+}
+void TypeRelationCache::insert(const Type &type, const Type &otherType, int relation, bool result) {
+	if ((entries.size()+1)*2 > capacity) { // keep the load factor at or below one half
+		grow();
+	}
+	TypeRelationEntry entry;
+	entry.shape = shapeKey(type, otherType, relation);
+	entry.hash = hashKey(type, otherType, entry.shape);
+	entry.id = type.id;
+	entry.otherId = otherType.id;
+	entry.depth = type.depth;
+	entry.otherDepth = otherType.depth;
+	entry.result = result;
+	entries.push_back(entry);
+	unsigned int pos = entry.hash & (capacity-1);
+	while (slots[pos] != 0) {
+		pos = (pos+1) & (capacity-1);
+	}
+	slots[pos] = entries.size();
+}
+void TypeRelationCache::clear() {
+	if (entries.empty()) {
+		return;
+	}
+	for (unsigned int i=0; i<capacity; i++) {
+		slots[i] = 0;
+	}
+	entries.clear();
+}
+
+// drops the memoized type relations
+// note: the retyped standard operator types need no reset, since each compilation's context starts out with none of them
+void resetTypeCaches() {
+	compilerContext->typeRelationCache->clear();
+}
+
 // TypeStatus functions
 TypeStatus::TypeStatus(Type *type, Type *retType) : type(type), retType(retType), code(NULL) {}
 TypeStatus::TypeStatus(Type *type, const TypeStatus &otherStatus) : type(type), retType(otherStatus.retType), code(NULL) {}
-TypeStatus::~TypeStatus() {}
 TypeStatus::operator Type *() const {return type;}
-TypeStatus::operator uintptr_t() const {return (unsigned int)type;}
+TypeStatus::operator uintptr_t() const {return (uintptr_t)type;}
 DataTree *TypeStatus::castCode(const Type &destType) const {
 	StdType *thisType = (StdType *)type;
 	StdType *otherType = (StdType *)(&destType);
@@ -1551,7 +1676,7 @@ Type &TypeStatus::operator*() const {
 	if (type != NULL) {
 		return (*type);
 	} else {
-		return (*errType);
+		return (*errType());
 	}
 }
 Type *TypeStatus::operator->() const {return type;}
@@ -3,6 +3,7 @@
 
 #include "globalDefs.h"
 #include "constantDefs.h"
+#include "context.h"
 #include "driver.h"
 
 #include "../tmp/parserStruct.h"
@@ -22,6 +23,8 @@
 #define SUFFIX_ARRAY 4
 #define SUFFIX_POOL 5
 
+#define NUM_SUFFIXES 6
+
 // Type offset kinds
 #define OFFSET_NULL 0
 #define OFFSET_RAW 1
@@ -41,8 +44,8 @@ class Type {
 		Tree *offsetExp; // the offset expression for this type (if it's a SUFFIX_POOL); RAW_VECTOR, LSQUARE, NonArrayedIdentifier, ArrayedIdentifier, or CloneInstantiationSource
 		bool referensible; // whether a node of this type can be referenced on its own
 		bool instantiable; // whether a node of this type can be instantiated
-		bool toStringHandled; // used for recursion detection in operator string()
-		// mutators
+		unsigned int id; // serial number of this instance (copies get their own), which keys memoized comparisons
+		// mutators (these edit the type in place, so they're only ever applied to fresh copies, never to interned StdTypes)
 		void constantize(); // for when an identifier is present without an accessor or a sub-identifier's type is constrained by upstream identifiers
 		void latchize(); // for when we're instantiating a node with a single initializer
 		void poolize(Tree *offsetExp); // for when we're instantiating a node with a multi initializer
@@ -58,7 +61,10 @@ class Type {
 		Type *foldTypeList() const;
 		// allocators/deallocators
 		Type(int category, int suffix = SUFFIX_CONSTANT, int depth = 0, Tree *offsetExp = NULL);
+		Type(const Type &otherType);
 		virtual ~Type() = 0;
+		static void *operator new(size_t size); // Types belong to the compilation that allocated them (see allocNode())
+		static void operator delete(void *ptr);
 		// core methods
 		// virtual
 		virtual bool isComparable(const Type &otherType) const = 0;
@@ -66,7 +72,9 @@ class Type {
 		virtual void erase() = 0;
 		virtual void clear() = 0;
 		virtual string toString(unsigned int tabDepth = 1) = 0;
+		virtual bool computeRelation(Type &otherType, int relation); // the unmemoized comparison behind relate()
 		// non-virtual
+		bool relate(Type &otherType, int relation);
 		bool baseEquals(const Type &otherType) const;
 		bool baseSendable(const Type &otherType) const;
 		int offsetKind() const;
@@ -126,6 +134,23 @@ class Type {
 #define STD_PLUS 27
 #define STD_MINUS 28
 
+#define NUM_STD_KINDS 29
+
+// standard operator ObjectTypes that StdTypes can be promoted to (see StdType::objectTypePromotion())
+#define PROMOTION_STRINGER 0
+#define PROMOTION_BOOL_UN_OP 1
+#define PROMOTION_INT_UN_OP 2
+#define PROMOTION_BOOL_BIN_OP 3
+#define PROMOTION_INT_BIN_OP 4
+#define PROMOTION_FLOAT_BIN_OP 5
+#define PROMOTION_BOOL_COMP_OP 6
+#define PROMOTION_INT_COMP_OP 7
+#define PROMOTION_FLOAT_COMP_OP 8
+#define PROMOTION_CHAR_COMP_OP 9
+#define PROMOTION_STRING_COMP_OP 10
+
+#define NUM_PROMOTIONS 11
+
 class StdType : public Type {
 	public:
 		// data members
@@ -152,6 +177,10 @@ class StdType : public Type {
 		operator string();
 };
 
+// returns the canonical instance of a plain (offset-less) StdType; these are shared, so they must never be mutated in place (copy() them first)
+// note: only these StdTypes are interned -- lists, filters, objects, and mutated copies are still separate instances, compared structurally
+StdType *internStdType(int kind, int suffix = SUFFIX_CONSTANT, int depth = 0);
+
 class TypeList : public Type {
 	public:
 		// data members
@@ -183,8 +212,8 @@ class FilterType : public Type {
 		Tree *defSite; // the FilterHeader tree node that defines this FilterType
 		Type *inType; // the incoming type at the definition site
 		// allocators/deallocators
-		FilterType(Type *fromInternal = nullType, Type *toInternal = nullType, int suffix = SUFFIX_CONSTANT, int depth = 0, Tree *offsetExp = NULL);
-		FilterType(Tree *defSite, Type *inType = nullType, int suffix = SUFFIX_CONSTANT, int depth = 0, Tree *offsetExp = NULL);
+		FilterType(Type *fromInternal = nullType(), Type *toInternal = nullType(), int suffix = SUFFIX_CONSTANT, int depth = 0, Tree *offsetExp = NULL);
+		FilterType(Tree *defSite, Type *inType = nullType(), int suffix = SUFFIX_CONSTANT, int depth = 0, Tree *offsetExp = NULL);
 		~FilterType();
 		// core methods
 		TypeList *from();
@@ -194,6 +223,7 @@ class FilterType : public Type {
 		void erase();
 		void clear();
 		string toString(unsigned int tabDepth);
+		bool computeRelation(Type &otherType, int relation);
 		// operators
 		bool operator==(Type &otherType);
 		bool operator==(int kind) const;
@@ -257,9 +287,9 @@ class StructorList {
 class MemberListResult {
 	public:
 		// data members
-		const pair<string, pair<Type *, Tree *> > &internalPair;
+		const pair<const string, pair<Type *, Tree *> > &internalPair;
 		// allocators/deallocators
-		MemberListResult(const pair<string, pair<Type *, Tree *> > &internalPair);
+		MemberListResult(const pair<const string, pair<Type *, Tree *> > &internalPair);
 		~MemberListResult();
 		// converters
 		operator string() const;
@@ -325,6 +355,7 @@ class ObjectType : public Type {
 		void erase();
 		void clear();
 		string toString(unsigned int tabDepth);
+		bool computeRelation(Type &otherType, int relation);
 		// operators
 		bool operator==(Type &otherType);
 		bool operator==(int kind) const;
@@ -352,6 +383,56 @@ class ErrorType : public Type {
 		operator string();
 };
 
+// memoized Type relations (see Type::relate())
+#define RELATION_EQUALS 0
+#define RELATION_SENDABLE 1
+
+// a memoized comparison between two FilterTypes or two ObjectTypes
+class TypeRelationEntry {
+	public:
+		// data members
+		unsigned int hash;
+		unsigned int id; // the left type's id
+		unsigned int otherId; // the right type's id
+		unsigned int shape; // the relation, along with both types' suffixes
+		int depth; // the left type's depth
+		int otherDepth; // the right type's depth
+		bool result;
+};
+
+// structural comparison results keyed by (left type, right type, relation); a type's structure never changes once it can be compared, so entries never go stale
+class TypeRelationCache {
+	public:
+		// data members
+		vector<TypeRelationEntry> entries;
+		unsigned int *slots; // open-addressing hash index into entries (offset by one, so that 0 marks an empty slot)
+		unsigned int capacity; // the number of slots; always a power of two
+		// allocators/deallocators
+		TypeRelationCache();
+		~TypeRelationCache();
+		// core methods
+		const TypeRelationEntry *find(const Type &type, const Type &otherType, int relation) const;
+		void insert(const Type &type, const Type &otherType, int relation, bool result);
+		void clear();
+	private:
+		static unsigned int shapeKey(const Type &type, const Type &otherType, int relation);
+		static unsigned int hashKey(const Type &type, const Type &otherType, unsigned int shape);
+		void grow();
+};
+
+// chain of the comparisons that the current thread is in the middle of, used to cut off the recursion through recursive object types
+class TypeRelationFrame {
+	public:
+		// data members
+		Type *type;
+		Type *otherType;
+		int relation;
+		bool provisional; // whether the result depends on a comparison further up the chain that was assumed to hold
+		TypeRelationFrame *prev;
+};
+
+void resetTypeCaches();
+
 // typing status class
 
 class TypeStatus {
@@ -363,7 +444,6 @@ class TypeStatus {
 		// allocators/deallocators
 		TypeStatus(Type *type = NULL, Type *retType = NULL);
 		TypeStatus(Type *type, const TypeStatus &otherStatus);
-		~TypeStatus();
 		// converters
 		operator Type *() const;
 		operator uintptr_t() const;
@@ -379,9 +459,11 @@ class TypeStatus {
 		bool operator!=(Type &otherType);
 };
 
+inline TypeStatus defaultStatus() {return TypeStatus(nullType(), errType());} // the incoming status of a derivation that wasn't given one
+
 // external linkage specifiers
-extern Type *nullType;
-extern Type *errType;
+extern __thread TypeRelationCache *workerTypeRelationCache;
+extern __thread TypeRelationFrame *typeRelationFrames;
 
 // post-includes
 #include "parser.h"
@@ -389,22 +471,37 @@ extern Type *errType;
 
 // Type to string helper blocks
 
+// chain of the types that the current thread is in the middle of printing, used for recursion detection in operator string()
+// (kept per-thread rather than as a flag on the type, since the parallel semmer can print the same type from several threads at once)
+class TypeStringFrame {
+	public:
+		// data members
+		Type *type;
+		TypeStringFrame *prev;
+};
+extern __thread TypeStringFrame *typeStringFrames;
+
 #define TYPE_TO_STRING_HEADER \
 	/* if we have reached a recursive loop, return this fact */\
-	if (toStringHandled) {\
-		string acc(COLOREXP( SET_TERM(BRIGHT_CODE AND YELLOW_CODE) ));\
-		acc += "<RECURSION>";\
-		acc += COLOREXP( SET_TERM(RESET_CODE) );\
-		return acc;\
-	} else { /* otherwise, set the recursive printing flag */\
-		toStringHandled = true;\
+	for (TypeStringFrame *frame = typeStringFrames; frame != NULL; frame = frame->prev) {\
+		if (frame->type == this) {\
+			string acc(COLOREXP( SET_TERM(BRIGHT_CODE AND YELLOW_CODE) ));\
+			acc += "<RECURSION>";\
+			acc += COLOREXP( SET_TERM(RESET_CODE) );\
+			return acc;\
+		}\
 	}\
+	/* otherwise, push this type onto the recursive printing chain */\
+	TypeStringFrame typeStringFrame;\
+	typeStringFrame.type = this;\
+	typeStringFrame.prev = typeStringFrames;\
+	typeStringFrames = &typeStringFrame;\
 	/* prepare to compute the string normally */\
 	string acc
 
 #define TYPE_TO_STRING_FOOTER \
-	/* unset the recursive printing flag */\
-	toStringHandled = false;\
+	/* pop this type off of the recursive printing chain */\
+	typeStringFrames = typeStringFrame.prev;\
 	/* return the completed accumulator */\
 	return acc
 
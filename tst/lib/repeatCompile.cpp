@@ -0,0 +1,76 @@
+// repeatCompile -- compiles the same command line over and over through libanic, checking that every compilation comes out the same as the
+// first, and that the process stops growing once the allocator has warmed up (each compilation has to free everything that it allocated)
+
+#include "libanic.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using std::ostringstream;
+using std::string;
+using std::vector;
+
+// returns the resident set size of the process, in kilobytes
+long rssKb() {
+	long pages = 0;
+	long residentPages = 0;
+	FILE *statm = fopen("/proc/self/statm", "r");
+	if (statm != NULL) {
+		if (fscanf(statm, "%ld %ld", &pages, &residentPages) != 2) {
+			residentPages = 0;
+		}
+		fclose(statm);
+	}
+	return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+int main(int argc, char **argv) {
+	if (argc < 4) {
+		fprintf(stderr, "usage: repeatCompile iterations maxGrowthKb anicArgument...\n");
+		return 2;
+	}
+	int iterations = atoi(argv[1]);
+	long maxGrowthKb = atol(argv[2]);
+	int firstExitCode = 0;
+	string firstOut;
+	string firstErr;
+	long baseRssKb = 0;
+	for (int i=0; i<iterations; i++) {
+		// anicCompile() takes a mutable argument vector, so build one out of copies of the arguments
+		vector<string> args;
+		args.push_back("anic");
+		for (int j=3; j<argc; j++) {
+			args.push_back(argv[j]);
+		}
+		vector<char *> compileArgv;
+		for (unsigned int j=0; j<args.size(); j++) {
+			compileArgv.push_back(&(args[j][0]));
+		}
+		compileArgv.push_back(NULL);
+		ostringstream out;
+		ostringstream err;
+		int exitCode = anicCompile(args.size(), &(compileArgv[0]), out, err);
+		if (i == 0) {
+			firstExitCode = exitCode;
+			firstOut = out.str();
+			firstErr = err.str();
+		} else if (exitCode != firstExitCode || out.str() != firstOut || err.str() != firstErr) {
+			printf("compilation %d differs from the first one\n", i+1);
+			return 1;
+		}
+		if (i == iterations/4) { // measure the growth from here on, once the allocator's free lists have filled up
+			baseRssKb = rssKb();
+		}
+	}
+	long growthKb = rssKb() - baseRssKb;
+	if (growthKb > maxGrowthKb) {
+		printf("grew by %ldKB over the last %d compilations\n", growthKb, iterations - iterations/4 - 1);
+		return 1;
+	}
+	return 0;
+}